@@ -0,0 +1,36 @@
+# - Find MySQL
+# Find the MySQL (or MariaDB) includes and client library
+# This module defines
+#  MYSQL_INCLUDE_DIR, where to find mysql.h
+#  MYSQL_LIBRARIES, the libraries needed to use MySQL.
+#  MYSQL_FOUND, If false, do not try to use MySQL.
+#
+# Redistribution and use is allowed according to the terms of the BSD license.
+# For details see the accompanying COPYING-CMAKE-SCRIPTS file.
+
+
+if (MYSQL_INCLUDE_DIR AND MYSQL_LIBRARIES)
+  # Already in cache, be silent
+  set(MySQL_FIND_QUIETLY TRUE)
+endif (MYSQL_INCLUDE_DIR AND MYSQL_LIBRARIES)
+
+
+find_path(MYSQL_INCLUDE_DIR mysql.h
+   ${MYSQL_PATH_INCLUDES}/
+   /usr/include/mysql/
+   /usr/local/include/mysql/
+   /usr/include/mariadb/
+)
+
+find_library(MYSQL_LIBRARIES NAMES mysqlclient libmysql mariadb
+    PATHS
+        ${MYSQL_PATH_LIB}
+        /usr/lib/
+        /usr/lib/mysql/
+)
+
+include(ToraFindPackageHandleStandardArgs)
+find_package_handle_standard_args(MySQL DEFAULT_MSG
+                                  MYSQL_INCLUDE_DIR MYSQL_LIBRARIES )
+
+mark_as_advanced(MYSQL_INCLUDE_DIR MYSQL_LIBRARIES)
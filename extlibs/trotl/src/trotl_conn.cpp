@@ -82,6 +82,14 @@ void OciConnection::reset()
 	oci_check_error(__TROTL_HERE__, _env._errh, res);
 }
 
+void OciConnection::set_stmt_cache_size(ub4 size)
+{
+	sword res = OCICALL(OCIAttrSet(_svc_ctx, OCI_HTYPE_SVCCTX, &size, 0, OCI_ATTR_STMTCACHESIZE, _env._errh));
+	oci_check_error(__TROTL_HERE__, _env._errh, res);
+
+	_stmt_cache_size = size;
+}
+
 tstring OciConnection::getNLS_LANG()
 {
 	OraText infoBuf[OCI_NLS_MAXBUFSZ];
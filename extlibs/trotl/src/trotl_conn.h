@@ -363,6 +363,7 @@ struct TROTL_EXPORT OciConnection
 
 	OciConnection(OCIEnv* envh, OCISvcCtx* svc_ctx)
 		: _env(envh), _svc_ctx(svc_ctx)
+		, _stmt_cache_size(0), _stmt_cache_hits(0), _stmt_cache_misses(0)
 	{}
 
 	//OciConnection(OCIEnv* envh) :
@@ -426,7 +427,33 @@ struct TROTL_EXPORT OciConnection
 #endif
 	}
 
-	//StatementCache	_stmt_cache; TODO
+	/** Enable OCI client side statement cache for this connection (0 disables it).
+	 *  When enabled SqlStatement uses OCIStmtPrepare2/OCIStmtRelease and
+	 *  the statement handles (including parse and describe information)
+	 *  are reused for identical SQL texts.
+	 *  NOTE: the session should be started with OCI_STMT_CACHE mode
+	 */
+	void	set_stmt_cache_size(ub4 size);
+
+	ub4 stmt_cache_size() const
+	{
+		return _stmt_cache_size;
+	}
+
+	/// number of statements found in the statement cache
+	ub4 stmt_cache_hits() const
+	{
+		return _stmt_cache_hits;
+	}
+
+	/// number of statements not found in the statement cache
+	ub4 stmt_cache_misses() const
+	{
+		return _stmt_cache_misses;
+	}
+
+	ub4	_stmt_cache_size;
+	ub4	_stmt_cache_hits, _stmt_cache_misses;
 
 private:
 	OciConnection(const OciConnection&);	// disallow copy constructor calls
@@ -49,11 +49,15 @@ namespace trotl
 #if defined(TROTL_MAKE_DLL) || defined(__GNUC__)
 extern int TROTL_EXPORT g_OCIPL_BULK_ROWS;
 extern int TROTL_EXPORT g_OCIPL_MAX_LONG;
+extern int TROTL_EXPORT g_OCIPL_FETCH_BUFFER;
+extern int TROTL_EXPORT g_OCIPL_MAX_FETCH_ROWS;
 extern const char TROTL_EXPORT *g_TROTL_DEFAULT_NUM_FTM;
 extern const char TROTL_EXPORT *g_TROTL_DEFAULT_DATE_FTM;
 #else
 int TROTL_EXPORT g_OCIPL_BULK_ROWS;
 int TROTL_EXPORT g_OCIPL_MAX_LONG;
+int TROTL_EXPORT g_OCIPL_FETCH_BUFFER;
+int TROTL_EXPORT g_OCIPL_MAX_FETCH_ROWS;
 const char TROTL_EXPORT *g_TROTL_DEFAULT_NUM_FTM;
 const char TROTL_EXPORT *g_TROTL_DEFAULT_DATE_FTM;
 #endif
@@ -47,6 +47,7 @@
 #include <algorithm>
 #include <cctype>       // std::toupper
 #include <string>
+#include <chrono>
 //#include <assert.h>
 
 namespace trotl
@@ -55,11 +56,13 @@ namespace trotl
 
 int TROTL_EXPORT g_OCIPL_BULK_ROWS = 256;
 int TROTL_EXPORT g_OCIPL_MAX_LONG = 0x20000; //128 KB
+int TROTL_EXPORT g_OCIPL_FETCH_BUFFER = 0x400000; // 4 MB of define buffers per cursor
+int TROTL_EXPORT g_OCIPL_MAX_FETCH_ROWS = 8192;
 const char TROTL_EXPORT *g_TROTL_DEFAULT_NUM_FTM = "TM";
 const char TROTL_EXPORT *g_TROTL_DEFAULT_DATE_FTM = "YYYY:MM:DD HH24:MI:SS";
 
 SqlStatement::SqlStatement(OciConnection& conn, const tstring& stmt, ub4 lang, int bulk_rows)
-	: super(conn._env),
+	: super(conn._env, NULL), // handle is allocated (or taken from the statement cache) in prepare()
 //_svchp(conn._svc_ctx),
 	  _conn(conn),
 	  _lang(lang),
@@ -72,10 +75,11 @@ SqlStatement::SqlStatement(OciConnection& conn, const tstring& stmt, ub4 lang, i
 	  _last_row(-1),
 	  _last_fetched_row(-1),
 	  _in_pos(0), _out_pos(0), _iters(0),
-	  _last_buff_row(0), _buff_size(g_OCIPL_BULK_ROWS), _fetch_rows(g_OCIPL_BULK_ROWS),
+	  _last_buff_row(0), _buff_size(bulk_rows), _fetch_rows(bulk_rows),
 	  _all_binds(NULL), _all_defines(NULL),
 	  _in_binds(NULL), _out_binds(NULL),
-	  _bound(false)
+	  _bound(false),
+	  _cached(false)
 //	_res(NULL),
 //	_bulk_rows(bulk_rows),
 //	_result_buffers(0),
@@ -89,7 +93,9 @@ SqlStatement::SqlStatement(OciConnection& conn, const tstring& stmt, ub4 lang, i
 
 	_parsed_stmt= parser.getNonColored();
 
-	prepare(_parsed_stmt, lang);
+	try
+	{
+		prepare(_parsed_stmt, lang);
 
 // 	if(get_bindpar_count() != parser._bindvars.size())
 // 		throw_ocipl_exception(
@@ -97,63 +103,70 @@ SqlStatement::SqlStatement(OciConnection& conn, const tstring& stmt, ub4 lang, i
 // 					     ).arg(get_bindpar_count()).arg(parser._bindvars.size())
 // 		);
 
-	if(get_stmt_type() == STMT_SELECT)
-	{
-		execute_describe();
-	}
+		if(get_stmt_type() == STMT_SELECT)
+		{
+			execute_describe();
+		}
 
-	if(get_bindpar_count())
-	{
-		_all_binds = new std::unique_ptr<BindPar> [get_bindpar_count()+1];
-		_in_binds = new unsigned [get_bindpar_count()+1];
-		_out_binds = new unsigned [get_bindpar_count()+1];
-	}
+		if(get_bindpar_count())
+		{
+			_all_binds = new std::unique_ptr<BindPar> [get_bindpar_count()+1];
+			_in_binds = new unsigned [get_bindpar_count()+1];
+			_out_binds = new unsigned [get_bindpar_count()+1];
+		}
 
 
-	if( get_stmt_type() == STMT_SELECT ||
-	                get_stmt_type() == STMT_UPDATE ||
-	                get_stmt_type() == STMT_DELETE ||
-	                get_stmt_type() == STMT_INSERT ||
-	                get_stmt_type() == STMT_BEGIN  ||
-	                get_stmt_type() == STMT_DECLARE )
-	{
-		int ipos=1;
-		for(std::vector<BindVarDecl>::iterator it = parser._bindvars.begin(); it != parser._bindvars.end(); ++it, ++ipos)
+		if( get_stmt_type() == STMT_SELECT ||
+		                get_stmt_type() == STMT_UPDATE ||
+		                get_stmt_type() == STMT_DELETE ||
+		                get_stmt_type() == STMT_INSERT ||
+		                get_stmt_type() == STMT_BEGIN  ||
+		                get_stmt_type() == STMT_DECLARE )
 		{
-			if(it->inout == "in")
-			{
-				_in_binds[++_in_pos] = ipos;
-			}
-			else if(it->inout == "inout")
-			{
-				_in_binds[++_in_pos] = ipos;
-				_out_binds[++_out_pos] = ipos;
-			}
-			else if(it->inout == "out")
+			int ipos=1;
+			for(std::vector<BindVarDecl>::iterator it = parser._bindvars.begin(); it != parser._bindvars.end(); ++it, ++ipos)
 			{
-				_out_binds[++_out_pos] = ipos;
-			}
-			else
-			{
-				throw_oci_exception(OciException(__TROTL_HERE__, "Unsupported bindpar parameter: %s\n").arg(it->inout));
-			};
+				if(it->inout == "in")
+				{
+					_in_binds[++_in_pos] = ipos;
+				}
+				else if(it->inout == "inout")
+				{
+					_in_binds[++_in_pos] = ipos;
+					_out_binds[++_out_pos] = ipos;
+				}
+				else if(it->inout == "out")
+				{
+					_out_binds[++_out_pos] = ipos;
+				}
+				else
+				{
+					throw_oci_exception(OciException(__TROTL_HERE__, "Unsupported bindpar parameter: %s\n").arg(it->inout));
+				};
 
 
-			//Create BindPar instance, constructor takes two arguments (position, BindVarDecl&)
-			_all_binds[ipos] = BindParFactTwoParmSing::Instance().create(it->bindtype, ipos, *this, *it);
+				//Create BindPar instance, constructor takes two arguments (position, BindVarDecl&)
+				_all_binds[ipos] = BindParFactTwoParmSing::Instance().create(it->bindtype, ipos, *this, *it);
 
-			if ( _all_binds[ipos].get() == NULL )
-				throw_oci_exception(OciException(__TROTL_HERE__, "BindPar: Data type not registered: %s\n").arg(it->bindtype));
+				if ( _all_binds[ipos].get() == NULL )
+					throw_oci_exception(OciException(__TROTL_HERE__, "BindPar: Data type not registered: %s\n").arg(it->bindtype));
+			}
 		}
-	}
 
-	_in_cnt = _in_pos;
-	_in_pos=0;
-	_out_cnt = _out_pos;
-	_out_pos=0;
-	if(_in_binds) _in_binds[0]=0;
-	if(_out_binds) _out_binds[0]=0;
+		_in_cnt = _in_pos;
+		_in_pos=0;
+		_out_cnt = _out_pos;
+		_out_pos=0;
+		if(_in_binds) _in_binds[0]=0;
+		if(_out_binds) _out_binds[0]=0;
 //	if(_binds_all) _binds_all[0]=0;
+	}
+	catch(...)
+	{
+		// ~SqlStatement is not called, ~OciHandle would OCIHandleFree a cached handle
+		release(true);
+		throw;
+	}
 
 };
 
@@ -170,10 +183,11 @@ SqlStatement::SqlStatement(OciConnection& conn, OciHandle<OCIStmt>& handle, ub4
 	  _last_row(-1),
 	  _last_fetched_row(-1),
 	  _in_pos(0), _out_pos(0), _iters(0),
-	  _last_buff_row(0), _buff_size(g_OCIPL_BULK_ROWS), _fetch_rows(g_OCIPL_BULK_ROWS),
+	  _last_buff_row(0), _buff_size(bulk_rows), _fetch_rows(bulk_rows),
 	  _all_binds(NULL), _all_defines(NULL),
 	  _in_binds(NULL), _out_binds(NULL),
-	  _bound(false)
+	  _bound(false),
+	  _cached(false)
 //	_res(NULL),
 //	_bulk_rows(bulk_rows),
 //	_result_buffers(0),
@@ -187,8 +201,30 @@ void SqlStatement::prepare(const tstring& sql, ub4 lang)
 	ub4 size = sizeof(stmt_type);
 	sword res;
 
-	res = OCICALL(OCIStmtPrepare(_handle/*stmtp*/, _errh, (text*)sql.c_str(), (ub4)sql.length(), lang, OCI_DEFAULT));
-	check_error(__TROTL_HERE__, res);
+	if (_handle == NULL && _conn.stmt_cache_size() > 0)
+	{
+		// Look into the statement cache 1st, just to count hits and misses
+		res = OCICALL(OCIStmtPrepare2(_conn._svc_ctx, &_handle, _errh, (text*)sql.c_str(), (ub4)sql.length(), NULL, 0, lang, OCI_PREP2_CACHE_SEARCHONLY));
+		if (res == OCI_SUCCESS || res == OCI_SUCCESS_WITH_INFO)
+		{
+			++_conn._stmt_cache_hits;
+		}
+		else
+		{
+			++_conn._stmt_cache_misses;
+			_handle = NULL;
+			res = OCICALL(OCIStmtPrepare2(_conn._svc_ctx, &_handle, _errh, (text*)sql.c_str(), (ub4)sql.length(), NULL, 0, lang, OCI_DEFAULT));
+			check_error(__TROTL_HERE__, res);
+		}
+		_cached = true;
+	}
+	else
+	{
+		if (_handle == NULL)
+			alloc();
+		res = OCICALL(OCIStmtPrepare(_handle/*stmtp*/, _errh, (text*)sql.c_str(), (ub4)sql.length(), lang, OCI_DEFAULT));
+		check_error(__TROTL_HERE__, res);
+	}
 
 	/* NOTE this call alse returns other values than mentioned in OCI docs.
 	 * for example "EXPLAIN PLAN FOR ..." returns value 15
@@ -238,15 +274,67 @@ void SqlStatement::execute_describe()
 	_state |= DESCRIBED;
 }
 
+/* Estimate size of one row of a define buffer, see BindPar subclasses for exact sizes.
+ * Datatypes which need a descriptor (or callback) per row also limit the amount of rows.
+ */
+static ub4 define_row_size(const DescribeColumn &dc, ub4 &max_rows)
+{
+	ub4 size = sizeof(OCIInd) + sizeof(ub2) + sizeof(ub4); // indp, rlenp, alenp
+	switch(dc._data_type)
+	{
+	case SQLT_CHR:
+	case SQLT_AFC:
+	case SQLT_STR:
+		return size + (dc._data_size + 1) * 4;
+	case SQLT_BIN:
+		return size + dc._data_size + 1;
+	case SQLT_NUM:
+	case SQLT_VNU:
+		return size + OCI_NUMBER_SIZE;
+	case SQLT_DAT:
+	case SQLT_ODT:
+		return size + sizeof(OCIDate);
+	case SQLT_INTERVAL_DS:
+	case SQLT_INTERVAL_YM:
+		return size + 128;
+	case SQLT_LNG:
+	case SQLT_LBI:
+		// piecewise fetch, see define_all()
+		max_rows = 1;
+		return size + 8192;
+	case SQLT_RDD:
+		max_rows = min(max_rows, (ub4)2);
+		return size + sizeof(void*);
+	default:
+		// LOB locators, timestamps, cursors, objects, ...
+		max_rows = min(max_rows, (ub4)g_OCIPL_BULK_ROWS);
+		return size + sizeof(void*);
+	}
+}
+
 void SqlStatement::define_all()
 {
 	_columns.resize(get_column_count()+1);	// we do not use zero-th position
 	_all_defines= new std::unique_ptr<BindPar> [get_column_count()+1];
 
+	// Size define buffers so that they fit into g_OCIPL_FETCH_BUFFER
+	ub4 row_size = 0, max_rows = (ub4)g_OCIPL_MAX_FETCH_ROWS;
 	for(unsigned dpos = 1; dpos <= get_column_count(); ++dpos)
 	{
 		DescribeColumn *dc = new DescribeColumn(_conn, *this, dpos, "");
 		_columns[dpos] = dc;
+		row_size += define_row_size(*dc, max_rows);
+	}
+	_buff_size = row_size ? (ub4)g_OCIPL_FETCH_BUFFER / row_size : max_rows;
+	_buff_size = min(_buff_size, max_rows);
+	if (_buff_size == 0)
+		_buff_size = 1;
+	// Start with the statement's bulk size, fetch() grows it for quick round trips
+	_fetch_rows = min(_buff_size, _fetch_rows);
+
+	for(unsigned dpos = 1; dpos <= get_column_count(); ++dpos)
+	{
+		DescribeColumn *dc = _columns[dpos];
 
 		// Use column datatype for lookup in a hash table
 		// and call appropriate create function from the factory
@@ -277,12 +365,12 @@ void SqlStatement::define_all()
 
 		// When using piecewise callbacks fetch rows one by one
 		if(_all_defines[dpos]->dty == SQLT_LNG)
-			_fetch_rows = 1;
+			_fetch_rows = _buff_size = 1;
 		// Due to some ugly SEGFAULT in OCIRowidToChar I can not fetch more than 2 rows 
 		// when datatype (U)ROWID is explicitly listed in queries column list
 		// and when ROWID equals to this 'AAADVKAABAAAHypAA3' surprisingly some other ROWIDs are fine
 		if(_all_defines[dpos]->dty == SQLT_RDD)
-			_fetch_rows = min(_fetch_rows, (ub4)2);
+			_fetch_rows = _buff_size = min(_buff_size, (ub4)2);
 	}
 	_state |= DEFINED;
 }
@@ -419,7 +507,8 @@ bool SqlStatement::execute_internal(ub4 rows, ub4 mode)
 		{
 			set_attribute(OCI_ATTR_PREFETCH_MEMORY, 1500);
 			//set_attribute(OCI_ATTR_PREFETCH_ROWS, 10);
-			set_attribute(OCI_ATTR_PREFETCH_ROWS, g_OCIPL_BULK_ROWS);
+			// prefetch as many rows as the next array fetch asks for (tuned when re-executed)
+			set_attribute(OCI_ATTR_PREFETCH_ROWS, _fetch_rows);
 		}
 		catch(std::exception&)
 		{
@@ -546,6 +635,7 @@ bool SqlStatement::execute_internal(ub4 rows, ub4 mode)
 
 void SqlStatement::fetch(ub4 rows/*=-1*/)
 {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 	sword res = OCICALL(OCIStmtFetch(_handle, _errh, rows, OCI_FETCH_NEXT, OCI_DEFAULT));
 
 	while (res == OCI_NEED_DATA)
@@ -622,6 +712,24 @@ void SqlStatement::fetch(ub4 rows/*=-1*/)
 	_last_buff_row = 0;
 	if ( _last_fetched_row == 0) // nothing was fetched
 		_state |= EOF_QUERY | EOF_DATA;
+
+	if (rows == _fetch_rows && (_state & EOF_DATA) == 0)
+		tune_fetch_rows(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/* Adjust array fetch size (up to _buff_size) from the last full round trip.
+ * Quick round trips are dominated by network latency, so fetch more rows at once.
+ * Slow ones delay rows the user is waiting for, so fetch less.
+ */
+void SqlStatement::tune_fetch_rows(long long msecs)
+{
+	static const long long FAST_MSECS = 50, SLOW_MSECS = 500;
+	static const ub4 MIN_ROWS = 16;
+
+	if (msecs < FAST_MSECS && _fetch_rows < _buff_size)
+		_fetch_rows = min(_fetch_rows * 2, _buff_size);
+	else if (msecs > SLOW_MSECS && _fetch_rows > MIN_ROWS)
+		_fetch_rows = _fetch_rows / 2 > MIN_ROWS ? _fetch_rows / 2 : MIN_ROWS;
 }
 
 ub4 SqlStatement::row_count() const
@@ -740,8 +848,20 @@ SqlStatement::~SqlStatement()
 		delete [] _out_binds;
 	}
 	_state |= 0xff;
+	release(false);
 };
 
+void SqlStatement::release(bool drop)
+{
+	if (!_cached || _handle == NULL)
+		return;
+	// Statement handle goes back into the cache, ~OciHandle must not free it.
+	// Called from destructor, errors are ignored
+	OCICALL(OCIStmtRelease(_handle, _errh, NULL, 0, drop ? OCI_STRLS_CACHE_DELETE : OCI_DEFAULT));
+	_handle = NULL;
+	_cached = false;
+}
+
 template<>
 SqlStatement& SqlStatement::operator<< <int>(const int &val)
 {
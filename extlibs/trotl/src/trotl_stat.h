@@ -96,6 +96,12 @@ public:
 	ub4 row_count() const;
 	ub4 fetched_rows() const;
 
+	/// Size of define buffers (in rows), computed from column widths in define_all()
+	ub4 get_buffer_rows() const
+	{
+		return _buff_size;
+	}
+
 	inline STMT_TYPE get_stmt_type() const
 	{
 		return _stmt_type;
@@ -298,10 +304,13 @@ public:
 protected:
 
 	virtual void prepare(const tstring& sql, ub4 lang=OCI_NTV_SYNTAX);
+	/// return statement handle obtained by OCIStmtPrepare2 into the statement cache (drop - remove it from the cache)
+	void release(bool drop);
 
 	void execute_describe();
 
 	void fetch(ub4 rows=-1);
+	void tune_fetch_rows(long long msecs);
 
 	/* OCIBindByPos - for PL/SQL statements */
 	void bind(BindPar &bp);
@@ -364,6 +373,7 @@ public:	//todo delete me - these fields should not be public
 	std::unique_ptr<BindPar> *_all_defines;
 	ub4 *_in_binds, *_out_binds;
 	bool _bound;
+	bool _cached; // _handle comes from the OCI statement cache
 };
 
 /*
@@ -421,8 +421,8 @@ BindPar::BindPar(unsigned int pos, SqlStatement &stmt, DescribeColumn *ct)
 	, _env(stmt._env)
 	, _stmt(stmt)
 	, _pos(pos)
-	, _max_cnt(g_OCIPL_BULK_ROWS)
-	, _cnt(g_OCIPL_BULK_ROWS)
+	, _max_cnt(stmt.get_buffer_rows())
+	, _cnt(stmt.get_buffer_rows())
 	, _bound(false)
 	, _type_name("")
 	, _reg_name("")
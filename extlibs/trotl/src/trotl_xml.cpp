@@ -86,7 +86,7 @@ void BindParXML::init(SqlStatement &stmt)
 	if(xmltdo == NULL)
 		throw OciException(__TROTL_HERE__, "Unknown datatype in the database: SYS.XMLTYPE");
 
-	for(int i=0; i<g_OCIPL_BULK_ROWS; i++)
+	for(unsigned i=0; i<_cnt; i++)
 	{
 		_xmlvaluep[i] = NULL;
 		_xmlindp[i] = OCI_IND_NULL;
@@ -0,0 +1,95 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toconnection.h"
+#include "core/toconnectionsub.h"
+
+#include <QtCore/QAtomicInt>
+
+class toBenchConnectionImpl: public toConnection::connectionImpl
+{
+        friend class toBenchProvider;
+    protected:
+        toBenchConnectionImpl(toConnection &conn) : toConnection::connectionImpl(conn) {};
+    public:
+        /** Create a new connection to the database. */
+        toConnectionSub *createConnection(void) override;
+
+        /** Close a connection to the database. */
+        void closeConnection(toConnectionSub *) override;
+};
+
+/** Synthetic session, there is no server behind it. The only state it keeps
+ * is the cancel flag polled by the running @ref benchQuery.
+ */
+class toBenchConnectionSub: public toConnectionSub
+{
+    public:
+        toBenchConnectionSub();
+
+        /** Cancel is asynchronous, the running query notices it at its next round trip */
+        void cancel() override
+        {
+            Cancelled.storeRelease(1);
+        }
+
+        void close() override {};
+        void commit() override {};
+        void rollback() override {};
+
+        bool hasTransaction() override
+        {
+            return false;
+        }
+
+        QString version() override
+        {
+            return "0100";
+        }
+
+        toQueryParams sessionId() override;
+
+        queryImpl* createQuery(toQueryAbstr *query) override;
+
+        toQAdditionalDescriptions* decribe(toCache::ObjectRef const&) override
+        {
+            throw QString("Not implemented yet: toBenchConnectionSub::describe");
+        }
+
+        QAtomicInt Cancelled;
+    private:
+        int SessionID;
+};
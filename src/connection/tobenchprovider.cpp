@@ -0,0 +1,87 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/tobenchprovider.h"
+#include "connection/tobenchconnection.h"
+
+QString toBenchProvider::m_name = BENCH_PROVIDER;
+
+toBenchProvider::toBenchProvider(toConnectionProviderFinder::ConnectionProvirerParams const& p)
+    : toConnectionProvider(p)
+{}
+
+bool toBenchProvider::initialize()
+{
+    return true;
+}
+
+QList<QString> toBenchProvider::hosts() const
+{
+    return QList<QString>() << "localhost";
+}
+
+QMap<QString,QString> toBenchProvider::defaultConnection() const
+{
+    QMap<QString,QString> retval;
+    retval.insert("HOST", "localhost");
+    retval.insert("DB", "bench");
+    retval.insert("USER", "bench");
+    return retval;
+}
+
+QList<QString> toBenchProvider::databases(const QString &host, const QString &user, const QString &pwd) const
+{
+    return QList<QString>() << "bench";
+}
+
+QList<QString> toBenchProvider::options() const
+{
+    return QList<QString>();
+}
+
+QWidget* toBenchProvider::configurationTab(QWidget *parent)
+{
+    return NULL;
+}
+
+toConnection::connectionImpl* toBenchProvider::createConnectionImpl(toConnection &conn)
+{
+    return new toBenchConnectionImpl(conn);
+}
+
+toConnectionTraits* toBenchProvider::createConnectionTrait(void)
+{
+    static toBenchTraits *t = new toBenchTraits();
+    return t;
+}
@@ -0,0 +1,343 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/tobenchquery.h"
+#include "connection/tobenchconnection.h"
+#include "core/tocache.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+
+namespace
+{
+    // splitmix64, cheap and good enough to make every cell independent of the fetch order
+    inline quint64 mix(quint64 x)
+    {
+        x += Q_UINT64_C(0x9E3779B97F4A7C15);
+        x = (x ^ (x >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+        x = (x ^ (x >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+        return x ^ (x >> 31);
+    }
+
+    const char Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 _";
+
+    QString text(quint64 h, int len)
+    {
+        QString ret(len, Qt::Uninitialized);
+        QChar *c = ret.data();
+        for (int i = 0; i < len; i++)
+        {
+            if (i % 10 == 0)
+                h = mix(h);
+            c[i] = QLatin1Char(Alphabet[(h >> (6 * (i % 10))) & 63]);
+        }
+        return ret;
+    }
+
+    QByteArray binary(quint64 h, int len)
+    {
+        QByteArray ret(len, Qt::Uninitialized);
+        for (int i = 0; i < len; i++)
+        {
+            if (i % 8 == 0)
+                h = mix(h);
+            ret[i] = char(h >> (8 * (i % 8)));
+        }
+        return ret;
+    }
+
+    // 2000-01-01 .. 2019-12-31
+    const qint64 DateRange = Q_INT64_C(20) * 365 * 24 * 3600;
+}
+
+toBenchSpec::toBenchSpec()
+    : Valid(false)
+    , Rows(1000)
+    , Nulls(0.0)
+    , Latency(0)
+    , Execute(0)
+    , Batch(100)
+    , Seed(1)
+{}
+
+toBenchSpec toBenchSpec::parse(QString const& sql)
+{
+    static const QRegularExpression specExp("/\\*\\s*bench\\b(.*?)\\*/",
+                                            QRegularExpression::CaseInsensitiveOption | QRegularExpression::DotMatchesEverythingOption);
+    static const QRegularExpression typeExp("^\\s*(\\w+)\\s*(?:\\(\\s*(\\d+)\\s*\\))?\\s*$");
+
+    toBenchSpec ret;
+    QRegularExpressionMatch spec = specExp.match(sql);
+    if (!spec.hasMatch())
+        return ret;
+
+    ret.Valid = true;
+    bool execSet = false;
+    QString cols("int,varchar(30),number,date");
+    Q_FOREACH(QString const& option, spec.captured(1).split(QRegularExpression("\\s+"), QString::SkipEmptyParts))
+    {
+        QString key = option.section('=', 0, 0).toLower();
+        QString val = option.section('=', 1);
+        bool ok = true;
+        if (key == "rows")
+            ret.Rows = val.toULongLong(&ok);
+        else if (key == "cols")
+            cols = val;
+        else if (key == "nulls")
+            ret.Nulls = qBound(0.0, val.toDouble(&ok), 1.0);
+        else if (key == "latency")
+            ret.Latency = val.toUInt(&ok);
+        else if (key == "exec")
+        {
+            ret.Execute = val.toUInt(&ok);
+            execSet = true;
+        }
+        else if (key == "batch")
+            ret.Batch = qMax(1u, val.toUInt(&ok));
+        else if (key == "seed")
+            ret.Seed = val.toULongLong(&ok);
+        else
+            throw QString("Bench: unknown option '%1'").arg(option);
+        if (!ok)
+            throw QString("Bench: invalid value '%1'").arg(option);
+    }
+    if (!execSet)
+        ret.Execute = ret.Latency;
+
+    Q_FOREACH(QString const& col, cols.split(',', QString::SkipEmptyParts))
+    {
+        QRegularExpressionMatch m = typeExp.match(col);
+        if (!m.hasMatch())
+            throw QString("Bench: invalid column '%1'").arg(col);
+        QString type = m.captured(1).toLower();
+        Column c;
+        c.Width = m.captured(2).toInt();
+        if (type == "int" || type == "integer")
+            c.Type = INTEGER;
+        else if (type == "number")
+            c.Type = NUMBER;
+        else if (type == "varchar" || type == "varchar2")
+            c.Type = VARCHAR;
+        else if (type == "char")
+            c.Type = CHAR;
+        else if (type == "date")
+            c.Type = DATE;
+        else if (type == "clob")
+            c.Type = CLOB;
+        else if (type == "blob")
+            c.Type = BLOB;
+        else
+            throw QString("Bench: unknown column type '%1'").arg(col);
+        if (c.Width == 0)
+        {
+            static const int defaultWidth[] = { 0, 0, 30, 1, 0, 4000, 4096 };
+            c.Width = defaultWidth[c.Type];
+        }
+        ret.Columns.append(c);
+    }
+    return ret;
+}
+
+benchQuery::benchQuery(toQueryAbstr *query, toBenchConnectionSub *conn)
+    : queryImpl(query)
+    , Connection(conn)
+    , Executed(false)
+    , Row(0)
+    , Fetched(0)
+    , Column(0)
+    , Fetches(0)
+{}
+
+void benchQuery::execute(void)
+{
+    Spec = toBenchSpec::parse(query()->sql());
+    if (!Spec.Valid)
+        Spec.Rows = 0;
+    Connection->Cancelled.storeRelease(0);
+    Row = Fetched = 0;
+    Column = 0;
+    Fetches = 0;
+    wait(Spec.Execute);
+    Executed = true;
+}
+
+void benchQuery::execute(QString const&)
+{
+    // session init statements, nothing to do
+}
+
+void benchQuery::cancel(void)
+{
+    Connection->cancel();
+}
+
+toQValue benchQuery::readValue(void)
+{
+    if (!Executed)
+        throw QString::fromLatin1("Fetching from unexecuted query");
+    if (eof())
+        throw QString::fromLatin1("Tried to read past end of query");
+
+    toQValue ret = value(Row, Column);
+    if (++Column == Spec.Columns.size())
+    {
+        Column = 0;
+        Row++;
+    }
+    return ret;
+}
+
+bool benchQuery::eof(void)
+{
+    if (Row >= Spec.Rows)
+        return true;
+    if (Row == Fetched)
+    {
+        wait(Spec.Latency);
+        Fetched = qMin(Spec.Rows, Fetched + Spec.Batch);
+        Fetches++;
+    }
+    return false;
+}
+
+unsigned long benchQuery::rowsProcessed(void)
+{
+    if (!Executed)
+        return 0;
+    return Spec.Valid ? Row : 1;
+}
+
+unsigned benchQuery::columns(void)
+{
+    return Spec.Columns.size();
+}
+
+toQColumnDescriptionList benchQuery::describe(void)
+{
+    toQColumnDescriptionList ret;
+    for (int i = 0; i < Spec.Columns.size(); i++)
+    {
+        toBenchSpec::Column const& c = Spec.Columns.at(i);
+        toCache::ColumnDescription desc;
+        desc.Null = Spec.Nulls > 0;
+        desc.AlignRight = false;
+        switch (c.Type)
+        {
+            case toBenchSpec::INTEGER:
+                desc.Name = "INT";
+                desc.Datatype = "NUMBER";
+                desc.AlignRight = true;
+                break;
+            case toBenchSpec::NUMBER:
+                desc.Name = "NUMBER";
+                desc.Datatype = "NUMBER";
+                desc.AlignRight = true;
+                break;
+            case toBenchSpec::VARCHAR:
+                desc.Name = "VARCHAR";
+                desc.Datatype = QString("VARCHAR2(%1)").arg(c.Width);
+                break;
+            case toBenchSpec::CHAR:
+                desc.Name = "CHAR";
+                desc.Datatype = QString("CHAR(%1)").arg(c.Width);
+                break;
+            case toBenchSpec::DATE:
+                desc.Name = "DATE";
+                desc.Datatype = "DATE";
+                break;
+            case toBenchSpec::CLOB:
+                desc.Name = "CLOB";
+                desc.Datatype = "CLOB";
+                break;
+            case toBenchSpec::BLOB:
+                desc.Name = "BLOB";
+                desc.Datatype = "BLOB";
+                break;
+        }
+        desc.Name += QString("_%1").arg(i + 1);
+        ret.append(desc);
+    }
+    return ret;
+}
+
+unsigned long benchQuery::fetchCount(void)
+{
+    return Fetches;
+}
+
+void benchQuery::wait(unsigned ms)
+{
+    QElapsedTimer timer;
+    timer.start();
+    forever
+    {
+        if (Connection->Cancelled.loadAcquire())
+            throw QString::fromLatin1("Bench: query cancelled");
+        qint64 left = qint64(ms) - timer.elapsed();
+        if (left <= 0)
+            break;
+        // short slices so that cancel is noticed quickly
+        QThread::msleep(qMin<qint64>(left, 10));
+    }
+}
+
+toQValue benchQuery::value(quint64 row, int col) const
+{
+    quint64 h = mix(Spec.Seed ^ mix(row * Spec.Columns.size() + col));
+    toBenchSpec::Column const& c = Spec.Columns.at(col);
+
+    if (Spec.Nulls > 0 && double(h >> 11) / double(Q_UINT64_C(1) << 53) < Spec.Nulls)
+        return toQValue();
+    h = mix(h);
+
+    switch (c.Type)
+    {
+        case toBenchSpec::INTEGER:
+            return toQValue(qlonglong(h % 1000000000));
+        case toBenchSpec::NUMBER:
+            return toQValue(double(h % 100000000) / 100.0);
+        case toBenchSpec::VARCHAR:
+            return toQValue(text(h, 1 + h % c.Width));
+        case toBenchSpec::CHAR:
+        case toBenchSpec::CLOB:
+            return toQValue(text(h, c.Width));
+        case toBenchSpec::DATE:
+            return toQValue::fromVariant(QDateTime(QDate(2000, 1, 1)).addSecs(h % DateRange));
+        case toBenchSpec::BLOB:
+            return toQValue::createBinary(binary(h, c.Width));
+    }
+    return toQValue();
+}
@@ -0,0 +1,127 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toquery.h"
+#include "core/toqueryimpl.h"
+
+#include <QtCore/QVector>
+
+class toBenchConnectionSub;
+
+/** Shape of a synthetic result set. It is read from a comment embedded in the SQL text:
+ *
+ *  select * from t /\*bench rows=100000 cols=int,number,varchar(40),date,clob(4000) nulls=0.1 latency=5 batch=500 *\/
+ *
+ *  rows    - number of rows (default 1000)
+ *  cols    - comma separated column types: int, number, varchar(n), char(n), date, clob(n), blob(n)
+ *  nulls   - ratio of NULL values, 0.0 - 1.0 (default 0)
+ *  latency - simulated round trip time in ms, spent once per fetched batch (default 0)
+ *  exec    - simulated execute time in ms (default: latency)
+ *  batch   - rows per round trip (default 100)
+ *  seed    - seed of the generator, same seed gives the same data (default 1)
+ *
+ *  SQL without a bench comment is accepted as DML: no result set, one row processed.
+ */
+struct toBenchSpec
+{
+    enum ColumnType
+    {
+        INTEGER,
+        NUMBER,
+        VARCHAR,
+        CHAR,
+        DATE,
+        CLOB,
+        BLOB
+    };
+
+    struct Column
+    {
+        ColumnType Type;
+        int Width;
+    };
+
+    toBenchSpec();
+
+    /** Parse spec from SQL text, throws QString on malformed spec */
+    static toBenchSpec parse(QString const& sql);
+
+    bool Valid;
+    quint64 Rows;
+    QVector<Column> Columns;
+    double Nulls;
+    unsigned Latency;
+    unsigned Execute;
+    unsigned Batch;
+    quint64 Seed;
+};
+
+class benchQuery : public queryImpl
+{
+    public:
+        benchQuery(toQueryAbstr *query, toBenchConnectionSub *conn);
+
+        void execute(void) override;
+
+        void execute(QString const&) override;
+
+        void cancel(void) override;
+
+        toQValue readValue(void) override;
+
+        bool eof(void) override;
+
+        unsigned long rowsProcessed(void) override;
+
+        unsigned columns(void) override;
+
+        toQColumnDescriptionList describe(void) override;
+
+        unsigned long fetchCount(void) override;
+    private:
+        /** Sleep for simulated server time, throws when the session was cancelled meanwhile */
+        void wait(unsigned ms);
+
+        /** Value of the cell, depends only on seed, row and column */
+        toQValue value(quint64 row, int col) const;
+
+        toBenchSpec Spec;
+        toBenchConnectionSub *Connection;
+        bool Executed;
+        quint64 Row, Fetched;
+        int Column;
+        unsigned long Fetches;
+};
@@ -75,6 +75,8 @@ QVariant ToConfiguration::Oracle::defaultValue(int option) const
             return QVariant((bool)false);
         case XPlanFormat:
             return QVariant(QString("BASIC"));
+        case StatementCacheSizeInt:
+            return QVariant((int)32);
         default:
             Q_ASSERT_X( false, qPrintable(__QHERE__), qPrintable(QString("Context Oracle un-registered enum value: %1").arg(option)));
             return QVariant();
@@ -67,6 +67,7 @@ namespace ToConfiguration
                 , RefConstraintsBool
                 , ConstraintsAsAlterBool
                 , XPlanFormat
+                , StatementCacheSizeInt    // OCI client side statement cache size, 0 = disabled
             };
             virtual QVariant defaultValue(int option) const;
             static QString planTable(QString const& schema);
@@ -84,6 +84,7 @@ toConnectionSub* toOracleConnectionImpl::createConnection(void)
     QString oldSid;
 
     QSet<QString> options = parentConnection().options();
+    int stmtCacheSize = toConfigurationNewSingle::Instance().option(ToConfiguration::Oracle::StatementCacheSizeInt).toInt();
 
     bool sqlNet = (options.find("SQL*Net") != options.end());
     if (!sqlNet)
@@ -102,6 +103,8 @@ toConnectionSub* toOracleConnectionImpl::createConnection(void)
         else if (options.find("SYS_ASM") != options.end())
             session_mode = OCI_SYSASM;
 #endif
+        if (stmtCacheSize > 0)
+            session_mode |= OCI_STMT_CACHE;
 
         do
         {
@@ -211,6 +214,18 @@ toConnectionSub* toOracleConnectionImpl::createConnection(void)
         }
     }
 
+    if (stmtCacheSize > 0)
+    {
+        try
+        {
+            conn->set_stmt_cache_size(stmtCacheSize);
+        }
+        catch (::trotl::OciException const& e)
+        {
+            TLOG(5, toDecorator, __HERE__) << "Failed to set statement cache size for session:\n" << e.what();
+        }
+    }
+
     try
     {
         QString alterSessionSQL = QString::fromLatin1("ALTER SESSION SET NLS_DATE_FORMAT = '");
@@ -292,6 +307,8 @@ toOracleConnectionSub::toOracleConnectionSub(::trotl::OciConnection *conn, ::tro
 toOracleConnectionSub::~toOracleConnectionSub()
 {
     delete _hasTransactionStat;
+    TLOG(5, toDecorator, __HERE__) << "Statement cache hits: " << _conn->stmt_cache_hits()
+                                   << " misses: " << _conn->stmt_cache_misses() << std::endl;
 }
 
 void toOracleConnectionSub::cancel()
@@ -0,0 +1,267 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include <cstdlib>
+#include <climits>
+
+/** Decoder for the Oracle NUMBER wire format (OCINumber, SQLT_VNU).
+ *
+ *  An OCINumber is a length byte followed by up to 21 bytes: an exponent
+ *  byte and up to 20 base-100 mantissa digits. Positive numbers store the
+ *  exponent as 0xC0 + exp and each digit as digit + 1, negative numbers
+ *  store the complemented exponent, each digit as 101 - digit and
+ *  (when shorter than 20 digits) a terminating byte 102.
+ *
+ *  Decoding in plain C++ avoids two or three OCI calls per cell
+ *  (OCINumberIsInt + OCINumberToInt/OCINumberToReal). Values which cannot be
+ *  represented exactly as qint64/double the same way OCI would do it
+ *  (integers outside of the 64bit range, +/-infinity, malformed input)
+ *  are reported as toOracleNumber::Oci and must be converted by OCI.
+ */
+namespace toOracleNumber
+{
+    enum Kind
+    {
+        Null = 0,
+        Int,
+        Real,
+        Oci
+    };
+
+    struct Value
+    {
+        Kind kind;
+        union
+        {
+            long long i;
+            double d;
+        };
+    };
+
+    /** Decode a single OCINumber starting with its length byte */
+    inline void decode(const unsigned char *num, Value &out)
+    {
+        static const double pow10[] =
+        {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        unsigned len = num[0];
+        if (len == 0 || len > 21)
+        {
+            out.kind = Oci;
+            return;
+        }
+
+        unsigned char const e = num[1];
+        unsigned char const *m = num + 2;
+        int count = (int) len - 1;
+        bool const negative = (e & 0x80) == 0;
+
+        if (len == 1 && e == 0x80) // zero
+        {
+            out.kind = Int;
+            out.i = 0;
+            return;
+        }
+
+        if (negative)
+        {
+            if (len == 1 && e == 0x00) // -infinity
+            {
+                out.kind = Oci;
+                return;
+            }
+            if (count > 0 && m[count - 1] == 102) // terminator
+                --count;
+        }
+        else if (e == 0xFF && len == 2 && m[0] == 101) // +infinity
+        {
+            out.kind = Oci;
+            return;
+        }
+
+        if (count == 0)
+        {
+            out.kind = Oci;
+            return;
+        }
+
+        // base-100 exponent of the first mantissa digit
+        int const exponent = ((negative ? (unsigned char) ~e : e) & 0x7F) - 65;
+
+        if (exponent >= count - 1)
+        {
+            // Integer: value = sum(digit[k] * 100^(exponent - k))
+            // 100^9 * 100 - 1 < 2^63 so up to exponent 8 no overflow check is needed
+            if (exponent > 9)
+            {
+                out.kind = Oci;
+                return;
+            }
+            unsigned long long v = 0;
+            if (exponent < 9)
+            {
+                for (int k = 0; k < count; k++)
+                    v = v * 100 + (negative ? 101 - m[k] : m[k] - 1);
+                for (int k = count; k <= exponent; k++)
+                    v *= 100;
+            }
+            else
+            {
+                for (int k = 0; k <= exponent; k++)
+                {
+                    unsigned digit = k < count ? (negative ? 101 - m[k] : m[k] - 1) : 0;
+                    if (v > (ULLONG_MAX - digit) / 100)
+                    {
+                        out.kind = Oci;
+                        return;
+                    }
+                    v = v * 100 + digit;
+                }
+            }
+
+            if (!negative && v <= (unsigned long long) LLONG_MAX)
+            {
+                out.kind = Int;
+                out.i = (long long) v;
+            }
+            else if (negative && v <= (unsigned long long) LLONG_MAX + 1)
+            {
+                out.kind = Int;
+                out.i = v == (unsigned long long) LLONG_MAX + 1 ? LLONG_MIN : -(long long) v;
+            }
+            else
+            {
+                out.kind = Oci;
+            }
+            return;
+        }
+
+        // Fractional number: value = M * 10^E, M being the decimal significand.
+        // Up to 15 decimal digits M is exact in a double, and so is 10^-E for
+        // E >= -22, one IEEE division then yields the correctly rounded result.
+        char digits[48];
+        int nd = 0;
+        for (int k = 0; k < count; k++)
+        {
+            unsigned digit = negative ? 101 - m[k] : m[k] - 1;
+            if (nd > 0 || digit >= 10)
+                digits[nd++] = char('0' + digit / 10);
+            digits[nd++] = char('0' + digit % 10);
+        }
+        int exp10 = 2 * (exponent - count + 1);
+        while (nd > 1 && digits[nd - 1] == '0')
+        {
+            --nd;
+            ++exp10;
+        }
+
+        if (nd <= 15 && exp10 >= -22)
+        {
+            long long sig = 0;
+            for (int k = 0; k < nd; k++)
+                sig = sig * 10 + (digits[k] - '0');
+            double d = (double) sig / pow10[-exp10];
+            out.kind = Real;
+            out.d = negative ? -d : d;
+            return;
+        }
+
+        // Slow path, let strtod do the correct rounding. No decimal point
+        // is written, so the result does not depend on the C locale.
+        char buf[64];
+        int pos = 0;
+        if (negative)
+            buf[pos++] = '-';
+        for (int k = 0; k < nd; k++)
+            buf[pos++] = digits[k];
+        buf[pos++] = 'e';
+        buf[pos++] = '-';
+        int ex = -exp10;
+        char rev[8];
+        int nr = 0;
+        do
+        {
+            rev[nr++] = char('0' + ex % 10);
+            ex /= 10;
+        }
+        while (ex);
+        while (nr)
+            buf[pos++] = rev[--nr];
+        buf[pos] = '\0';
+
+        out.kind = Real;
+        out.d = strtod(buf, NULL);
+    }
+
+    /** Decode a whole column of a define buffer.
+     *  @param buffer first OCINumber of the column
+     *  @param stride distance between two rows in bytes (BindPar::value_sz)
+     *  @param indicators null indicators (may be NULL), -1 means NULL
+     *  @param rows number of rows to decode
+     *  @param out at least @p rows values
+     */
+    inline void decodeColumn(const unsigned char *buffer, unsigned stride, const short *indicators, unsigned rows, Value *out)
+    {
+        for (unsigned row = 0; row < rows; row++, buffer += stride)
+        {
+            if (indicators && indicators[row] == -1)
+            {
+                out[row].kind = Null;
+                continue;
+            }
+            // Fast path: small non-negative integers (0..99, 100..9999, ...)
+            // are by far the most common values in ID and counter columns.
+            unsigned char const len = buffer[0];
+            if (len == 2 && buffer[1] == 0xC1)
+            {
+                out[row].kind = Int;
+                out[row].i = buffer[2] - 1;
+                continue;
+            }
+            if (len == 3 && buffer[1] == 0xC2)
+            {
+                out[row].kind = Int;
+                out[row].i = (buffer[2] - 1) * 100 + (buffer[3] - 1);
+                continue;
+            }
+            decode(buffer, out[row]);
+        }
+    }
+}
@@ -36,7 +36,7 @@
 
 oracleQuery::oracleQuery(toQueryAbstr *query, toOracleConnectionSub *) : queryImpl(query)
 {
-    TLOG(6, toDecorator, __HERE__) << std::endl;
+    TLOGF(6, "oracleQuery created");
     Running = Cancel = false;
     SaveInPool = false;
     Query = NULL;
@@ -250,7 +250,7 @@ bool oracleQuery::eof(void)
 {
     if (!Query || Cancel)
     {
-        TLOG(6, toDecorator, __HERE__) << "eof - on canceled query" << std::endl;
+        TLOGF(6, "eof - on canceled query");
         return true;
     }
     try
@@ -259,13 +259,13 @@ bool oracleQuery::eof(void)
         if (e)
         {
             Running = false;
-            TLOG(6, toDecorator, __HERE__) << "eof(" << Query->row_count() << ')' << std::endl;
+            TLOGF(6, "eof(%1)", Query->row_count());
         }
         return e; //Query->eof();
     }
     catch (const ::trotl::OciException &exc)
     {
-        TLOG(6, toDecorator, __HERE__) << "eof(e) - " << exc.what() << std::endl;
+        TLOGF(6, "eof(e) - %1", exc.what());
         if (query())
         {
             toOracleConnectionSub *conn = dynamic_cast<toOracleConnectionSub *>(query()->connectionSubPtr());
@@ -287,6 +287,7 @@ oracleQuery::trotlQuery::trotlQuery(::trotl::OciConnection &conn,
                                     ub4 lang,
                                     int bulk_rows)
     : ::trotl::SqlStatement(conn, stmt, lang, bulk_rows)
+    , NumbersBatch(0)
 {
     // Be compatible with otl, execute some statements immediately
     if ( get_stmt_type() == STMT_ALTER
@@ -296,6 +297,77 @@ oracleQuery::trotlQuery::trotlQuery(::trotl::OciConnection &conn,
         execute_internal(::trotl::g_OCIPL_BULK_ROWS, OCI_DEFAULT);
 };
 
+toOracleNumber::Value const& oracleQuery::trotlQuery::numberAt(::trotl::BindPar const &BP)
+{
+    if (Numbers.size() < _column_count)
+        Numbers.resize(_column_count);
+
+    NumberColumn &col = Numbers[_out_pos - 1];
+    if (col.Batch != NumbersBatch)
+    {
+        unsigned rows = fetched_rows();
+        col.Values.resize(rows);
+        toOracleNumber::decodeColumn((const unsigned char*)BP.valuep,
+                                     BP.value_sz,
+                                     (const short*)BP.indp,
+                                     rows,
+                                     col.Values.data());
+        col.Batch = NumbersBatch;
+    }
+    Q_ASSERT_X(_last_buff_row < col.Values.size(), qPrintable(__QHERE__), "row out of fetched range");
+    return col.Values[_last_buff_row];
+}
+
+void oracleQuery::trotlQuery::readNumberOci(::trotl::BindPar const &BP, toQValue &value)
+{
+    OCINumber* vnu = (OCINumber*) & ((char*)BP.valuep)[_last_buff_row * BP.value_sz ];
+    sword res;
+    boolean isint;
+    res = OCINumberIsInt(_errh, vnu, &isint);
+    oci_check_error(__HERE__, _errh, res);
+    try
+    {
+        if (isint)
+        {
+            long long i;
+            res = OCINumberToInt(_errh,
+                                 vnu,
+                                 sizeof(long long),
+                                 OCI_NUMBER_SIGNED,
+                                 &i);
+            oci_check_error(__HERE__, _errh, res);
+            value = toQValue(i);
+        }
+        else
+        {
+            double d;
+            sword res = OCINumberToReal(_errh,
+                                        vnu,
+                                        sizeof(double),
+                                        &d);
+            oci_check_error(__HERE__, _errh, res);
+            value = toQValue(d);
+        }
+    }
+    catch (const ::trotl::OciException &e)
+    {
+        text str_buf[65];
+        ub4 str_len = sizeof(str_buf) / sizeof(*str_buf);
+        const char fmt[] = "TM";
+        sword res = OCINumberToText(_errh,
+                                    vnu,
+                                    (const oratext*)fmt,
+                                    sizeof(fmt) - 1,
+                                    0, // CONST OraText *nls_params,
+                                    0, // ub4 nls_p_length,
+                                    (ub4*)&str_len,
+                                    str_buf );
+        oci_check_error(__HERE__, _env._errh, res);
+        str_buf[str_len + 1] = '\0';
+        value = toQValue(QString::fromUtf8((const char*)str_buf));
+    }
+}
+
 void oracleQuery::trotlQuery::readValue(toQValue &value)
 {
     pre_read_value();
@@ -303,6 +375,10 @@ void oracleQuery::trotlQuery::readValue(toQValue &value)
                              get_next_column() :
                              get_next_out_bindpar());
 
+    // Values are read row by row, the 1st column of the 1st row means a new batch was fetched
+    if (get_stmt_type() == STMT_SELECT && _out_pos == 1 && _last_buff_row == 0)
+        ++NumbersBatch;
+
     if (BP.is_null(_last_buff_row) && BP.dty != SQLT_NTY)
     {
         value = toQValue();
@@ -315,54 +391,22 @@ void oracleQuery::trotlQuery::readValue(toQValue &value)
             case SQLT_NUM:
             case SQLT_VNU:
                 {
-                    OCINumber* vnu = (OCINumber*) & ((char*)BP.valuep)[_last_buff_row * BP.value_sz ];
-                    sword res;
-                    boolean isint;
-                    res = OCINumberIsInt(_errh, vnu, &isint);
-                    oci_check_error(__HERE__, _errh, res);
-                    try
+                    if (get_stmt_type() != STMT_SELECT)
                     {
-                        if (isint)
-                        {
-                            long long i;
-                            res = OCINumberToInt(_errh,
-                                                 vnu,
-                                                 sizeof(long long),
-                                                 OCI_NUMBER_SIGNED,
-                                                 &i);
-                            oci_check_error(__HERE__, _errh, res);
-                            value = toQValue(i);
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: '" << i << '\'' << std::endl;
-                        }
-                        else
-                        {
-                            double d;
-                            sword res = OCINumberToReal(_errh,
-                                                        vnu,
-                                                        sizeof(double),
-                                                        &d);
-                            oci_check_error(__HERE__, _errh, res);
-                            value = toQValue(d);
-                            //TLOG(4, toDecorator, __HERE__) << "Just read: '" << d << '\'' << std::endl;
-                        }
+                        readNumberOci(BP, value);
+                        break;
                     }
-                    catch (const ::trotl::OciException &e)
+                    toOracleNumber::Value const &num = numberAt(BP);
+                    switch (num.kind)
                     {
-                        text str_buf[65];
-                        ub4 str_len = sizeof(str_buf) / sizeof(*str_buf);
-                        //const char fmt[]="99999999999999999999999999999999999999D00000000000000000000";
-                        const char fmt[] = "TM";
-                        sword res = OCINumberToText(_errh,
-                                                    vnu,
-                                                    (const oratext*)fmt,
-                                                    sizeof(fmt) - 1,
-                                                    0, // CONST OraText *nls_params,
-                                                    0, // ub4 nls_p_length,
-                                                    (ub4*)&str_len,
-                                                    str_buf );
-                        oci_check_error(__HERE__, _env._errh, res);
-                        str_buf[str_len + 1] = '\0';
-                        value = toQValue(QString::fromUtf8((const char*)str_buf));
+                        case toOracleNumber::Int:
+                            value = toQValue((qlonglong) num.i);
+                            break;
+                        case toOracleNumber::Real:
+                            value = toQValue(num.d);
+                            break;
+                        default:
+                            readNumberOci(BP, value);
                     }
                 }
                 break;
@@ -44,6 +44,7 @@
 #include "core/toqueryimpl.h"
 #include "connection/tooracleconnection.h"
 #include "connection/tooracledatatype.h"
+#include "connection/tooraclenumber.h"
 
 #include "trotl.h"
 #include "trotl_convertor.h"
@@ -62,6 +63,25 @@ class oracleQuery : public queryImpl
                 trotlQuery(::trotl::OciConnection &conn, const ::trotl::tstring &stmt, ub4 lang = OCI_NTV_SYNTAX, int bulk_rows =::trotl::g_OCIPL_BULK_ROWS);
 
                 void readValue(toQValue &value);
+
+                /** Number of fetched batches read so far */
+                unsigned batches() const
+                {
+                    return NumbersBatch;
+                }
+            private:
+                /** NUMBER columns are decoded once per fetched batch, see toOracleNumber */
+                struct NumberColumn
+                {
+                    NumberColumn() : Batch(0) {}
+                    unsigned Batch;
+                    std::vector<toOracleNumber::Value> Values;
+                };
+                toOracleNumber::Value const& numberAt(::trotl::BindPar const &BP);
+                void readNumberOci(::trotl::BindPar const &BP, toQValue &value);
+
+                std::vector<NumberColumn> Numbers;
+                unsigned NumbersBatch;
         };
         trotlQuery * Query;
 
@@ -100,6 +120,11 @@ class oracleQuery : public queryImpl
             return retval;
         }
 
+        virtual unsigned long fetchCount(void)
+        {
+            return Query ? Query->batches() : 0;
+        }
+
         virtual unsigned columns(void)
         {
             //int descriptionLen;
@@ -45,16 +45,40 @@ static toSQL SQLConnectionHasTransaction("toConnection:HasTransaction"
         , "Oracle");
 
 static toSQL SQLListObjectsInDatabase("toConnection:ListObjectsInDatabase",
-                                      "select a.owner,a.object_name,a.object_type,b.comments\n"
+                                      "select a.owner,a.object_name,a.object_type,b.comments,\n"
+                                      "       to_char(a.last_ddl_time, 'YYYY-MM-DD HH24:MI:SS')\n"
                                       "  from sys.all_objects a,\n"
                                       "       sys.all_tab_comments b\n"
                                       " where a.owner = b.owner(+) and a.object_name = b.table_name(+)\n"
-                                      , "List all the objects to cache for a connection"
+                                      , "List all the objects to cache for a connection, "
+                                      "optional 5th column is used as high-water mark for incremental refresh"
                                       , "0800"
                                       , "Oracle");
 
+static toSQL SQLListModifiedObjects("toConnection:ListModifiedObjects",
+                                    "select a.owner,a.object_name,a.object_type,b.comments,\n"
+                                    "       to_char(a.last_ddl_time, 'YYYY-MM-DD HH24:MI:SS')\n"
+                                    "  from sys.all_objects a,\n"
+                                    "       sys.all_tab_comments b\n"
+                                    " where a.owner = b.owner(+) and a.object_name = b.table_name(+)\n"
+                                    "   and a.last_ddl_time >= to_date(:since<char[31]>, 'YYYY-MM-DD HH24:MI:SS')\n"
+                                    , "List objects modified since the last object cache refresh"
+                                    , "0800"
+                                    , "Oracle");
+
+static toSQL SQLCountObjectsBySchema("toConnection:CountObjectsBySchema",
+                                     "select owner, count(distinct object_name)\n"
+                                     "  from sys.all_objects\n"
+                                     " where object_type in ('TABLE', 'VIEW', 'SYNONYM', 'PROCEDURE', 'FUNCTION', 'PACKAGE',\n"
+                                     "                       'PACKAGE BODY', 'INDEX', 'SEQUENCE', 'TRIGGER')\n"
+                                     " group by owner\n"
+                                     , "Number of cached objects in each schema, used to detect dropped objects"
+                                     , "0800"
+                                     , "Oracle");
+
 static toSQL SQLListObjectInSchema("toConnection:ListObjectsInSchema",
-                                   "select a.owner,a.object_name,a.object_type,b.comments\n"
+                                   "select a.owner,a.object_name,a.object_type,b.comments,\n"
+                                   "       to_char(a.last_ddl_time, 'YYYY-MM-DD HH24:MI:SS')\n"
                                    "  from sys.all_objects a,\n"
                                    "       sys.all_tab_comments b\n"
                                    " where a.owner = b.owner(+) and a.object_name = b.table_name(+)\n"
@@ -63,6 +87,33 @@ static toSQL SQLListObjectInSchema("toConnection:ListObjectsInSchema",
                                    , "0800"
                                    , "Oracle");
 
+static toSQL SQLListObjectInSchemaByType("toConnection:ListObjectsInSchemaByType",
+                                         "select a.owner,a.object_name,a.object_type,b.comments,\n"
+                                         "       to_char(a.last_ddl_time, 'YYYY-MM-DD HH24:MI:SS')\n"
+                                         "  from sys.all_objects a,\n"
+                                         "       sys.all_tab_comments b\n"
+                                         " where a.owner = b.owner(+) and a.object_name = b.table_name(+)\n"
+                                         "   and a.owner = :owner<char[101]> \n"
+                                         "   and a.object_type = :type<char[101]> \n"
+                                         , "List objects of one type to cache, used to split reading of large schemas"
+                                         , "0800"
+                                         , "Oracle");
+
+static toSQL SQLListColumnsInSchema("toCache:ListColumnsInSchema",
+                                    "select c.table_name, c.column_name, c.data_type, c.data_length,\n"
+                                    "       c.data_precision, c.data_scale, c.char_length, c.char_used,\n"
+                                    "       c.nullable, cc.comments\n"
+                                    "  from sys.all_tab_columns c,\n"
+                                    "       sys.all_col_comments cc\n"
+                                    " where c.owner = :owner<char[101]>\n"
+                                    "   and cc.owner(+) = c.owner\n"
+                                    "   and cc.table_name(+) = c.table_name\n"
+                                    "   and cc.column_name(+) = c.column_name\n"
+                                    " order by c.table_name, c.column_id\n"
+                                    , "Describe columns of all tables and views in a schema at once"
+                                    , "0800"
+                                    , "Oracle");
+
 /*
 ** 11g version, see $ORACLE_HOME/rdbms/admin/utlxplan.sql
 */
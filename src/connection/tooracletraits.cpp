@@ -138,3 +138,17 @@ QList<QString> toOracleTraits::primaryKeys(toConnection &conn, toCache::ObjectRe
     else
         return QList<QString>(); // no primary keys for views
 }
+
+QString toOracleTraits::insertRows(QString const &table, QString const &columns, QStringList const &rows) const
+{
+    static const QString INTO = QString::fromLatin1(" INTO %1 ( %2 ) VALUES( %3 )\n");
+
+    // Oracle (before 23c) does not know multi-row VALUES
+    QString sql = QString::fromLatin1("INSERT ALL\n");
+    Q_FOREACH(QString const &row, rows)
+    {
+        sql += INTO.arg(table, columns, row);
+    }
+    sql += QString::fromLatin1("SELECT * FROM dual");
+    return sql;
+}
@@ -74,5 +74,12 @@ class toOracleTraits: public toConnectionTraits
             return true;
         }
 
+        bool hasSavepoints() const override
+        {
+            return true;
+        }
+
+        QString insertRows(QString const &table, QString const &columns, QStringList const &rows) const override;
+
         QList<QString> primaryKeys(toConnection &, toCache::ObjectRef const&) const override;
 };
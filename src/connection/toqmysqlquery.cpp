@@ -36,6 +36,7 @@
 #include "connection/toqmysqlprovider.h"
 #include "connection/toqmysqltraits.h"
 #include "connection/toqmysqlsetting.h"
+#include "connection/toqmysqlstream.h"
 #include "core/toconfiguration.h"
 #include "core/tosql.h"
 #include "core/tocache.h"
@@ -45,6 +46,8 @@
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlField>
 #include <QtSql/QSqlError>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QMutexLocker>
 
 static toSQL SQLCancel("toQSqlConnection:Cancel",
                        "KILL :f1",
@@ -82,6 +85,9 @@ QSqlQuery* mysqlQuery::createQuery(const QString &sql)
 mysqlQuery::mysqlQuery(toQueryAbstr *query, toQMySqlConnectionSub *conn)
     : qsqlQuery(query, conn)
     , Query(NULL)
+    , Stream(NULL)
+    , StreamRows(0)
+    , Streamed(false)
     , Connection(conn)
     , CurrentColumn(0)
     , EOQ(true)
@@ -90,7 +96,11 @@ mysqlQuery::mysqlQuery(toQueryAbstr *query, toQMySqlConnectionSub *conn)
 
 mysqlQuery::~mysqlQuery()
 {
+    // Unread rest of a streamed result is drained by the client library when freed.
+    // Not killed from here, this runs on the worker thread, toEventQuery::stop()
+    // cancels long running reads from the GUI thread
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    closeStream();
     delete Query;
 }
 
@@ -99,6 +109,8 @@ void mysqlQuery::execute(void)
 	LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
 	ExtraQuery = queryParam(query()->sql(), query()->params());
 	QString sql = ExtraQuery.takeFirst();
+	if (startStream(*ptr, sql))
+	    return;
 	Query = createQuery(sql);
     checkQuery();
 }
@@ -111,7 +123,14 @@ void mysqlQuery::execute(QString const& sql)
 }
 void mysqlQuery::cancel(void)
 {
-    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    // While streaming the reading thread holds the lock until the next row arrives,
+    // KILL is sent through another connection so do not wait for it
+    bool streaming;
+    {
+        QMutexLocker lock(&StreamLock);
+        streaming = Stream != NULL;
+    }
+    QScopedPointer<LockingPtr<QSqlDatabase> > ptr(streaming ? NULL : new LockingPtr<QSqlDatabase>(Connection->Connection, Connection->Lock));
     if (!Connection->ConnectionID.isEmpty())
     {
         try
@@ -142,11 +161,26 @@ toQValue mysqlQuery::readValue(void)
 {
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
 
-    if (!Query)
-        throw toConnection::exception(QString::fromLatin1("Fetching from not executed query"));
     if (EOQ)
         throw toConnection::exception(QString::fromLatin1("Tried to read past end of query"));
 
+    if (Stream)
+    {
+        QVariant retval = Stream->value(CurrentColumn);
+        CurrentColumn++;
+        if (CurrentColumn == (unsigned int) Record.count())
+        {
+            CurrentColumn = 0;
+            EOQ = !Stream->next();
+        }
+        if (EOQ)
+            closeStream();
+        return toQValue::fromVariant(retval);
+    }
+
+    if (!Query)
+        throw toConnection::exception(QString::fromLatin1("Fetching from not executed query"));
+
     QVariant retval;
     {
         retval = Query->value(CurrentColumn);
@@ -187,6 +221,8 @@ unsigned long mysqlQuery::rowsProcessed(void)
     {
         LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock, true);
 
+        if (Streamed)
+            return Stream ? Stream->rows() : StreamRows;
         if (!Query)
             return 0L;
         return Query->numRowsAffected();
@@ -207,7 +243,11 @@ toQColumnDescriptionList mysqlQuery::describe(void)
 {
     LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
     toQColumnDescriptionList ret;
-    if (Query && Query->isSelect())
+    if (Streamed)
+    {
+        ret = describe(Record);
+    }
+    else if (Query && Query->isSelect())
     {
         ret = describe(Query->record());
     }
@@ -236,6 +276,51 @@ void mysqlQuery::checkQuery(void) // Must *not* call while locked
     }
 }
 
+bool mysqlQuery::startStream(QSqlDatabase &db, const QString &sql) // Must be called while locked
+{
+    if (!toConfigurationNewSingle::Instance().option(MySQL::StreamResultsBool).toBool())
+        return false;
+    // Results of toAnalyze like queries and queries using binds are read the usual way
+    if (!ExtraQuery.isEmpty() || !query()->params().empty() || !qsqlQuery::isPlainSelect(sql, "MySQLGuiLexer"))
+        return false;
+    // Servers older than 5.0 have no KILL QUERY, cancel() would drop the whole connection
+    if (query()->connection().version() < "0500")
+        return false;
+
+    toQMySqlStream *stream = toQMySqlStream::start(db, sql);
+    if (!stream)
+        return false;
+    {
+        QMutexLocker lock(&StreamLock);
+        Stream = stream;
+    }
+    Streamed = true;
+
+    // Needed for KILL QUERY in cancel() (see SQLCancelM5, only the running statement is aborted)
+    if (Connection->ConnectionID.isEmpty())
+        Connection->ConnectionID = QString::number(Stream->connectionId());
+
+    Record = Stream->record();
+    CurrentColumn = 0;
+    EOQ = Record.isEmpty() || !Stream->next();
+    if (EOQ)
+        closeStream();
+    return true;
+}
+
+void mysqlQuery::closeStream(void)
+{
+    if (!Stream)
+        return;
+    StreamRows = Stream->rows();
+    toQMySqlStream *stream = Stream;
+    {
+        QMutexLocker lock(&StreamLock);
+        Stream = NULL;
+    }
+    delete stream;
+}
+
 toQColumnDescriptionList mysqlQuery::describe(QSqlRecord record)
 {
     ColumnDescriptions.clear();
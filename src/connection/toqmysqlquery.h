@@ -40,9 +40,11 @@
 #include <QtSql/QSqlRecord>
 #include <QtCore/QList>
 #include <QtCore/QStringList>
+#include <QtCore/QMutex>
 
 class QSqlQuery;
 class toQMySqlConnectionSub;
+class toQMySqlStream;
 
 class mysqlQuery : public qsqlQuery
 {
@@ -72,7 +74,15 @@ class mysqlQuery : public qsqlQuery
         void bindParam(QSqlQuery *q, toQueryParams const &params);
         QStringList queryParam(const QString &in, toQueryParams &params);
 
+        /** Start unbuffered reading of sql, returns false if not possible (see MySQL::StreamResultsBool) */
+        bool startStream(QSqlDatabase &db, const QString &sql);
+        void closeStream(void);
+
         QSqlQuery *Query;
+        toQMySqlStream *Stream;                            // non NULL while a streamed result is being read
+        QMutex StreamLock;                                 // guards Stream for cancel(), the connection lock is held by the reader
+        unsigned long StreamRows;
+        bool Streamed;
         QSqlRecord Record;
         QStringList BindParams;
         QStringList ExtraQuery;                            // see toAnalyze
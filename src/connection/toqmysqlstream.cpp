@@ -0,0 +1,275 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "connection/toqmysqlstream.h"
+#include "core/toconnection.h"
+
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlDriver>
+#include <QtSql/QSqlField>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+
+#ifdef HAVE_MYSQL_H
+#include <mysql.h>
+
+#if defined(Q_OS_LINUX)
+#include <dlfcn.h>
+#include <link.h>
+#endif
+
+// Charset number of binary strings (BLOB, VARBINARY)
+#define TO_MYSQL_BINARY_CHARSET 63
+
+// Same mapping as QMYSQL uses for buffered results (qDecodeMYSQLType)
+static QVariant::Type fieldType(MYSQL_FIELD const *field)
+{
+    bool isUnsigned = field->flags & UNSIGNED_FLAG;
+    switch (field->type)
+    {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_INT24:
+            return isUnsigned ? QVariant::UInt : QVariant::Int;
+        case MYSQL_TYPE_YEAR:
+            return QVariant::Int;
+        case MYSQL_TYPE_LONGLONG:
+            return isUnsigned ? QVariant::ULongLong : QVariant::LongLong;
+        case MYSQL_TYPE_FLOAT:
+        case MYSQL_TYPE_DOUBLE:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL:
+            return QVariant::Double;
+        case MYSQL_TYPE_DATE:
+            return QVariant::Date;
+        case MYSQL_TYPE_TIME:
+            return QVariant::Time;
+        case MYSQL_TYPE_DATETIME:
+        case MYSQL_TYPE_TIMESTAMP:
+            return QVariant::DateTime;
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+            return field->charsetnr == TO_MYSQL_BINARY_CHARSET ? QVariant::ByteArray : QVariant::String;
+        default:
+            return QVariant::String;
+    }
+}
+
+#if defined(Q_OS_LINUX)
+static int collectClientLibrary(struct dl_phdr_info *info, size_t, void *data)
+{
+    QString path = QFile::decodeName(info->dlpi_name);
+    QString name = QFileInfo(path).fileName();
+    if (name.startsWith(QString::fromLatin1("libmysqlclient"))
+            || name.startsWith(QString::fromLatin1("libmariadb"))
+            || name.startsWith(QString::fromLatin1("libperconaserverclient")))
+        static_cast<QStringList*>(data)->append(QFileInfo(path).canonicalFilePath());
+    return 0;
+}
+#endif
+
+/** MYSQL* returned by the driver is owned by the client library the QMYSQL plugin was linked with.
+ *  The handle may only be passed to our own mysql_* calls when both are the very same library,
+ *  a different build (or MariaDB Connector/C) has a different layout of MYSQL and MYSQL_RES.
+ */
+static bool isClientLibraryShared(void)
+{
+#if defined(Q_OS_LINUX)
+    Dl_info self;
+    if (!dladdr((void*) &mysql_real_query, &self) || !self.dli_fname)
+        return false;
+
+    QStringList loaded;
+    dl_iterate_phdr(collectClientLibrary, &loaded);
+    loaded.removeDuplicates();
+    // TOra linked statically or the plugin loaded its own copy
+    return loaded.size() == 1 && loaded.first() == QFileInfo(QFile::decodeName(self.dli_fname)).canonicalFilePath();
+#else
+    // Can not verify which library the plugin uses, read buffered
+    return false;
+#endif
+}
+#endif
+
+toQMySqlStream* toQMySqlStream::start(QSqlDatabase &db, QString const &sql)
+{
+#ifdef HAVE_MYSQL_H
+    // The plugin is loaded by now and the set of client libraries does not change any more
+    static const bool shared = isClientLibraryShared();
+    if (!shared)
+        return NULL;
+
+    QVariant v = db.driver()->handle();
+    if (!v.isValid() || v.typeName() != QString("MYSQL*"))
+        return NULL;
+    MYSQL *mysql = *static_cast<MYSQL **>(v.data());
+    if (!mysql)
+        return NULL;
+
+    // QMYSQL sets the connection character set to utf8
+    QByteArray text = sql.toUtf8();
+    if (mysql_real_query(mysql, text.constData(), text.size()) != 0)
+        throw toConnection::exception(QString::fromUtf8(mysql_error(mysql)));
+
+    // Values are converted the way QSqlQuery created on db would do
+    QSql::NumericalPrecisionPolicy policy = db.driver()->numericalPrecisionPolicy();
+    MYSQL_RES *result = mysql_use_result(mysql);
+    if (!result)
+    {
+        if (mysql_field_count(mysql) != 0)
+            throw toConnection::exception(QString::fromUtf8(mysql_error(mysql)));
+        // Statement did not return any rows after all
+        return new toQMySqlStream(mysql, NULL, policy);
+    }
+    return new toQMySqlStream(mysql, result, policy);
+#else
+    Q_UNUSED(db);
+    Q_UNUSED(sql);
+    return NULL;
+#endif
+}
+
+toQMySqlStream::toQMySqlStream(st_mysql *mysql, st_mysql_res *result, QSql::NumericalPrecisionPolicy policy)
+    : Mysql(mysql)
+    , Result(result)
+    , Policy(policy)
+    , Row(NULL)
+    , Lengths(NULL)
+    , Rows(0)
+    , Finished(result == NULL)
+{
+#ifdef HAVE_MYSQL_H
+    if (!Result)
+        return;
+    unsigned int count = mysql_num_fields(Result);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        MYSQL_FIELD *field = mysql_fetch_field_direct(Result, i);
+        QSqlField f(QString::fromUtf8(field->name), fieldType(field));
+        f.setSqlType(field->type);
+        f.setLength(field->length);
+        f.setPrecision(field->decimals);
+        f.setRequiredStatus((field->flags & NOT_NULL_FLAG) ? QSqlField::Required : QSqlField::Optional);
+        Record.append(f);
+    }
+#endif
+}
+
+toQMySqlStream::~toQMySqlStream()
+{
+#ifdef HAVE_MYSQL_H
+    if (Result)
+        mysql_free_result(Result);
+#endif
+}
+
+bool toQMySqlStream::next(void)
+{
+#ifdef HAVE_MYSQL_H
+    if (Finished)
+        return false;
+    Row = mysql_fetch_row(Result);
+    if (!Row)
+    {
+        Finished = true;
+        // NULL is also returned when the connection was broken or the query killed
+        if (mysql_errno(Mysql) != 0)
+            throw toConnection::exception(QString::fromUtf8(mysql_error(Mysql)));
+        return false;
+    }
+    Lengths = mysql_fetch_lengths(Result);
+    Rows++;
+    return true;
+#else
+    return false;
+#endif
+}
+
+unsigned long toQMySqlStream::connectionId(void) const
+{
+#ifdef HAVE_MYSQL_H
+    return mysql_thread_id(Mysql);
+#else
+    return 0;
+#endif
+}
+
+QVariant toQMySqlStream::value(int col) const
+{
+    if (!Row || !Row[col])
+        return QVariant();
+
+    QByteArray data(Row[col], Lengths[col]);
+    switch (Record.field(col).type())
+    {
+        case QVariant::Int:
+            return QVariant(data.toInt());
+        case QVariant::UInt:
+            return QVariant(data.toUInt());
+        case QVariant::LongLong:
+            return QVariant(data.toLongLong());
+        case QVariant::ULongLong:
+            return QVariant(data.toULongLong());
+        case QVariant::Double:
+            switch (Policy)
+            {
+                case QSql::LowPrecisionInt32:
+                    return QVariant(QVariant(data.toDouble()).toInt());
+                case QSql::LowPrecisionInt64:
+                    return QVariant(QVariant(data.toDouble()).toLongLong());
+                case QSql::LowPrecisionDouble:
+                    return QVariant(data.toDouble());
+                default:
+                    // DECIMAL is kept as text not to loose precision
+                    return QVariant(QString::fromUtf8(data));
+            }
+        case QVariant::Date:
+            return QVariant(QDate::fromString(QString::fromLatin1(data), Qt::ISODate));
+        case QVariant::Time:
+            return QVariant(QTime::fromString(QString::fromLatin1(data), Qt::ISODate));
+        case QVariant::DateTime:
+            return QVariant(QDateTime::fromString(QString::fromLatin1(data), Qt::ISODate));
+        case QVariant::ByteArray:
+            return QVariant(data);
+        default:
+            return QVariant(QString::fromUtf8(data));
+    }
+}
@@ -0,0 +1,106 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include <QtCore/QVariant>
+#include <QtSql/QSqlRecord>
+#include <QtSql/QSql>
+
+class QSqlDatabase;
+
+struct st_mysql;
+struct st_mysql_res;
+
+/** Unbuffered reader of a single result set (mysql_use_result) running on the
+ *  native handle of a QMYSQL connection.
+ *
+ *  Rows are pulled from the server one by one as they are read instead of being
+ *  stored on the client first. Until the result is fully read or destroyed
+ *  the connection can not be used for anything else.
+ *
+ *  Only available when TOra was built against libmysqlclient (HAVE_MYSQL_H) and
+ *  the QMYSQL plugin uses the same client library, otherwise @ref start always returns NULL.
+ */
+class toQMySqlStream
+{
+    public:
+        /** Execute sql on the connection db and return a reader for it's result.
+         *  Returns NULL when the driver handle is not usable (caller should fall back to QSqlQuery),
+         *  throws toConnection::exception on SQL error.
+         */
+        static toQMySqlStream* start(QSqlDatabase &db, QString const &sql);
+
+        /** Frees the result, remaining rows are read and discarded by the client library */
+        ~toQMySqlStream();
+
+        /** Advance to next row, returns false at the end of result */
+        bool next(void);
+
+        /** True if all rows were read from the server */
+        inline bool finished(void) const
+        {
+            return Finished;
+        }
+
+        /** Value of column col converted like QMYSQL converts buffered results */
+        QVariant value(int col) const;
+
+        /** Column names and types, typeID() holds the native MySQL type */
+        inline QSqlRecord const& record(void) const
+        {
+            return Record;
+        }
+
+        inline unsigned long rows(void) const
+        {
+            return Rows;
+        }
+
+        /** Server side id of the connection, mysqlQuery::cancel() passes it to KILL QUERY (MySQL 5.0+ only, streaming is not used on older servers) */
+        unsigned long connectionId(void) const;
+
+    private:
+        toQMySqlStream(st_mysql *mysql, st_mysql_res *result, QSql::NumericalPrecisionPolicy policy);
+        toQMySqlStream(toQMySqlStream const&);
+
+        st_mysql *Mysql;
+        st_mysql_res *Result;
+        QSql::NumericalPrecisionPolicy Policy;
+        char **Row;
+        unsigned long *Lengths;
+        QSqlRecord Record;
+        unsigned long Rows;
+        bool Finished;
+};
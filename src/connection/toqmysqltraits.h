@@ -71,6 +71,22 @@ class toQMySqlTraits: public toConnectionTraits
             return false;
         }
 
+        bool hasSavepoints() const override
+        {
+            return true;
+        }
+
+        QString beginTransactionSQL() const override
+        {
+            return QString::fromLatin1("START TRANSACTION");
+        }
+
+        QString insertRows(QString const &table, QString const &columns, QStringList const &rows) const override
+        {
+            static const QString INSERT = QString::fromLatin1("INSERT INTO %1 ( %2 ) VALUES ( %3 )");
+            return INSERT.arg(table, columns, rows.join(QString::fromLatin1(" ), ( ")));
+        }
+
         QString quoteVarchar(const QString &name) const override
         {
         	return quoteVarcharStatic(name);
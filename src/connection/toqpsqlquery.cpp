@@ -34,11 +34,13 @@
 
 #include "connection/toqpsqlquery.h"
 #include "connection/toqpsqlprovider.h"
-#include "connection/toqpsqlquery.h"
+#include "connection/toqsqlquery.h"
 #include "connection/toqpsqlconnection.h"
 #include "core/tosql.h"
 #include "core/tocache.h"
 #include "core/utils.h"
+#include "core/toconfiguration.h"
+#include "core/todatabaseconfig.h"
 #include "parsing/tsqllexer.h"
 
 #ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
@@ -49,6 +51,7 @@
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlField>
 #include <QtSql/QSqlError>
+#include <QtCore/QAtomicInt>
 
 
 // Only attempt to cancel a query using a secondary connection if we
@@ -87,6 +90,10 @@ QSqlQuery* psqlQuery::createQuery(const QString &sql)
 
 psqlQuery::psqlQuery(toQueryAbstr *query, toQPSqlConnectionSub *conn)
     : queryImpl(query)
+    , CursorRows(0)
+    , BatchRows(0)
+    , RowsRead(0)
+    , Streaming(false)
     , Query(NULL)
     , Connection(conn)
     , CurrentColumn(0)
@@ -98,18 +105,123 @@ psqlQuery::psqlQuery(toQueryAbstr *query, toQPSqlConnectionSub *conn)
 psqlQuery::~psqlQuery()
 {
     delete Query;
+    try
+    {
+        closeCursor();
+    }
+    catch (...)
+    {
+        TLOG(1, toDecorator, __HERE__) << "	Ignored exception." << std::endl;
+    }
 }
 
 void psqlQuery::execute(void)
 {
-    Query = createQuery(query()->sql());
+    if (!startCursor(query()->sql()))
+        Query = createQuery(query()->sql());
     checkQuery();
+    if (EOQ)
+        closeCursor();
 }
 
 void psqlQuery::execute(QString const& sql)
 {
-    Query = createQuery(query()->sql());
+    if (!startCursor(query()->sql()))
+        Query = createQuery(query()->sql());
     checkQuery();
+    if (EOQ)
+        closeCursor();
+}
+
+/* libpq (and so QPSQL) reads whole result set into the client memory.
+ * Plain SELECTs are therefore opened as a server side cursor and read in
+ * batches of CursorFetchRowsInt rows by FETCH FORWARD.
+ * A cursor needs a transaction. TOra opens its own one, so this is done only
+ * when there is no transaction pending, the transaction is committed (as
+ * autocommit would do) when the cursor is closed.
+ */
+bool psqlQuery::startCursor(const QString &sql)
+{
+    CursorRows = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::CursorFetchRowsInt).toInt();
+    if (CursorRows == 0 || !query()->params().empty() || !qsqlQuery::isPlainSelect(sql, "PostreSQLGuiLexer"))
+        return false;
+
+    static QAtomicInt CursorSequence;
+    QString cursor = QString::fromLatin1("tora_cursor_%1").arg(CursorSequence.fetchAndAddRelaxed(1));
+
+    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    if (!ownTransaction(*ptr))
+        return false;
+
+    QSqlQuery q(*ptr);
+    if (!q.exec(QString::fromLatin1("BEGIN")))
+        return false;
+    if (!q.exec(QString::fromLatin1("DECLARE %1 NO SCROLL CURSOR FOR %2").arg(cursor).arg(sql)))
+    {
+        // Statements like SELECT ... INTO can not be declared as cursor
+        TLOG(5, toDecorator, __HERE__) << "DECLARE CURSOR failed: " << q.lastError().text() << std::endl;
+        q.exec(QString::fromLatin1("ROLLBACK"));
+        return false;
+    }
+    Cursor = cursor;
+    Streaming = true;
+    Query = new QSqlQuery(*ptr);
+    Query->setForwardOnly(true);
+    if (!Query->exec(QString::fromLatin1("FETCH FORWARD %1 FROM %2").arg(CursorRows).arg(Cursor)))
+    {
+        // Runtime errors of the SELECT show up here, the cursor goes away with the transaction
+        toConnection::exception exc(toQPSqlConnectionSub::ErrorString(Query->lastError(), Query->lastQuery()));
+        delete Query;
+        Query = NULL;
+        q.exec(QString::fromLatin1("ROLLBACK"));
+        Cursor.clear();
+        Streaming = false;
+        throw exc;
+    }
+    BatchRows = 0;
+    return true;
+}
+
+// Replace the exhausted batch by the next one, must be called while locked
+void psqlQuery::fetchCursor(void)
+{
+    if (BatchRows < CursorRows)
+    {
+        // short batch was the last one
+        EOQ = true;
+        return;
+    }
+    BatchRows = 0;
+    if (!Query->exec(QString::fromLatin1("FETCH FORWARD %1 FROM %2").arg(CursorRows).arg(Cursor)))
+        throw toConnection::exception(toQPSqlConnectionSub::ErrorString(Query->lastError(), Query->lastQuery()));
+    EOQ = !Query->next();
+}
+
+void psqlQuery::closeCursor(void)
+{
+    if (Cursor.isEmpty())
+        return;
+    LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock);
+    QSqlQuery q(*ptr);
+    q.exec(QString::fromLatin1("CLOSE %1").arg(Cursor));
+    // NOTE: in aborted transaction (cancel) COMMIT does ROLLBACK
+    q.exec(QString::fromLatin1("COMMIT"));
+    Cursor.clear();
+}
+
+// true when there is no transaction in progress on this connection
+bool psqlQuery::ownTransaction(QSqlDatabase &db)
+{
+#ifdef HAVE_POSTGRESQL_LIBPQ_FE_H
+    QVariant v = db.driver()->handle();
+    if (v.isValid() && v.typeName() == QString("PGconn*"))
+    {
+        PGconn *handle = *static_cast<PGconn **>(v.data());
+        return handle && PQtransactionStatus(handle) == PQTRANS_IDLE;
+    }
+#endif
+    // Without libpq we can not tell whether the user has a transaction open
+    return false;
 }
 
 void psqlQuery::cancel(void)
@@ -159,12 +271,18 @@ toQValue psqlQuery::readValue(void)
     if (CurrentColumn == (unsigned int) Record.count())
     {
         CurrentColumn = 0;
+        RowsRead++;
+        BatchRows++;
         EOQ = !Query->next();
+        if (EOQ && !Cursor.isEmpty())
+            fetchCursor();
     }
     if (EOQ)
     {
         delete Query;
         Query = NULL;
+        ptr.unlock();
+        closeCursor();
     }
 
     return toQValue::fromVariant(retval);
@@ -181,6 +299,8 @@ unsigned long psqlQuery::rowsProcessed(void)
     {
         LockingPtr<QSqlDatabase> ptr(Connection->Connection, Connection->Lock, true);
 
+        if (Streaming)
+            return RowsRead;
         if (!Query)
             return 0L;
         return Query->numRowsAffected();
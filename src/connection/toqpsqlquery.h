@@ -110,6 +110,16 @@ class psqlQuery : public queryImpl
         QString stripBinds(const QString &in);
         void bindParam(QSqlQuery *q, toQueryParams const &params);
         static QString QueryParam(const QString &in, toQueryParams const &params, QList<QString> &extradata);
+        // Streaming through a server side cursor, see startCursor()
+        bool startCursor(const QString &sql);
+        void fetchCursor(void);
+        void closeCursor(void);
+        static bool ownTransaction(QSqlDatabase &db);
+        QString Cursor;
+        unsigned CursorRows, BatchRows;
+        unsigned long RowsRead;
+        bool Streaming;
+
         QSqlQuery *Query;
         QSqlRecord Record;
         QStringList BindParams;
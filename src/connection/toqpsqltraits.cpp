@@ -39,3 +39,24 @@ QString toQPSqlTraits::schemaSwitchSQL(const QString &schema) const
     static const QString USE_DATABASE("SET search_path TO %1,\"$user\",public");
     return USE_DATABASE.arg(schema);
 }
+
+QString toQPSqlTraits::insertRows(QString const &table, QString const &columns, QStringList const &rows) const
+{
+    static const QString INSERT("INSERT INTO %1 ( %2 ) VALUES ( %3 )");
+    return INSERT.arg(table, columns, rows.join(" ), ( "));
+}
+
+QString toQPSqlTraits::castValue(QString const &value, QString const &datatype) const
+{
+    // psqlQuery::describe names the types by their OID constants (INT4OID, VARCHAROID, ...),
+    // those are pg_type names with OID appended. Other types are left to the server to resolve
+    static const QString OID = QString::fromLatin1("OID");
+    if (!datatype.endsWith(OID) || datatype.size() == OID.size())
+        return value;
+    QString type = datatype.left(datatype.size() - OID.size()).toLower();
+    if (type == QString::fromLatin1("char"))
+        type = QString::fromLatin1("\"char\"");
+    else if (type == QString::fromLatin1("cash"))
+        type = QString::fromLatin1("money");
+    return QString::fromLatin1("(%1)::%2").arg(value, type);
+}
@@ -45,6 +45,21 @@ class toQPSqlTraits: public toQSqlTraits
          * @return SQL statement
          */
         virtual QString schemaSwitchSQL(QString const&) const;
+
+        virtual bool hasSavepoints() const
+        {
+            return true;
+        }
+
+        virtual QString beginTransactionSQL() const
+        {
+            return QString::fromLatin1("BEGIN");
+        }
+
+        virtual QString insertRows(QString const &table, QString const &columns, QStringList const &rows) const;
+
+        /** CASE branches holding literals are text, cast each one to the column type */
+        virtual QString castValue(QString const &value, QString const &datatype) const;
 };
 
 #endif
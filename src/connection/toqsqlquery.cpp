@@ -38,6 +38,7 @@
 #include "core/tosql.h"
 #include "core/tocache.h"
 #include "core/utils.h"
+#include "parsing/tsqllexer.h"
 
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlField>
@@ -334,3 +335,10 @@ toQColumnDescriptionList qsqlQuery::Describe(const QString &type, QSqlRecord rec
     }
     return ret;
 }
+
+bool qsqlQuery::isPlainSelect(const QString &sql, const char *lexerName)
+{
+    std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create(lexerName, "", "qsqlQuery::isPlainSelect");
+    lexer->setStatement(sql);
+    return lexer->isPlainSelect();
+}
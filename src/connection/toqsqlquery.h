@@ -65,6 +65,11 @@ class qsqlQuery : public queryImpl
         unsigned columns(void) override;
 
         toQColumnDescriptionList describe(void) override;
+
+        /** True if sql is a plain SELECT (see SQLLexer::Lexer::isPlainSelect), sql is tokenized by lexer lexerName.
+         *  Used by the providers to decide whether a result can be streamed.
+         */
+        static bool isPlainSelect(const QString &sql, const char *lexerName);
     protected:
         static toQColumnDescriptionList Describe(const QString &type, QSqlRecord record);
 
@@ -68,14 +68,7 @@ void toBackground::start(int msec)
         emit SignalUnpause();
     }
     emit SignalSetSpeed( (::std::min)(Running, 1) * 100);
-    if (Running > 1)
-    {
-        emit SignalSetTip(tr("%1 queries running in background.").arg(Running));
-    }
-    else
-    {
-        emit SignalSetTip(tr("One query running in background."));
-    }
+    emit SignalSetTip(runningTip());
     QTimer::start(msec);
 }
 
@@ -89,16 +82,21 @@ void toBackground::stop(void)
         else
             emit SignalSetSpeed(Running * 100);
 
-        if (Running > 1)
-            emit SignalSetTip(tr("%1 queries running in background.").arg(Running));
-        else if (Running == 1)
-            emit SignalSetTip("One query running in background.");
-        else
-            emit SignalSetTip(tr("No background queries."));
+        emit SignalSetTip(runningTip());
     }
     QTimer::stop();
 }
 
+QString toBackground::runningTip(void)
+{
+    if (Running > 1)
+        return tr("%1 queries running in background.").arg(Running);
+    else if (Running == 1)
+        return tr("One query running in background.");
+    else
+        return tr("No background queries.");
+}
+
 void toBackground::setBackgroundLabel(toBackgroundLabel* label)
 {
     this->label = label;
@@ -66,6 +66,9 @@ class toBackground : public QTimer
 
         void setBackgroundLabel(toBackgroundLabel* label);
 
+        /** Tool tip of the background label for the number of running timers */
+        static QString runningTip(void);
+
     signals:
         void SignalPause();
         void SignalUnpause();
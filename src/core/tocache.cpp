@@ -33,6 +33,7 @@
  * END_COMMON_COPYRIGHT_HEADER */
 
 #include "core/tocache.h"
+#include "core/tocacheimage.h"
 #include "core/toconfiguration.h"
 #include "core/toconnection.h"
 #include "core/toconnectionsub.h"
@@ -49,12 +50,30 @@
 #include <QtCore/QDir>
 #include <QtCore/QDateTime>
 #include <QtCore/QTextStream>
-#include <QtCore/QDataStream>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QThread>
+#include <QtCore/QTime>
+#include <QtCore/QThreadPool>
+#include <QtCore/QRunnable>
 #include <QProgressDialog>
+
+#include <algorithm>
 //#include <boost/preprocessor/iteration/detail/local.hpp>
 
+/** Deletes cache entries read from the database but not handed over to toCache yet
+ *  (on exception or abort). Entries are handed over by removing them from the list. */
+class toCacheEntriesGuard
+{
+    public:
+        toCacheEntriesGuard(QList<toCache::CacheEntry*> &rows) : m_rows(rows) {}
+        ~toCacheEntriesGuard()
+        {
+            qDeleteAll(m_rows);
+        }
+    private:
+        QList<toCache::CacheEntry*> &m_rows;
+};
+
 /* This method runs as a separate thread executed from:
  toCache::readObjects(toTask * t)
  */
@@ -68,17 +87,43 @@ void toCacheWorker::process()
     {
         // TODO: Check if really whole cache was loaded.
         // the file image could contain only some schemas or part of the schema
+        // Apply changes made in DB since the image was written (if supported)
+        refreshDelta();
         parentConnection().getCache().setCacheState(toCache::DONE);
         return;
     }
 
+    readAll();
+}
+
+void toCacheWorker::processDelta()
+{
+    QMutexLocker bLock(&parentConnection().getCache().backgroundThreadLock);
+
+    if (refreshDelta())
+    {
+        parentConnection().getCache().setCacheState(toCache::DONE);
+        return;
+    }
+
+    readAll();
+}
+
+void toCacheWorker::readAll()
+{
     parentConnection().getCache().setCacheState(toCache::READING_FROM_DB);
+    if (readParallel())
+        return;
+
+    QString highWaterMark;
     try
     {
         toConnectionSubLoan conn(parentConnection());
         toQuery objects(conn
                         , toSQL::sql("toConnection:ListObjectsInDatabase",parentConnection())
                         , toQueryParams());
+        // optional 5th column holds objects DDL time, see toCacheWorker::refreshDelta
+        bool hasDDLTime = objects.columns() >= 5;
         while (!objects.eof())
         {
             if (parentConnection().Abort)
@@ -91,6 +136,12 @@ void toCacheWorker::process()
             QString name = (QString)objects.readValue();
             QString type = (QString)objects.readValue();
             QString comment = (QString)objects.readValue();
+            if (hasDDLTime)
+            {
+                QString ddlTime = (QString)objects.readValue();
+                if (ddlTime > highWaterMark)
+                    highWaterMark = ddlTime;
+            }
             toCache::CacheEntry *e = toCache::createCacheEntry(owner, name,
                                      type, comment);
             if (e)
@@ -110,15 +161,486 @@ void toCacheWorker::process()
         return;
     }
 
+    {
+        QWriteLocker lock(&parentConnection().getCache().cacheLock);
+        parentConnection().getCache().m_highWaterMark = highWaterMark;
+    }
     parentConnection().getCache().ownersRead = true;
     parentConnection().getCache().setCacheState(toCache::DONE);
 }
-;
 
-// Forward declarations
-// Allow cache entries to be serialized / de-serialized
-QDataStream& operator<<(QDataStream& stream, const toCache::CacheEntry& e);
-QDataStream& operator>>(QDataStream& stream, toCache::CacheEntry& e);
+bool toCacheWorker::refreshDelta()
+{
+    toCache &cache = parentConnection().getCache();
+
+    if (!toConfigurationNewSingle::Instance().option(ToConfiguration::Database::CacheDeltaRefreshBool).toBool())
+        return false;
+
+    QString since;
+    {
+        QReadLocker lock(&cache.cacheLock);
+        since = cache.m_highWaterMark;
+    }
+    if (since.isEmpty())
+        return false;
+
+    QString modifiedSQL, countSQL, schemaSQL;
+    try
+    {
+        modifiedSQL = toSQL::sql("toConnection:ListModifiedObjects", parentConnection());
+        countSQL = toSQL::sql("toConnection:CountObjectsBySchema", parentConnection());
+        schemaSQL = toSQL::sql("toConnection:ListObjectsInSchema", parentConnection());
+    }
+    catch (QString const &exc)
+    {
+        // Not supported by this provider
+        return false;
+    }
+
+    cache.setCacheState(toCache::READING_FROM_DB);
+    QTime time;
+    time.start();
+    int modified = 0;
+    QStringList reread;
+    try
+    {
+        toConnectionSubLoan conn(parentConnection());
+        QString highWaterMark(since);
+
+        // New and altered objects. Objects modified in the same second as high-water mark are read again
+        {
+            toQuery objects(conn, modifiedSQL, toQueryParams() << since);
+            while (!objects.eof())
+            {
+                if (parentConnection().Abort)
+                    return true;
+                QString owner = (QString)objects.readValue();
+                QString name = (QString)objects.readValue();
+                QString type = (QString)objects.readValue();
+                QString comment = (QString)objects.readValue();
+                QString ddlTime = (QString)objects.readValue();
+                if (ddlTime > highWaterMark)
+                    highWaterMark = ddlTime;
+                toCache::CacheEntry *e = toCache::createCacheEntry(owner, name, type, comment);
+                if (e)
+                {
+                    cache.upsertEntry(e);
+                    modified++;
+                }
+            }
+        }
+
+        // Dropped objects leave no trace in the dictionary, compare object counts per schema
+        QMap<QString, int> current;
+        {
+            toQuery counts(conn, countSQL, toQueryParams());
+            while (!counts.eof())
+            {
+                QString owner = (QString)counts.readValue();
+                current[owner] = counts.readValue().toInt();
+            }
+        }
+        reread = toCache::staleSchemas(cache.objectCounts(), current);
+
+        Q_FOREACH(QString const& schema, reread)
+        {
+            if (parentConnection().Abort)
+                return true;
+            QList<toCache::CacheEntry*> rows;
+            toCacheEntriesGuard guard(rows);
+            toQuery objects(conn, schemaSQL, toQueryParams() << schema);
+            bool hasDDLTime = objects.columns() >= 5;
+            while (!objects.eof())
+            {
+                QString owner = (QString)objects.readValue();
+                QString name = (QString)objects.readValue();
+                QString type = (QString)objects.readValue();
+                QString comment = (QString)objects.readValue();
+                if (hasDDLTime)
+                    objects.readValue();
+                if (parentConnection().Abort)
+                    return true;
+                toCache::CacheEntry *e = toCache::createCacheEntry(owner, name, type, comment);
+                if (e)
+                    rows.append(e);
+            }
+
+            // Replace each type of the schema, those dropped completely included
+            QMap<int, QList<toCache::CacheEntry*> > byType;
+            for (int t = toCache::TABLE; t <= toCache::TRIGGER; t++)
+                byType[t];
+            QList<toCache::CacheEntry*> unsupported;
+            Q_FOREACH(toCache::CacheEntry *e, rows)
+            {
+                if (e->type == toCache::ANY || e->type == toCache::OTHER)
+                    unsupported.append(e);
+                else
+                    byType[e->type].append(e);
+            }
+            // Only the entries toCache can not take are left to the guard
+            rows.swap(unsupported);
+            for (QMap<int, QList<toCache::CacheEntry*> >::const_iterator t = byType.constBegin(); t != byType.constEnd(); ++t)
+                cache.upsertSchemaEntries(schema, toCache::cacheEntryTypeToString((toCache::CacheEntryType) t.key()), t.value());
+        }
+
+        QWriteLocker lock(&cache.cacheLock);
+        cache.m_highWaterMark = highWaterMark;
+    }
+    catch (toConnection::exception const &exc)
+    {
+        // Keep what we have, next refresh will try again
+        TLOG(2, toDecorator, __HERE__) << exc << std::endl;
+        return true;
+    }
+    catch (QString const &exc)
+    {
+        TLOG(2, toDecorator, __HERE__) << exc << std::endl;
+        return true;
+    }
+
+    TLOG(2, toDecorator, __HERE__) << "Cache delta refresh: " << modified << " objects modified, "
+                                   << reread.size() << " schemas re-read in " << time.elapsed() << "ms" << std::endl;
+    return true;
+}
+
+/** A unit of parallel cache population: whole schema, or one object type of a large schema */
+struct toCachePartition
+{
+    QString schema;
+    QString type; // empty for whole schema
+    int count;    // objects in schema, used to schedule large partitions first
+};
+
+static bool partitionGreater(toCachePartition const& p1, toCachePartition const& p2)
+{
+    return p1.count > p2.count;
+}
+
+/** Schemas having more objects are split by object type */
+static const int PARTITION_OBJECTS = 20000;
+
+/** Queue of partitions shared by toCacheLoaderTask(s), see toCacheWorker::readParallel */
+class toCacheLoader
+{
+    public:
+        toCacheLoader(toConnection &conn)
+            : connection(conn)
+            , m_total(0)
+            , m_done(0)
+            , m_failed(false)
+        {}
+
+        void setPartitions(QList<toCachePartition> const& partitions)
+        {
+            m_partitions = partitions;
+            m_total = partitions.size();
+        }
+
+        bool take(toCachePartition &p)
+        {
+            QMutexLocker lock(&m_mutex);
+            if (m_partitions.isEmpty() || m_failed || connection.Abort)
+                return false;
+            p = m_partitions.takeFirst();
+            return true;
+        }
+
+        void done(toCachePartition const& p, QString const& highWaterMark, int ms)
+        {
+            QMutexLocker lock(&m_mutex);
+            m_done++;
+            if (highWaterMark > m_highWaterMark)
+                m_highWaterMark = highWaterMark;
+            QString name = p.type.isEmpty() ? p.schema : p.schema + ' ' + p.type;
+            connection.getCache().setCacheProgress(QString("%1/%2 %3").arg(m_done).arg(m_total).arg(name));
+            TLOG(2, toDecorator, __HERE__) << "Cache partition " << name << " read in " << ms << "ms" << std::endl;
+        }
+
+        void failed(QString const& msg)
+        {
+            QMutexLocker lock(&m_mutex);
+            m_failed = true;
+            TLOG(2, toDecorator, __HERE__) << msg << std::endl;
+        }
+
+        bool hasFailed()
+        {
+            QMutexLocker lock(&m_mutex);
+            return m_failed;
+        }
+
+        QString highWaterMark()
+        {
+            QMutexLocker lock(&m_mutex);
+            return m_highWaterMark;
+        }
+
+        toConnection &connection;
+        QString schemaSQL, typeSQL, columnsSQL;
+        QString describeSchema; // schema whose columns are described in batch
+    private:
+        QMutex m_mutex;
+        QList<toCachePartition> m_partitions;
+        QString m_highWaterMark;
+        int m_total, m_done;
+        bool m_failed;
+};
+
+/** Reads partitions using its own connection loan until the queue is empty */
+class toCacheLoaderTask : public QRunnable
+{
+    public:
+        toCacheLoaderTask(toCacheLoader &loader) : m_loader(loader) {}
+
+        void run() override
+        {
+            try
+            {
+                toConnectionSubLoan conn(m_loader.connection);
+                toCachePartition p;
+                while (m_loader.take(p))
+                    load(conn, p);
+            }
+            catch (toConnection::exception const &exc)
+            {
+                m_loader.failed(exc);
+            }
+            catch (QString const &exc)
+            {
+                m_loader.failed(exc);
+            }
+        }
+
+    private:
+        void load(toConnectionSubLoan &conn, toCachePartition const& p)
+        {
+            QTime time;
+            time.start();
+            toQueryParams params;
+            params << p.schema;
+            if (!p.type.isEmpty())
+                params << p.type;
+
+            QList<toCache::CacheEntry*> rows;
+            toCacheEntriesGuard guard(rows);
+            QString highWaterMark;
+            {
+                toQuery objects(conn, p.type.isEmpty() ? m_loader.schemaSQL : m_loader.typeSQL, params);
+                bool hasDDLTime = objects.columns() >= 5;
+                while (!objects.eof())
+                {
+                    if (m_loader.connection.Abort)
+                        return;
+                    QString owner = (QString)objects.readValue();
+                    QString name = (QString)objects.readValue();
+                    QString type = (QString)objects.readValue();
+                    QString comment = (QString)objects.readValue();
+                    if (hasDDLTime)
+                    {
+                        QString ddlTime = (QString)objects.readValue();
+                        if (ddlTime > highWaterMark)
+                            highWaterMark = ddlTime;
+                    }
+                    toCache::CacheEntry *e = toCache::createCacheEntry(owner, name, type, comment);
+                    if (e)
+                        rows.append(e);
+                }
+            }
+
+            if (p.schema == m_loader.describeSchema && !m_loader.columnsSQL.isEmpty()
+                    && (p.type.isEmpty() || p.type == "TABLE" || p.type == "VIEW"))
+                describeColumns(conn, p.schema, rows);
+
+            m_loader.connection.getCache().upsertEntries(rows);
+            rows.clear();
+            m_loader.done(p, highWaterMark, time.elapsed());
+        }
+
+        /** Describe columns of all tables and views in rows by one query, instead of toCache::describeEntry for each one */
+        void describeColumns(toConnectionSubLoan &conn, QString const& schema, QList<toCache::CacheEntry*> &rows)
+        {
+            QHash<QString, toCache::CacheEntry*> tables;
+            Q_FOREACH(toCache::CacheEntry *e, rows)
+            {
+                if (e->type == toCache::TABLE || e->type == toCache::VIEW)
+                    tables.insert(e->name.second, e);
+            }
+            if (tables.isEmpty())
+                return;
+
+            QHash<QString, toQColumnDescriptionList> columns;
+            toQuery query(conn, m_loader.columnsSQL, toQueryParams() << schema);
+            while (!query.eof())
+            {
+                QString table = (QString)query.readValue();
+                toCache::ColumnDescription c;
+                c.Name = (QString)query.readValue();
+                QString type = (QString)query.readValue();
+                QString length = (QString)query.readValue();
+                QString precision = (QString)query.readValue();
+                QString scale = (QString)query.readValue();
+                QString charLength = (QString)query.readValue();
+                QString charUsed = (QString)query.readValue();
+                c.Datatype = columnType(type, length, precision, scale, charLength, charUsed);
+                c.Null = (QString)query.readValue() == "Y";
+                c.Comment = (QString)query.readValue();
+                c.AlignRight = false;
+                c.ToolTip = c.Datatype + (c.Null ? QString() : QString(" NOT NULL"));
+                if (tables.contains(table))
+                    columns[table].append(c);
+            }
+
+            for (QHash<QString, toCache::CacheEntry*>::iterator i = tables.begin(); i != tables.end(); ++i)
+            {
+                toCache::CacheEntry *e = i.value();
+                toQColumnDescriptionList const& cols = columns[i.key()];
+                QString tip = e->name.toString();
+                Q_FOREACH(toCache::ColumnDescription const& c, cols)
+                {
+                    tip += '\n' + c.Name + ' ' + c.ToolTip;
+                }
+                e->description.insert("TOOLTIP", tip);
+                e->description.insert("COLUMNLIST", QVariant::fromValue(cols));
+                e->described = true;
+            }
+        }
+
+        /** Full type of a column as in all_tab_columns, formatted the way trotl::DescribeColumn::typeName does */
+        static QString columnType(QString const& type, QString const& length, QString const& precision,
+                                  QString const& scale, QString const& charLength, QString const& charUsed)
+        {
+            if (type == "CHAR" || type == "NCHAR" || type == "VARCHAR2" || type == "NVARCHAR2")
+            {
+                bool chars = charUsed == "C";
+                return QString("%1(%2 %3)").arg(type).arg(chars ? charLength : length).arg(chars ? "CHAR" : "BYTES");
+            }
+            if (type == "RAW")
+                return QString("RAW(%1)").arg(length);
+            if (type == "NUMBER")
+            {
+                if (precision.isEmpty())
+                {
+                    if (scale.isEmpty())
+                        return type;
+                    return scale == "0" ? QString("INTEGER") : QString("NUMBER(*,%1)").arg(scale);
+                }
+                if (scale.isEmpty() || scale == "0")
+                    return QString("NUMBER(%1)").arg(precision);
+                return QString("NUMBER(%1,%2)").arg(precision).arg(scale);
+            }
+            if (type == "FLOAT")
+            {
+                if (precision == "126")
+                    return type;
+                if (precision == "63")
+                    return QString("REAL");
+                return QString("FLOAT(%1)").arg(precision);
+            }
+            return type;
+        }
+
+        toCacheLoader &m_loader;
+};
+
+bool toCacheWorker::readParallel()
+{
+    toCache &cache = parentConnection().getCache();
+    int threads = qMin(toConfigurationNewSingle::Instance().option(ToConfiguration::Database::CachedConnectionsInt).toInt()
+                       , QThread::idealThreadCount());
+    if (threads < 2)
+        return false;
+
+    toCacheLoader loader(parentConnection());
+    QString countSQL;
+    try
+    {
+        countSQL = toSQL::sql("toConnection:CountObjectsBySchema", parentConnection());
+        loader.schemaSQL = toSQL::sql("toConnection:ListObjectsInSchema", parentConnection());
+        loader.typeSQL = toSQL::sql("toConnection:ListObjectsInSchemaByType", parentConnection());
+    }
+    catch (QString const &exc)
+    {
+        // Not supported by this provider
+        return false;
+    }
+    try
+    {
+        loader.columnsSQL = toSQL::sql("toCache:ListColumnsInSchema", parentConnection());
+        loader.describeSchema = parentConnection().defaultSchema();
+    }
+    catch (QString const &exc)
+    {
+        // Columns are described by toCache::describeEntry only
+    }
+
+    QList<toCachePartition> partitions;
+    try
+    {
+        toConnectionSubLoan conn(parentConnection());
+        toQuery counts(conn, countSQL, toQueryParams());
+        while (!counts.eof())
+        {
+            toCachePartition p;
+            p.schema = (QString)counts.readValue();
+            p.count = counts.readValue().toInt();
+            if (p.count <= PARTITION_OBJECTS)
+            {
+                partitions.append(p);
+                continue;
+            }
+            for (int t = toCache::TABLE; t <= toCache::TRIGGER; t++)
+            {
+                p.type = toCache::cacheEntryTypeToString((toCache::CacheEntryType) t);
+                partitions.append(p);
+            }
+        }
+    }
+    catch (toConnection::exception const &exc)
+    {
+        TLOG(2, toDecorator, __HERE__) << exc << std::endl;
+        return false;
+    }
+    catch (QString const &exc)
+    {
+        TLOG(2, toDecorator, __HERE__) << exc << std::endl;
+        return false;
+    }
+
+    threads = qMin(threads, partitions.size());
+    if (threads < 2)
+        return false;
+
+    // Largest partitions first, so that all the connections are busy till the end
+    std::stable_sort(partitions.begin(), partitions.end(), partitionGreater);
+    loader.setPartitions(partitions);
+
+    QTime time;
+    time.start();
+    {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        for (int i = 0; i < threads; i++)
+            pool.start(new toCacheLoaderTask(loader));
+        pool.waitForDone();
+    }
+    cache.setCacheProgress(QString());
+    TLOG(2, toDecorator, __HERE__) << "Cache read: " << partitions.size() << " partitions on "
+                                   << threads << " connections in " << time.elapsed() << "ms" << std::endl;
+
+    if (parentConnection().Abort || loader.hasFailed())
+    {
+        cache.setCacheState(toCache::FAILED);
+        return true;
+    }
+
+    {
+        QWriteLocker lock(&cache.cacheLock);
+        cache.m_highWaterMark = loader.highWaterMark();
+    }
+    cache.ownersRead = true;
+    cache.setCacheState(toCache::DONE);
+    return true;
+}
 
 QString toCache::ObjectRef::toString() const
 {
@@ -138,11 +660,11 @@ toCache::toCache(toConnection &parentConnection, QString const &description)
     , refCount(1) // we assume that we were created from 1st toConnection
     , m_threadWorker(new QThread(this))
     , m_cacheWorker(new toCacheWorker(parentConn))
-    , m_trie(new QmlJS::PersistentTrie::Trie())
 {
     m_threadWorker->setObjectName("toCacheWorker thread");
     m_cacheWorker->moveToThread(m_threadWorker);
     connect(this, SIGNAL(refreshCache()), m_cacheWorker, SLOT(process()));
+    connect(this, SIGNAL(refreshCacheDelta()), m_cacheWorker, SLOT(processDelta()));
 }
 
 toCache::~toCache()
@@ -221,30 +743,44 @@ toCache::CacheEntry const* toCache::findEntry(toCache::ObjectRef const& o) const
         // Object owner was not specified - try to use objects "context" (default schema)
         ObjectRef objRef1(o);
         objRef1.first = o.context;
-        toCache::CacheEntry const* retval = entryMap.value(objRef1, NULL);
+        toCache::CacheEntry const* retval = lookupEntry(objRef1);
         if (retval)
             return retval;
 
         toConnectionSubLoan conn(parentConn);
         ObjectRef objRef2 = conn->resolve(o);
-        return entryMap.value(objRef2, NULL);
+        return lookupEntry(objRef2);
     }
-    return entryMap.value(o, NULL);
+    return lookupEntry(o);
 }
 
 QStringList toCache::completeEntry(QString const& schema, QString const& object) const
 {
-    using namespace QmlJS::PersistentTrie;
-    auto i(m_schemaTrie.find(schema));
-    if (i != m_schemaTrie.end())
+    QReadLocker lock(&cacheLock);
+    if (m_image)
     {
-    	QStringList retvalSchema = m_schemaTrie.value(schema).complete(object, schema + '.', LookupFlags(CaseInsensitive));
-    	//QStringList retvalPublic = m_schemaTrie.value("PUBLIC").complete(object, "PUBLIC.", LookupFlags(CaseInsensitive));
-    	if(retvalSchema.size() < 200) retvalSchema.sort();
-    	//if(retvalPublic.size() < 800) retvalPublic.sort();
-    	//retvalSchema.append(retvalPublic);
-    	return retvalSchema;
+        // Names from the disk image are added to the schema index on the first completion in the schema
+        QMutexLocker iLock(&m_imageLock);
+        if (m_image && !m_imageIndexLoaded.contains(schema))
+        {
+            QStringList names;
+            QPair<int, int> range = m_image->schemaRange(schema);
+            for (int i = range.first; i < range.second; i++)
+            {
+                CacheEntryType type = m_image->type(i);
+                if (type == TABLE || type == VIEW || type == SYNONYM)
+                    names.append(m_image->name(i));
+            }
+            QMutexLocker cLock(&m_completionLock);
+            m_schemaIndex[schema].insert(names);
+            m_imageIndexLoaded.insert(schema);
+        }
     }
+
+    QMutexLocker cLock(&m_completionLock);
+    QMap<QString, toCompletionIndex>::const_iterator i = m_schemaIndex.constFind(schema);
+    if (i != m_schemaIndex.constEnd())
+        return i->complete(object, schema + '.');
     return QStringList();
 }
 
@@ -260,6 +796,21 @@ QList<toCache::CacheEntry const*> toCache::getEntriesInSchema(QString const& sch
         if ((entryMap.value(o)->type == type || type == toCache::ANY) && o.first == schemaU)
             retval.append(entryMap.value(o));
     }
+
+    if (m_image)
+    {
+        QPair<int, int> range = m_image->schemaRange(schemaU);
+        for (int i = range.first; i < range.second; i++)
+        {
+            if (type != toCache::ANY && m_image->type(i) != type)
+                continue;
+            if (entryMap.contains(ObjectRef(schemaU, m_image->name(i), schemaU)))
+                continue;
+            CacheEntry const* e = imageEntry(i);
+            if (e)
+                retval.append(e);
+        }
+    }
     return retval;
 }
 
@@ -276,7 +827,8 @@ QList<toCache::CacheEntry const*> toCache::getEntriesInSchema(QString const& sch
 bool toCache::entryExists(ObjectRef const&e, toCache::CacheEntryType entryType) const
 {
     QReadLocker lock(&cacheLock);
-    if (entryMap.contains(e)&& (entryType == ANY || entryMap.value(e)->type == entryType))
+    CacheEntry const* entry = lookupEntry(e);
+    if (entry && (entryType == ANY || entry->type == entryType))
         return true;
     return false;
 }
@@ -284,7 +836,19 @@ bool toCache::entryExists(ObjectRef const&e, toCache::CacheEntryType entryType)
 QList<toCache::CacheEntry const*> toCache::entries(bool wait) const
 {
     QReadLocker lock(&cacheLock);
-    return entryMap.values();
+    QList<CacheEntry const*> retval = entryMap.values();
+    if (m_image)
+    {
+        for (int i = 0; i < m_image->size(); i++)
+        {
+            if (entryMap.contains(ObjectRef(m_image->owner(i), m_image->name(i), QString())))
+                continue;
+            CacheEntry const* e = imageEntry(i);
+            if (e)
+                retval.append(e);
+        }
+    }
+    return retval;
 }
 
 bool toCache::userListExists(UserListType listType) const
@@ -323,6 +887,10 @@ toCache::CacheEntry const* toCache::describeEntry(toCache::CacheEntry const*e)
 
     toCache::CacheEntry *entry = const_cast<toCache::CacheEntry*>(e);
 
+    // Already described, see toCacheWorker::describeColumns
+    if (entry->described)
+        return entry;
+
     try
     {
         QWriteLocker lock(&cacheLock);
@@ -345,6 +913,20 @@ toCache::CacheEntry const* toCache::describeEntry(toCache::CacheEntry const*e)
 void toCache::upsertEntry(toCache::CacheEntry* e)
 {
     QWriteLocker lock(&cacheLock);
+    upsertEntryLocked(e);
+}
+
+void toCache::upsertEntries(QList<CacheEntry*> const& entries)
+{
+    QWriteLocker lock(&cacheLock);
+    Q_FOREACH(CacheEntry * e, entries)
+    {
+        upsertEntryLocked(e);
+    }
+}
+
+void toCache::upsertEntryLocked(toCache::CacheEntry* e)
+{
     switch (e->type)
     {
         case SYNONYM:
@@ -352,12 +934,7 @@ void toCache::upsertEntry(toCache::CacheEntry* e)
             // no break
         case TABLE:
         case VIEW:
-            m_trie->insert(e->name.second);
-            {
-            	if(!m_schemaTrie.contains(e->name.first))
-            		m_schemaTrie.insert(e->name.first, QmlJS::PersistentTrie::Trie());
-                m_schemaTrie[e->name.first].insert(e->name.second);
-            }
+            m_schemaIndex[e->name.first].insert(e->name.second);
             // no break
         case PROCEDURE:
         case FUNCTION:
@@ -416,6 +993,10 @@ void toCache::upsertSchemaEntries(QString const& schema, QString const& objType,
     if (type == ANY)
         throw QString("toCache: Unsupported object type ANY");
 
+    // Hide the schema content loaded from disk
+    if (m_image)
+        m_imageShadow.insert(qMakePair(schema, (int) type));
+
     // Clear whole schema
     QList<ObjectRef> objs = entryMap.keys(); // TODO there must be a better way of deleting from QMap
     Q_FOREACH(ObjectRef const & o, objs)
@@ -577,6 +1158,34 @@ void toCache::readCache()
     toGlobalEventSingle::Instance().checkCaching();
 }
 
+void toCache::updateCache()
+{
+    if (toConfigurationNewSingle::Instance().option(ToConfiguration::Database::ObjectCacheInt).toInt() == NEVER)
+        return;
+
+    if (cacheRefreshRunning())
+        return;
+
+    {
+        QReadLocker lock(&cacheLock);
+        if (state != DONE || m_highWaterMark.isEmpty())
+        {
+            lock.unlock();
+            readCache();
+            return;
+        }
+    }
+
+    setCacheState(toCache::READING_STARTED);
+    {
+        QMutexLocker bLock(&backgroundThreadLock);
+        if (!m_threadWorker->isRunning())
+            m_threadWorker->start();
+        emit refreshCacheDelta();
+    }
+    toGlobalEventSingle::Instance().checkCaching();
+}
+
 void toCache::wait4BGThread()
 {
     CacheState s = cacheState();
@@ -650,45 +1259,55 @@ void toCache::writeDiskCache()
     if (!dir.exists())
         dir.mkdir(dir.absolutePath());
 
-    QString version = QString::fromLatin1(TORAVERSION);
-
-    QFile file(fileInfo.absoluteFilePath());
-//TODO #warn "throw something here"
-    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
-        return;
-
     {
-        QReadLocker lock(&cacheLock);
-
-        QDataStream out(&file);
-        out << (quint8) 0;
-        out << version; // Tora version
-        out << (quint8) state; // cache state
-        out << ownersRead;
-        out << usersRead;
-        out << ConnectionDescription;
-        file.flush();
+        QWriteLocker lock(&cacheLock);
 
-        out << (quint32) usersMap.size();
-        out << (quint32) entryMap.size();
+        // Nothing was read from DB since the image was loaded, the file is up to date
+        if (m_image && entryMap.isEmpty() && m_imageShadow.isEmpty())
+            return;
 
-        QList<CacheEntry const*> vUsersMap = usersMap.values();
-        Q_FOREACH(CacheEntry const*e, vUsersMap)
+        // The image is replaced by QSaveFile::commit, a mapped file can not be replaced on Windows.
+        // Materialize all its entries and unmap it first
+        if (m_image)
         {
-            out << (*e);
+            for (int i = 0; i < m_image->size(); i++)
+            {
+                if (!entryMap.contains(ObjectRef(m_image->owner(i), m_image->name(i), QString())))
+                    imageEntry(i);
+            }
+            releaseImageLocked();
         }
 
-        QList<CacheEntry const*> vEntryMap = entryMap.values();
-        Q_FOREACH(CacheEntry const*e, vEntryMap)
-        {
-            out << (*e);
-        }
+//TODO #warn "throw something here"
+        bool written = toCacheImage::write(fileInfo.absoluteFilePath()
+                                           , ConnectionDescription
+                                           , m_highWaterMark
+                                           , ownersRead
+                                           , usersRead
+                                           , entryMap.values()
+                                           , usersMap.keys()
+                                           , ownersMap.keys());
+
+        // entryMap holds all the entries now and takes precedence, the image only has to be valid again
+        if (written)
+            m_image = toCacheImage::open(fileInfo.absoluteFilePath());
+    }
+}
 
-        file.seek(0L);
-        out << (quint8) 1;
-        file.flush();
-        file.close();
+void toCache::releaseImageLocked()
+{
+    QMutexLocker iLock(&m_imageLock);
+    Q_FOREACH(CacheEntry const * e, m_imageEntries)
+    {
+        // Entries read from DB since the image was loaded override it, shadowed ones were dropped
+        if (entryMap.contains(e->name) || m_imageShadow.contains(qMakePair(e->name.first, (int) e->type)))
+            delete e;
+        else
+            upsertEntryLocked(const_cast<CacheEntry*>(e));
     }
+    m_imageEntries.clear();
+    m_imageShadow.clear();
+    m_image.clear();
 }
 
 bool toCache::loadDiskCache()
@@ -710,67 +1329,35 @@ bool toCache::loadDiskCache()
     if (fileInfo.lastModified().addDays(toConfigurationNewSingle::Instance().option(ToConfiguration::Database::CacheTimeout).toInt()) < today)
         return false;
 
-    clearCache();
-
-//#warn TODO "throw something here
-    quint32 usersMapSize, entryMapSize;
-    QFile file(fileInfo.absoluteFilePath());
-    file.open(QIODevice::ReadOnly);
-
-    quint8 s1, s2;
-    bool oRead, uRead;
-    QString version;
+    // Assume the cache file is corrupted (or written by other TOra version) if it can not be mapped
+    QSharedPointer<toCacheImage> image = toCacheImage::open(fileInfo.absoluteFilePath());
+    if (!image)
+    {
+        QFile::remove(fileInfo.absoluteFilePath());
+        return false;
+    }
 
-    QDataStream in(&file);
     {
         QWriteLocker lock(&cacheLock);
+        clearCache();
+        m_image = image;
 
-        in >> s1;
-        in >> version; // Tora version
-        in >> s2; // cache state
-        in >> oRead;
-        in >> uRead;
-        in >> ConnectionDescription;
-
-        // Assume the cache file is corrupted if
-        // - 1st byte != 0x01 -- see writeDistCache() for details
-        // - application version differs
-        // - cache state != toCache::DONE
-        if (s1 != 1 || version != QString::fromLatin1(TORAVERSION)
-                || s2 != toCache::DONE)
+        // Only user lists are loaded eagerly, objects are materialized on demand
+        Q_FOREACH(QString const& user, image->users())
         {
-            file.close();
-            file.remove();
-            return false;
+            usersMap.insert(user, new toCacheEntryUser(user));
         }
-
-        in >> usersMapSize;
-        in >> entryMapSize;
-    }
-
-    for (quint32 i = 0; i < usersMapSize; i++)
-    {
-        CacheEntry e, *cloned;
-        in >> e;
-        cloned = cloneCacheEntry(e);
-        if (cloned != NULL)
-            upsertEntry(cloned);
-    }
-
-    for (quint32 i = 0; i < entryMapSize; i++)
-    {
-        CacheEntry e, *cloned;
-        in >> e;
-        cloned = cloneCacheEntry(e);
-        if (cloned != NULL)
-            upsertEntry(cloned);
+        Q_FOREACH(QString const& owner, image->owners())
+        {
+            if (!usersMap.contains(owner))
+                usersMap.insert(owner, new toCacheEntryUser(owner));
+            ownersMap.insert(owner, usersMap.value(owner));
+        }
+        usersRead = image->usersRead();
+        ownersRead = image->ownersRead();
+        m_highWaterMark = image->highWaterMark();
     }
-
-    state = (CacheState) s2;
-    usersRead = uRead;
-    ownersRead = oRead;
-
-    file.close();
+    emit userListRefreshed();
     return true;
 }
 
@@ -797,8 +1384,98 @@ void toCache::clearCache()
     ownersMap.clear();
     usersMap.clear();
 
-    m_trie = QSharedPointer<QmlJS::PersistentTrie::Trie>(new QmlJS::PersistentTrie::Trie());
-    m_schemaTrie.clear();
+    m_schemaIndex.clear();
+
+    QMutexLocker iLock(&m_imageLock);
+    Q_FOREACH(CacheEntry const * e, m_imageEntries)
+    {
+        delete e;
+    }
+    m_imageEntries.clear();
+    m_imageIndexLoaded.clear();
+    m_imageShadow.clear();
+    m_image.clear();
+    m_highWaterMark.clear();
+}
+
+static inline bool countedType(int type)
+{
+    return type >= toCache::TABLE && type <= toCache::TRIGGER;
+}
+
+QStringList toCache::staleSchemas(QMap<QString, int> const& cached, QMap<QString, int> const& current)
+{
+    QStringList retval;
+    for (QMap<QString, int>::const_iterator i = current.constBegin(); i != current.constEnd(); ++i)
+    {
+        if (cached.value(i.key(), 0) != i.value())
+            retval << i.key();
+    }
+    // Schemas which are not visible anymore
+    for (QMap<QString, int>::const_iterator i = cached.constBegin(); i != cached.constEnd(); ++i)
+    {
+        if (i.value() > 0 && !current.contains(i.key()))
+            retval << i.key();
+    }
+    return retval;
+}
+
+QMap<QString, int> toCache::objectCounts() const
+{
+    QReadLocker lock(&cacheLock);
+    QMap<QString, int> retval;
+    for (QMap<ObjectRef, CacheEntry const*>::const_iterator i = entryMap.constBegin(); i != entryMap.constEnd(); ++i)
+    {
+        if (!countedType(i.value()->type))
+            continue;
+        retval[i.key().first]++;
+
+        // Entry overrides an image entry counted below
+        if (m_image)
+        {
+            int idx = m_image->find(i.key().first, i.key().second);
+            if (idx >= 0 && countedType(m_image->type(idx)) && !m_imageShadow.contains(qMakePair(i.key().first, (int) m_image->type(idx))))
+                retval[i.key().first]--;
+        }
+    }
+
+    if (m_image)
+    {
+        QHash<QPair<QString, int>, int> counts = m_image->typeCounts();
+        for (QHash<QPair<QString, int>, int>::const_iterator i = counts.constBegin(); i != counts.constEnd(); ++i)
+        {
+            if (countedType(i.key().second) && !m_imageShadow.contains(i.key()))
+                retval[i.key().first] += i.value();
+        }
+    }
+    return retval;
+}
+
+toCache::CacheEntry const* toCache::lookupEntry(ObjectRef const& o) const
+{
+    CacheEntry const* retval = entryMap.value(o, NULL);
+    if (retval == NULL && m_image)
+    {
+        int i = m_image->find(o.first, o.second);
+        if (i >= 0)
+            retval = imageEntry(i);
+    }
+    return retval;
+}
+
+toCache::CacheEntry const* toCache::imageEntry(int index) const
+{
+    if (!m_imageShadow.isEmpty() && m_imageShadow.contains(qMakePair(m_image->owner(index), (int) m_image->type(index))))
+        return NULL;
+
+    QMutexLocker iLock(&m_imageLock);
+    QHash<int, CacheEntry const*>::const_iterator i = m_imageEntries.constFind(index);
+    if (i != m_imageEntries.constEnd())
+        return i.value();
+
+    CacheEntry const* retval = m_image->entry(index);
+    m_imageEntries.insert(index, retval);
+    return retval;
 }
 ;
 
@@ -872,6 +1549,18 @@ bool toCache::cacheRefreshRunning() const
     return cacheState() & ( READING_STARTED | READING_FROM_DISK | READING_FROM_DB);
 }
 
+QString toCache::cacheProgress() const
+{
+    QReadLocker lock(&cacheLock);
+    return m_progress;
+}
+
+void toCache::setCacheProgress(QString const& progress)
+{
+    QWriteLocker lock(&cacheLock);
+    m_progress = progress;
+}
+
 toCache::CacheEntry::CacheEntry(const QString &owner, const QString &objName,
                                 const QString &objType, const QString &objComment) :
     name(ObjectRef(owner, objName, owner)), type(cacheEntryType(objType)), comment(
@@ -912,36 +1601,6 @@ bool toCache::CacheEntry::operator ==(const toCache::CacheEntry &other) const
 }
 ;
 
-QDataStream& operator<<(QDataStream& stream, const toCache::ObjectRef& o)
-{
-    stream << o.first << o.second;
-    return stream;
-}
-
-QDataStream& operator>>(QDataStream& stream, toCache::ObjectRef& o)
-{
-    stream >> o.first >> o.second;
-    return stream;
-}
-
-QDataStream& operator<<(QDataStream& stream, const toCache::CacheEntry& e)
-{
-    stream << e.name << (quint8) e.type << e.comment << e.timestamp
-           << e.details;
-    return stream;
-}
-
-QDataStream& operator>>(QDataStream& stream, toCache::CacheEntry& e)
-{
-    quint8 type;
-
-    stream >> e.name >> type >> e.comment >> e.timestamp >> e.details;
-
-    e.type = (toCache::CacheEntryType) type;
-    e.described = false;
-    return stream;
-}
-
 toCacheEntryTable::toCacheEntryTable(const QString &owner, const QString &name,
                                      const QString &comment) :
     toCache::CacheEntry(owner, name, toCache::TABLE, comment)
@@ -46,12 +46,14 @@
 #include <QtCore/QSet>
 #include <QtCore/QPointer>
 #include <QtCore/QMap>
+#include <QtCore/QHash>
 #include <QtCore/QVariant>
 #include <QtCore/QString>
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
 
-#include "persistenttrie.h"
+#include "core/tocompletionindex.h"
 //#include <map>
 
 class QThread;
@@ -73,8 +75,8 @@ class toCacheEntryTrigger;
 class toGlobalSetting;
 
 class toResultModel;
+class toCacheImage;
 
-class QDataStream;
 class QFileInfo;
 class QDir;
 
@@ -101,7 +103,24 @@ class toCacheWorker: public QObject
     public slots:
         virtual void process(void);
 
+        /** Apply objects changed in DB since the last refresh, see toCache::updateCache */
+        void processDelta(void);
+
     private:
+        /** Read objects modified since cache's high-water mark and re-read schemas whose object count differs.
+         *  @return false if the provider does not support incremental refresh or there is no high-water mark
+         */
+        bool refreshDelta(void);
+
+        /** Read all the objects from DB (toConnection:ListObjectsInDatabase) */
+        void readAll(void);
+
+        /** Read all the objects from DB in parallel, one partition (schema or schema and object type) at a time
+         *  on each of up to CachedConnectionsInt connections.
+         *  @return false if the provider does not support it (no per schema SQL) or only one connection may be used
+         */
+        bool readParallel(void);
+
         toConnection &m_parentConnection;
 };
 
@@ -113,6 +132,7 @@ class TORA_EXPORT toCache : public QObject
         friend class toConnection;
         friend class toGlobalSetting;
         friend class toCacheWorker;
+        friend class toCacheLoader;
     public:
         /*** Nested types ***/
         enum ObjectCacheEnum
@@ -363,6 +383,9 @@ class TORA_EXPORT toCache : public QObject
         /** add/update new entry into cache */
         void upsertEntry(CacheEntry* e);
 
+        /** add/update a batch of entries, the cache is locked once */
+        void upsertEntries(QList<CacheEntry*> const& entries);
+
         /** add/update a list of objects in cache.
         * This should add any new object to the list as well as remove no longer
         * existing ones - within defined schema
@@ -388,6 +411,19 @@ class TORA_EXPORT toCache : public QObject
         */
         void rereadCache();
 
+        /** Incremental refresh, in a background thread.
+         * Reads only objects whose DDL time is newer than the newest one seen so far (high-water mark)
+         * and re-reads whole schemas whose object count differs from the cached one (drops).
+         * Falls back to @ref readCache if the provider has no "toConnection:ListModifiedObjects" SQL
+         * or the cache was not read yet.
+         */
+        void updateCache();
+
+        /** Schemas to be re-read by the incremental refresh: object count in DB (current) differs
+         *  from the cached one, or the schema has cached objects but is not listed in DB anymore
+         */
+        static QStringList staleSchemas(QMap<QString, int> const& cached, QMap<QString, int> const& current);
+
         /** translate object type name QString("TABLE") => CacheEntryType::TABLE */
         static CacheEntryType cacheEntryType(QString const& objTypeName);
 
@@ -402,6 +438,9 @@ class TORA_EXPORT toCache : public QObject
          */
         bool cacheRefreshRunning() const;
 
+        /** Human readable progress of the running refresh (partitions done), empty if not known */
+        QString cacheProgress() const;
+
     private:
 
         /** setter for cache state */
@@ -441,6 +480,25 @@ class TORA_EXPORT toCache : public QObject
         /** remove all the entries from all the maps, Note: caller should lock instance state first */
         void clearCache();
 
+        /** upsertEntry body, Note: caller should hold cacheLock for writing */
+        void upsertEntryLocked(CacheEntry* e);
+
+        void setCacheProgress(QString const&);
+
+        /** Number of cached objects (TABLE .. TRIGGER) per schema, used to detect drops */
+        QMap<QString, int> objectCounts() const;
+
+        /** Move the materialized entries of the disk image into entryMap and unmap the image.
+         *  Note: caller should hold cacheLock for writing */
+        void releaseImageLocked();
+
+        /** Lookup entryMap, fall back to the disk image. Note: caller should hold cacheLock */
+        CacheEntry const* lookupEntry(ObjectRef const&) const;
+
+        /** Materialize an entry of the disk image, returns NULL if its schema was re-read from DB since
+         *  Note: caller should hold cacheLock */
+        CacheEntry const* imageEntry(int index) const;
+
         /** This lock is used by all getters and setters
         an Instance of toCache is shared between multiple connections.
         */
@@ -462,12 +520,32 @@ class TORA_EXPORT toCache : public QObject
         QThread *m_threadWorker;
         toCacheWorker *m_cacheWorker;
 
-        QSharedPointer<QmlJS::PersistentTrie::Trie> m_trie;
-        QMap<QString,QmlJS::PersistentTrie::Trie> m_schemaTrie;
+        /** Completion index of tables, views and synonyms per schema. Guarded by cacheLock,
+         *  readers (completeEntry) also lock m_completionLock as lookups rebuild the index */
+        mutable QMap<QString, toCompletionIndex> m_schemaIndex;
+        mutable QMutex m_completionLock;
+
+        /** Disk cache mapped by loadDiskCache. Its entries are not copied into entryMap,
+         *  they are materialized on demand into m_imageEntries (guarded by m_imageLock).
+         *  entryMap takes precedence over the image.
+         */
+        QSharedPointer<toCacheImage> m_image;
+        mutable QMutex m_imageLock;
+        mutable QHash<int, CacheEntry const*> m_imageEntries;
+        mutable QSet<QString> m_imageIndexLoaded;
+        /** (schema, type) pairs re-read from DB, image entries of these are hidden */
+        QSet<QPair<QString, int> > m_imageShadow;
+
+        /** Newest DDL time of cached objects, as returned by DB, empty if not known. Guarded by cacheLock */
+        QString m_highWaterMark;
+
+        /** See cacheProgress. Guarded by cacheLock */
+        QString m_progress;
 
     signals:
         void userListRefreshed(void);
         void refreshCache();
+        void refreshCacheDelta();
 }; // toCache
 
 
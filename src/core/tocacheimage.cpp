@@ -0,0 +1,377 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/tocacheimage.h"
+#include "core/toraversion.h"
+
+#include <QtCore/QSaveFile>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+#include <QtCore/QByteArray>
+
+#include <string.h>
+
+static const char IMAGE_MAGIC[8] = { 'T', 'O', 'R', 'A', 'C', 'A', 'C', 'H' };
+static const quint32 IMAGE_BYTE_ORDER = 0x01020304;
+
+namespace
+{
+    /** Builds the image in memory, interns strings */
+    class toCacheImageWriter
+    {
+        public:
+            QByteArray data;
+
+            quint32 intern(QString const& str)
+            {
+                QHash<QString, quint32>::const_iterator i = m_ids.constFind(str);
+                if (i != m_ids.constEnd())
+                    return i.value();
+
+                quint32 id = m_offsets.size();
+                m_offsets.append(data.size());
+                quint32 len = str.size();
+                append(&len, sizeof(len));
+                append(str.constData(), len * sizeof(QChar));
+                align();
+                m_ids.insert(str, id);
+                return id;
+            }
+
+            quint32 append(void const* ptr, int len)
+            {
+                quint32 offset = data.size();
+                data.append((char const*)ptr, len);
+                return offset;
+            }
+
+            void align()
+            {
+                while (data.size() % 4)
+                    data.append('\0');
+            }
+
+            /** Write the string index, returns its offset */
+            quint32 appendIndex()
+            {
+                return append(m_offsets.constData(), m_offsets.size() * sizeof(quint32));
+            }
+
+            quint32 stringCount() const
+            {
+                return m_offsets.size();
+            }
+
+        private:
+            QHash<QString, quint32> m_ids;
+            QVector<quint32> m_offsets;
+    };
+}
+
+bool toCacheImage::write(QString const& filename
+                         , QString const& description
+                         , QString const& highWaterMark
+                         , bool ownersRead
+                         , bool usersRead
+                         , QList<toCache::CacheEntry const*> const& entries
+                         , QStringList const& users
+                         , QStringList const& owners)
+{
+    toCacheImageWriter w;
+    Header h;
+    memset(&h, 0, sizeof(h));
+    w.append(&h, sizeof(h));
+
+    memcpy(h.magic, IMAGE_MAGIC, sizeof(h.magic));
+    h.byteOrder = IMAGE_BYTE_ORDER;
+    h.formatVersion = FORMAT_VERSION;
+    h.toraVersion = w.intern(QString::fromLatin1(TORAVERSION));
+    h.description = w.intern(description);
+    h.highWaterMark = w.intern(highWaterMark);
+    h.ownersRead = ownersRead;
+    h.usersRead = usersRead;
+
+    QVector<Record> records;
+    records.reserve(entries.size());
+    Q_FOREACH(toCache::CacheEntry const* e, entries)
+    {
+        // Internal markers (TORA_SCHEMA_LIST) say the schema was read from DB in this session, do not persist them
+        if (e->type == toCache::TORA_SCHEMA_LIST)
+            continue;
+        Record r;
+        memset(&r, 0, sizeof(r));
+        r.owner = w.intern(e->name.first);
+        r.name = w.intern(e->name.second);
+        r.comment = w.intern(e->comment);
+        r.details = w.intern(e->details);
+        r.timestamp = e->timestamp.toJulianDay();
+        r.type = e->type;
+        records.append(r);
+    }
+
+    QVector<quint32> userIds, ownerIds;
+    Q_FOREACH(QString const& u, users)
+        userIds.append(w.intern(u));
+    Q_FOREACH(QString const& o, owners)
+        ownerIds.append(w.intern(o));
+
+    h.stringCount = w.stringCount();
+    h.stringIndex = w.appendIndex();
+    h.entryCount = records.size();
+    h.entryOffset = w.append(records.constData(), records.size() * sizeof(Record));
+    h.userCount = userIds.size();
+    h.userOffset = w.append(userIds.constData(), userIds.size() * sizeof(quint32));
+    h.ownerCount = ownerIds.size();
+    h.ownerOffset = w.append(ownerIds.constData(), ownerIds.size() * sizeof(quint32));
+    h.fileSize = w.data.size();
+    memcpy(w.data.data(), &h, sizeof(h));
+
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (file.write(w.data) != w.data.size())
+    {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+QSharedPointer<toCacheImage> toCacheImage::open(QString const& filename)
+{
+    QSharedPointer<toCacheImage> retval(new toCacheImage());
+    retval->m_file.setFileName(filename);
+    if (!retval->m_file.open(QIODevice::ReadOnly))
+        return QSharedPointer<toCacheImage>();
+
+    retval->m_size = retval->m_file.size();
+    if (retval->m_size < (qint64) sizeof(Header))
+        return QSharedPointer<toCacheImage>();
+
+    retval->m_data = retval->m_file.map(0, retval->m_size);
+    if (!retval->m_data)
+        return QSharedPointer<toCacheImage>();
+
+    Header const* h = retval->header();
+    quint64 size = retval->m_size;
+    if (memcmp(h->magic, IMAGE_MAGIC, sizeof(h->magic)) != 0
+            || h->byteOrder != IMAGE_BYTE_ORDER
+            || h->formatVersion != FORMAT_VERSION
+            || h->fileSize != size
+            || h->stringIndex + (quint64) h->stringCount * sizeof(quint32) > size
+            || h->entryOffset + (quint64) h->entryCount * sizeof(Record) > size
+            || h->userOffset + (quint64) h->userCount * sizeof(quint32) > size
+            || h->ownerOffset + (quint64) h->ownerCount * sizeof(quint32) > size
+            || h->entryOffset % 4 || h->stringIndex % 4)
+        return QSharedPointer<toCacheImage>();
+
+    if (retval->rawString(h->toraVersion) != QString::fromLatin1(TORAVERSION))
+        return QSharedPointer<toCacheImage>();
+
+    return retval;
+}
+
+toCacheImage::toCacheImage()
+    : m_data(NULL)
+    , m_size(0)
+{
+}
+
+toCacheImage::~toCacheImage()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar*>(m_data));
+    m_file.close();
+}
+
+int toCacheImage::size() const
+{
+    return header()->entryCount;
+}
+
+int toCacheImage::find(QString const& owner, QString const& name) const
+{
+    int lo = 0, hi = size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        Record const* r = record(mid);
+        QString o = rawString(r->owner);
+        if (o < owner || (o == owner && rawString(r->name) < name))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < size() && rawString(record(lo)->owner) == owner && rawString(record(lo)->name) == name)
+        return lo;
+    return -1;
+}
+
+QPair<int, int> toCacheImage::schemaRange(QString const& owner) const
+{
+    int lo = 0, hi = size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (rawString(record(mid)->owner) < owner)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    int first = lo;
+    hi = size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (rawString(record(mid)->owner) == owner)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return qMakePair(first, lo);
+}
+
+QHash<QPair<QString, int>, int> toCacheImage::typeCounts() const
+{
+    // Owners are interned, count by string id first
+    QHash<QPair<quint32, int>, int> counts;
+    for (int i = 0; i < size(); i++)
+    {
+        Record const* r = record(i);
+        counts[qMakePair(r->owner, (int) r->type)]++;
+    }
+
+    QHash<QPair<QString, int>, int> retval;
+    for (QHash<QPair<quint32, int>, int>::const_iterator i = counts.constBegin(); i != counts.constEnd(); ++i)
+        retval.insert(qMakePair(string(i.key().first), i.key().second), i.value());
+    return retval;
+}
+
+toCache::CacheEntry* toCacheImage::entry(int index) const
+{
+    Record const* r = record(index);
+    toCache::CacheEntry* retval = toCache::createCacheEntry(string(r->owner)
+                                  , string(r->name)
+                                  , (toCache::CacheEntryType) r->type
+                                  , string(r->comment));
+    if (retval)
+    {
+        retval->details = string(r->details);
+        retval->timestamp = QDate::fromJulianDay(r->timestamp);
+    }
+    return retval;
+}
+
+QString toCacheImage::owner(int index) const
+{
+    return string(record(index)->owner);
+}
+
+QString toCacheImage::name(int index) const
+{
+    return string(record(index)->name);
+}
+
+toCache::CacheEntryType toCacheImage::type(int index) const
+{
+    return (toCache::CacheEntryType) record(index)->type;
+}
+
+QStringList toCacheImage::users() const
+{
+    return stringList(header()->userOffset, header()->userCount);
+}
+
+QStringList toCacheImage::owners() const
+{
+    return stringList(header()->ownerOffset, header()->ownerCount);
+}
+
+QString toCacheImage::description() const
+{
+    return string(header()->description);
+}
+
+QString toCacheImage::highWaterMark() const
+{
+    return string(header()->highWaterMark);
+}
+
+bool toCacheImage::ownersRead() const
+{
+    return header()->ownersRead;
+}
+
+bool toCacheImage::usersRead() const
+{
+    return header()->usersRead;
+}
+
+toCacheImage::Header const* toCacheImage::header() const
+{
+    return (Header const*) m_data;
+}
+
+toCacheImage::Record const* toCacheImage::record(int index) const
+{
+    return ((Record const*)(m_data + header()->entryOffset)) + index;
+}
+
+QString toCacheImage::rawString(quint32 id) const
+{
+    if (id >= header()->stringCount)
+        return QString();
+    quint32 offset = ((quint32 const*)(m_data + header()->stringIndex))[id];
+    if (offset % 4 || offset + (quint64) sizeof(quint32) > (quint64) m_size)
+        return QString();
+    quint32 len = *(quint32 const*)(m_data + offset);
+    if (offset + sizeof(quint32) + (quint64) len * sizeof(QChar) > (quint64) m_size)
+        return QString();
+    return QString::fromRawData((QChar const*)(m_data + offset + sizeof(quint32)), len);
+}
+
+QString toCacheImage::string(quint32 id) const
+{
+    QString raw = rawString(id);
+    return QString(raw.constData(), raw.size());
+}
+
+QStringList toCacheImage::stringList(quint32 offset, quint32 count) const
+{
+    QStringList retval;
+    quint32 const* ids = (quint32 const*)(m_data + offset);
+    for (quint32 i = 0; i < count; i++)
+        retval.append(string(ids[i]));
+    return retval;
+}
@@ -0,0 +1,144 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tocache.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QPair>
+#include <QtCore/QHash>
+
+/** Memory mapped image of toCache content (the on-disk object cache).
+ *
+ * File layout (native byte order, all offsets are file offsets):
+ *  - Header (see below)
+ *  - string pool: interned strings, each as quint32 length followed by UTF-16 data, 4 bytes aligned
+ *  - string index: quint32 offset for each string id
+ *  - entries: fixed size Record for each object, sorted by (owner, name) as toCache::ObjectRef is
+ *  - users, owners: lists of string ids
+ *
+ * Opening an image only validates the header, nothing is parsed. Entries are looked up by binary search in place
+ * and copied out by @ref entry only when requested.
+ */
+class toCacheImage
+{
+    public:
+        /** Bump this whenever the layout changes, images of other versions are discarded */
+        static const quint32 FORMAT_VERSION = 2;
+
+        /** Write image of entries into filename (replaced atomically). entries must be sorted by ObjectRef */
+        static bool write(QString const& filename
+                          , QString const& description
+                          , QString const& highWaterMark
+                          , bool ownersRead
+                          , bool usersRead
+                          , QList<toCache::CacheEntry const*> const& entries
+                          , QStringList const& users
+                          , QStringList const& owners);
+
+        /** Map an image written by this TOra version, returns NULL if the file is missing or invalid */
+        static QSharedPointer<toCacheImage> open(QString const& filename);
+
+        ~toCacheImage();
+
+        /** Number of entries in the image */
+        int size() const;
+
+        /** Index of the entry, -1 if not present */
+        int find(QString const& owner, QString const& name) const;
+
+        /** Index range [first, second) of entries owned by owner */
+        QPair<int, int> schemaRange(QString const& owner) const;
+
+        /** Number of entries for each (owner, type) pair */
+        QHash<QPair<QString, int>, int> typeCounts() const;
+
+        /** Copy the entry out of the image, caller takes ownership */
+        toCache::CacheEntry* entry(int index) const;
+
+        QString owner(int index) const;
+        QString name(int index) const;
+        toCache::CacheEntryType type(int index) const;
+
+        QStringList users() const;
+        QStringList owners() const;
+        QString description() const;
+        /** Newest object modification time (provider specific string) seen when the cache was read from DB */
+        QString highWaterMark() const;
+        bool ownersRead() const;
+        bool usersRead() const;
+
+    private:
+        struct Header
+        {
+            char magic[8];
+            quint32 byteOrder;
+            quint32 formatVersion;
+            quint32 fileSize;
+            quint32 toraVersion; // string id
+            quint32 description; // string id
+            quint32 highWaterMark; // string id
+            quint8 ownersRead, usersRead, pad[2];
+            quint32 stringCount, stringIndex;
+            quint32 entryCount, entryOffset;
+            quint32 userCount, userOffset;
+            quint32 ownerCount, ownerOffset;
+        };
+
+        struct Record
+        {
+            quint32 owner, name, comment, details; // string ids
+            qint32 timestamp;                      // julian day
+            quint8 type, pad[3];
+        };
+
+        toCacheImage();
+
+        Header const* header() const;
+        Record const* record(int index) const;
+
+        /** Zero-copy view of a pooled string, valid while the image is mapped */
+        QString rawString(quint32 id) const;
+        /** Deep copy of a pooled string */
+        QString string(quint32 id) const;
+        QStringList stringList(quint32 offset, quint32 count) const;
+
+        QFile m_file;
+        uchar const* m_data;
+        qint64 m_size;
+};
@@ -0,0 +1,350 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/tocompletionindex.h"
+
+#include <QtCore/QPair>
+
+#include <algorithm>
+#include <string.h>
+
+// Max number of recursive steps of segment matching per name
+static const int SEGMENT_BUDGET = 64;
+
+static inline int compareChars(QChar const* a, int alen, QChar const* b, int blen)
+{
+    int n = qMin(alen, blen);
+    for (int i = 0; i < n; i++)
+    {
+        if (a[i] != b[i])
+            return a[i].unicode() < b[i].unicode() ? -1 : 1;
+    }
+    return alen - blen;
+}
+
+namespace
+{
+    struct toCompletionName
+    {
+        QString folded, original;
+
+        bool operator<(toCompletionName const& other) const
+        {
+            int c = compareChars(folded.constData(), folded.size(), other.folded.constData(), other.folded.size());
+            return c < 0 || (c == 0 && original < other.original);
+        }
+    };
+}
+
+toCompletionIndex::toCompletionIndex()
+{
+}
+
+void toCompletionIndex::insert(QString const& name)
+{
+    m_pending.append(name);
+}
+
+void toCompletionIndex::insert(QStringList const& names)
+{
+    m_pending.append(names);
+}
+
+void toCompletionIndex::build(QStringList const& names)
+{
+    clear();
+    m_pending = names;
+    rebuild();
+}
+
+void toCompletionIndex::clear()
+{
+    m_folded.clear();
+    m_original.clear();
+    m_items.clear();
+    m_pending.clear();
+}
+
+int toCompletionIndex::size() const
+{
+    rebuild();
+    return m_items.size();
+}
+
+bool toCompletionIndex::isEmpty() const
+{
+    return m_items.isEmpty() && m_pending.isEmpty();
+}
+
+void toCompletionIndex::rebuild() const
+{
+    if (m_pending.isEmpty())
+        return;
+
+    QVector<toCompletionName> names;
+    names.reserve(m_items.size() + m_pending.size());
+    Q_FOREACH(Item const& item, m_items)
+    {
+        toCompletionName n;
+        n.original = original(item);
+        n.folded = QString(m_folded.constData() + item.folded, item.length);
+        names.append(n);
+    }
+    Q_FOREACH(QString const& name, m_pending)
+    {
+        if (name.isEmpty() || name.size() > 0xffff)
+            continue;
+        toCompletionName n;
+        n.original = name;
+        n.folded = name.toCaseFolded();
+        names.append(n);
+    }
+    m_pending.clear();
+    std::sort(names.begin(), names.end());
+
+    m_items.clear();
+    m_items.reserve(names.size());
+    int foldedSize = 0, originalSize = 0;
+    Q_FOREACH(toCompletionName const& n, names)
+    {
+        foldedSize += n.folded.size();
+        originalSize += n.original.size();
+    }
+    m_folded.clear();
+    m_folded.reserve(foldedSize);
+    m_original.clear();
+    m_original.reserve(originalSize);
+
+    for (int i = 0; i < names.size(); i++)
+    {
+        toCompletionName const& n = names.at(i);
+        if (i > 0 && n.original == names.at(i - 1).original)
+            continue;
+
+        Item item;
+        item.folded = m_folded.size();
+        item.original = m_original.size();
+        item.length = n.folded.size();
+        item.originalLength = n.original.size();
+        item.chars = charMask(n.folded.constData(), n.folded.size());
+
+        // Segment starts: after separators, letter/digit boundaries, camelCase humps
+        item.segments = 1;
+        if (n.folded.size() == n.original.size())
+        {
+            QChar const* o = n.original.constData();
+            for (int j = 1; j < n.original.size() && j < 32; j++)
+            {
+                QChar p = o[j - 1], c = o[j];
+                if (!c.isLetterOrNumber())
+                    continue;
+                if (!p.isLetterOrNumber() || p.isDigit() != c.isDigit() || (p.isLower() && c.isUpper()))
+                    item.segments |= 1u << j;
+            }
+        }
+
+        m_folded.append(n.folded);
+        m_original.append(n.original);
+        m_items.append(item);
+    }
+}
+
+QString toCompletionIndex::original(Item const& item) const
+{
+    return QString(m_original.constData() + item.original, item.originalLength);
+}
+
+int toCompletionIndex::lowerBound(QChar const* text, int len) const
+{
+    QChar const* pool = m_folded.constData();
+    int lo = 0, hi = m_items.size();
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        Item const& item = m_items.at(mid);
+        if (compareChars(pool + item.folded, item.length, text, len) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+QStringList toCompletionIndex::complete(QString const& text, QString const& base, int flags, int limit) const
+{
+    rebuild();
+
+    QStringList retval;
+    QString query = text.toCaseFolded();
+    QChar const* q = query.constData();
+    int qlen = query.size();
+    QChar const* pool = m_folded.constData();
+
+    // Prefix matches, an exact match (if any) is the first one
+    int first = 0, last = 0;
+    if (flags & PrefixMatch)
+    {
+        first = last = lowerBound(q, qlen);
+        while (last < m_items.size()
+                && m_items.at(last).length >= qlen
+                && memcmp(pool + m_items.at(last).folded, q, qlen * sizeof(QChar)) == 0)
+        {
+            if (limit == 0 || retval.size() < limit)
+                retval.append(base + original(m_items.at(last)));
+            last++;
+        }
+    }
+
+    if (limit == 0 || retval.size() >= limit || qlen == 0 || (flags & (SegmentMatch | FuzzyMatch)) == 0)
+        return retval;
+
+    // Segment and fuzzy matches, ranked
+    quint64 mask = charMask(q, qlen);
+    QVector<QPair<int, int> > scored; // (-score, item)
+    for (int i = 0; i < m_items.size(); i++)
+    {
+        if (i >= first && i < last)
+            continue;
+        Item const& item = m_items.at(i);
+        if (item.length < qlen || (item.chars & mask) != mask)
+            continue;
+
+        int score = -1;
+        if (flags & SegmentMatch)
+            score = segmentScore(pool + item.folded, item.length, item.segments, q, qlen);
+        if (score < 0 && (flags & FuzzyMatch))
+            score = fuzzyScore(pool + item.folded, item.length, q, qlen);
+        if (score >= 0)
+            scored.append(qMakePair(-score, i));
+    }
+
+    int n = qMin(scored.size(), limit - retval.size());
+    std::partial_sort(scored.begin(), scored.begin() + n, scored.end());
+    for (int i = 0; i < n; i++)
+        retval.append(base + original(m_items.at(scored.at(i).second)));
+    return retval;
+}
+
+quint64 toCompletionIndex::charMask(QChar const* text, int len)
+{
+    quint64 retval = 0;
+    for (int i = 0; i < len; i++)
+    {
+        ushort c = text[i].unicode();
+        int bit;
+        if (c >= 'a' && c <= 'z')
+            bit = c - 'a';
+        else if (c >= '0' && c <= '9')
+            bit = 26 + c - '0';
+        else if (c == '_')
+            bit = 36;
+        else if (c == '$')
+            bit = 37;
+        else if (c == '#')
+            bit = 38;
+        else
+            bit = 39 + c % 25;
+        retval |= Q_UINT64_C(1) << bit;
+    }
+    return retval;
+}
+
+static bool segmentMatch(QChar const* name, int len, quint32 segments, QChar const* text, int textLen
+                         , int ni, int ti, int &jumps, int &budget)
+{
+    if (ti == textLen)
+        return true;
+    if (--budget < 0)
+        return false;
+
+    // Continue within the current segment
+    if (ni < len && name[ni] == text[ti] && segmentMatch(name, len, segments, text, textLen, ni + 1, ti + 1, jumps, budget))
+        return true;
+
+    // Jump to one of the following segments
+    for (int s = ni + 1; s < len && s < 32; s++)
+    {
+        if ((segments & (1u << s)) && name[s] == text[ti])
+        {
+            jumps++;
+            if (segmentMatch(name, len, segments, text, textLen, s + 1, ti + 1, jumps, budget))
+                return true;
+            jumps--;
+        }
+    }
+    return false;
+}
+
+int toCompletionIndex::segmentScore(QChar const* name, int len, quint32 segments, QChar const* text, int textLen)
+{
+    int budget = SEGMENT_BUDGET;
+    for (int s = 0; s < len && s < 32; s++)
+    {
+        if (!(segments & (1u << s)) || name[s] != text[0])
+            continue;
+        int jumps = 0;
+        if (segmentMatch(name, len, segments, text, textLen, s + 1, 1, jumps, budget))
+            return qMax(401, 600 - 10 * jumps - (s > 0 ? 50 : 0) - (len - textLen) / 4);
+        if (budget < 0)
+            break;
+    }
+    return -1;
+}
+
+int toCompletionIndex::fuzzyScore(QChar const* name, int len, QChar const* text, int textLen)
+{
+    int ti = 0, first = -1, runs = 0, gaps = 0;
+    bool inRun = false;
+    for (int ni = 0; ni < len && ti < textLen; ni++)
+    {
+        if (name[ni] == text[ti])
+        {
+            if (first < 0)
+                first = ni;
+            if (!inRun)
+                runs++;
+            inRun = true;
+            ti++;
+        }
+        else
+        {
+            inRun = false;
+            if (first >= 0)
+                gaps++;
+        }
+    }
+    if (ti < textLen)
+        return -1;
+    return qBound(1, 400 - 20 * (runs - 1) - gaps - 5 * first, 400);
+}
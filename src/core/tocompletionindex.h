@@ -0,0 +1,107 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+/** Completion index of object names (one per schema in toCache).
+ *
+ * Names are kept in two string pools (original and case folded) and an array of fixed size items
+ * sorted by the folded name. Names are inserted into a pending list and the arrays are rebuilt in bulk
+ * by the first lookup following the inserts.
+ *
+ * Matching, in order of ranking:
+ *  - exact and prefix match (binary search)
+ *  - segment match: query is split over starts of name segments (underscores, digits, camelCase),
+ *    "EMPADDR" and "EA" both match EMP_ADDRESS
+ *  - fuzzy match: query is a subsequence of the name
+ *
+ * Not thread safe, the caller should lock the instance.
+ */
+class toCompletionIndex
+{
+    public:
+        enum MatchFlag
+        {
+            PrefixMatch = 1,
+            SegmentMatch = 2,
+            FuzzyMatch = 4,
+            AllMatches = PrefixMatch | SegmentMatch | FuzzyMatch
+        };
+
+        toCompletionIndex();
+
+        /** Add name to the index, duplicates are ignored */
+        void insert(QString const& name);
+        void insert(QStringList const& names);
+
+        /** Replace index content */
+        void build(QStringList const& names);
+
+        void clear();
+
+        int size() const;
+        bool isEmpty() const;
+
+        /** Return names matching text prepended by base.
+         *  @param limit max number of returned names, 0 means no limit (prefix matches only are returned then)
+         */
+        QStringList complete(QString const& text, QString const& base = QString(), int flags = AllMatches, int limit = 500) const;
+
+    private:
+        struct Item
+        {
+            quint32 folded;         // offset into m_folded
+            quint32 original;       // offset into m_original
+            quint16 length;         // folded length
+            quint16 originalLength;
+            quint32 segments;       // bit set for each segment start (position < 32) in the name
+            quint64 chars;          // set of characters of the name, see charMask
+        };
+
+        void rebuild() const;
+        QString original(Item const& item) const;
+        int lowerBound(QChar const* text, int len) const;
+
+        static quint64 charMask(QChar const* text, int len);
+        static int segmentScore(QChar const* name, int len, quint32 segments, QChar const* text, int textLen);
+        static int fuzzyScore(QChar const* name, int len, QChar const* text, int textLen);
+
+        mutable QString m_folded, m_original;
+        mutable QVector<Item> m_items;
+        mutable QStringList m_pending;
+};
@@ -44,6 +44,7 @@
 #include "core/toconnectionprovider.h"
 #include "widgets/toworkspace.h"
 #include "core/todatabaseconfig.h"
+#include "core/tosql.h"
 
 #include <QMenu>
 
@@ -74,6 +75,7 @@ toConnection::toConnection(const QString &provider,
     toConnectionSub* connSub = addConnection();
     Version = connSub->version();
     Connections.insert(connSub);
+    SqlTable = QSharedPointer<toSQLTable const>(toSQL::resolveAll(Provider, Version));
 
     setDefaultSchema(schema);
 
@@ -110,6 +112,7 @@ toConnection::toConnection(const toConnectionOptions &opts)
     toConnectionSub* connSub = addConnection();
     Version = connSub->version();
     Connections.insert(connSub);
+    SqlTable = QSharedPointer<toSQLTable const>(toSQL::resolveAll(Provider, Version));
 
     setDefaultSchema(opts.schema);
 
@@ -140,6 +143,7 @@ toConnection::toConnection(const toConnection &other)
     , ConnectionOptions(other.ConnectionOptions)
     , pCache(NULL)
     , LoanCnt(0)
+    , SqlTable(other.sqlTable())
 {
     //tool Connection = toConnectionProvider::connection(Provider, this);
     //ConnectionPool = new toConnectionPool(this);
@@ -383,6 +387,14 @@ void toConnection::commandCallback(QAction *act)
 	}
 }
 
+QSharedPointer<toSQLTable const> toConnection::sqlTable() const
+{
+    QMutexLocker lock(&SqlTableLock);
+    if (!SqlTable || SqlTable->Generation != toSQL::generation())
+        SqlTable = QSharedPointer<toSQLTable const>(toSQL::resolveAll(Provider, Version));
+    return SqlTable;
+}
+
 QString toConnection::description(bool version) const
 {
     QString ret(User);
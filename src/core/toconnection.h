@@ -50,6 +50,7 @@
 #include <QtCore/QAtomicInt>
 #include <QtCore/QVariant>
 #include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
 
 class QWidget;
 class QAction;
@@ -62,6 +63,7 @@ class toQuery;           // defined in toquery.h
 class queryImpl;         // defined in toqueryimpl.h
 class toConnectionSubLoan;
 class toSQL;
+class toSQLTable;      // defined in tosql.h
 
 /** Represent a database connection in TOra. Observe that this can mean several actual
  * connections to the database as queries that are expected to run a long time are sometimes
@@ -175,6 +177,11 @@ class toConnection : public QObject
             return Version;
         }
 
+        /** Get statements of @ref toSQL resolved for this connection's provider and version.
+         *  The table is rebuilt when the SQL definitions were changed.
+         */
+        QSharedPointer<toSQLTable const> sqlTable() const;
+
         /** Get a description of this connection.
          * @version Include version in returned string.
          */
@@ -393,6 +400,8 @@ class toConnection : public QObject
         toConnectionOptions ConnectionOptions;
         toCache *pCache;
         QAtomicInt LoanCnt;
+        mutable QMutex SqlTableLock;
+        mutable QSharedPointer<toSQLTable const> SqlTable;
         QSet<QAction*> ConnectionActions;
 }; // toConnection
 
@@ -35,6 +35,12 @@
 #include "core/toconnectionsub.h"
 #include "core/toconnection.h"
 #include "core/toquery.h"
+#include "core/toeventquerypool.h"
+
+toConnectionSub::~toConnectionSub()
+{
+    toEventQueryPoolSingle::Instance().forget(this);
+}
 
 bool toConnectionSub::hasTransaction()
 {
@@ -24,7 +24,7 @@ class TORA_EXPORT toConnectionSub
         toConnectionSub() : Query(NULL), Broken(false), Initialized(false), mutex(QMutex::NonRecursive) {}
 
         /** Close connection. */
-        virtual ~toConnectionSub() {}
+        virtual ~toConnectionSub();
 
         // GETTERS
 
@@ -38,6 +38,7 @@
 
 #include <QtCore/QString>
 #include <QtCore/QList>
+#include <QtCore/QStringList>
 
 class toConnection;
 
@@ -91,6 +92,45 @@ class toConnectionTraits
          */
         virtual bool hasAsyncBreak() const = 0;
 
+        /** Check if connection provider supports SAVEPOINT and ROLLBACK TO SAVEPOINT.
+         *  Edited table data are saved in batches only when a failed batch can be undone
+         *  and re-executed row by row (see toResultTableData::commitChanges)
+         */
+        virtual bool hasSavepoints() const
+        {
+            return false;
+        }
+
+        /** Statement starting an explicit transaction on sessions running in autocommit mode.
+         *  Savepoints are valid only inside a transaction.
+         *  @return SQL statement or an empty string if the session is always in a transaction
+         */
+        virtual QString beginTransactionSQL() const
+        {
+            return QString();
+        }
+
+        /** Generate a single statement inserting several rows.
+         *  @param table quoted table name
+         *  @param columns comma separated list of quoted column names
+         *  @param rows comma separated list of values (or bind variables) for each row
+         *  @return SQL statement or an empty string if not supported
+         */
+        virtual QString insertRows(QString const&, QString const&, QStringList const&) const
+        {
+            return QString();
+        }
+
+        /** Cast a value to the type of a column where the statement does not give it one
+         *  (branches of the CASE in batch UPDATEs, see toResultTableData::commitBatch)
+         *  @param value SQL expression
+         *  @param datatype column type as described by the provider (toCache::ColumnDescription::Datatype)
+         */
+        virtual QString castValue(QString const &value, QString const&) const
+        {
+            return value;
+        }
+
         /**
          * Return list of primary key columns for a table
          * By default return an empty list => table can not be modified using toResultTableViewEdit
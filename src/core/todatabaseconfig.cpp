@@ -77,6 +77,16 @@ QVariant ToConfiguration::Database::defaultValue(int option) const
             return QVariant((bool)true);
         case IncludeParallelBool:
             return QVariant((bool)true);
+        case FetchAheadRowsInt:
+            return QVariant((int)10000);
+        case FetchAheadMemoryInt:
+            return QVariant((int)32);
+        case QueryThreadsInt:
+            return QVariant((int)16);
+        case CursorFetchRowsInt:
+            return QVariant((int)1000);
+        case CacheDeltaRefreshBool:
+            return QVariant((bool)true);
         default:
             Q_ASSERT_X( false, qPrintable(__QHERE__), qPrintable(QString("Context Database un-registered enum value: %1").arg(option)));
             return QVariant();
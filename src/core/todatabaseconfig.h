@@ -64,6 +64,11 @@ namespace ToConfiguration
                 , IncludeHeaderBool        // #define CONF_EXT_INC_HEADER
                 , IncludePromptBool        // #define CONF_EXT_INC_PROMPT
                 , IncludeParallelBool      // #define CONF_EXT_INC_PARALLEL
+                , FetchAheadRowsInt        // rows toEventQueryWorker may read ahead (invisible)
+                , FetchAheadMemoryInt      // MB toEventQueryWorker may read ahead (invisible)
+                , QueryThreadsInt          // max threads in toEventQueryPool (invisible)
+                , CursorFetchRowsInt       // rows per FETCH of PostgreSQL server side cursor, 0 = disabled (invisible)
+                , CacheDeltaRefreshBool    // refresh object cache incrementally by DDL time (invisible)
             };
             virtual QVariant defaultValue(int) const;
     };
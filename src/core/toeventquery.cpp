@@ -36,11 +36,23 @@
 #include "core/utils.h"
 #include "core/tologger.h"
 #include "core/toeventqueryworker.h"
+#include "core/toeventquerybuffer.h"
+#include "core/toeventquerypool.h"
+#include "core/toconfiguration.h"
+#include "core/todatabaseconfig.h"
 //#include "widgets/toresultstats.h"
 #include "core/toconnection.h"
 #include "core/toconnectionsub.h"
 #include "core/toconnectionsubloan.h"
 #include "core/toconnectiontraits.h"
+#include "core/toquerytrace.h"
+
+// Borrowing a sub connection blocks when all of them are in use
+static toConnectionSubLoan* tracedLoan(toConnection &conn, QSharedPointer<toQueryTrace> const& trace)
+{
+    toQueryTrace::Scope span(trace, toQueryTrace::LOAN_WAIT);
+    return new toConnectionSubLoan(conn);
+}
 
 toEventQuery::toEventQuery(QObject *parent
                            , toConnection &conn
@@ -60,15 +72,11 @@ toEventQuery::toEventQuery(QObject *parent
     , Worker(NULL)
     , Started(false)
     , WorkDone(false)
-    , Connection(new toConnectionSubLoan(conn))
+    , Trace(new toQueryTrace(sql, conn.description(false)))
+    , Connection(tracedLoan(conn, Trace))
     , CancelCondition(new toEventQuery::WaitConditionWithMutex())
     , Mode(mode)
 {
-    /* BIG FAT WARNING QThread's parent must be  NULL, so it is not disposed when toEventQuery is deleted.
-     * Theoretically (and practically) it can be freed after ~toEventQuery is processed
-     */
-    Thread = new BGThread(NULL);
-    Thread->setObjectName("toEventQuery");
     TLOG(7, toDecorator, __HERE__) << "toEventQuery created" << std::endl;
 }
 
@@ -90,15 +98,11 @@ toEventQuery::toEventQuery(QObject *parent
     , Worker(NULL)
     , Started(false)
     , WorkDone(false)
+    , Trace(new toQueryTrace(sql, conn->ParentConnection.description(false)))
     , Connection(conn)
     , CancelCondition(new toEventQuery::WaitConditionWithMutex())
     , Mode(mode)
 {
-    /* BIG FAT WARNING QThread's parent must be  NULL, so it is not disposed when toEventQuery is deleted.
-     * Theoretically (and practically) it can be freed after ~toEventQuery is processed
-     */
-    Thread = new BGThread(NULL);
-    Thread->setObjectName("toEventQuery");
     TLOG(7, toDecorator, __HERE__) << "toEventQuery created" << std::endl;
 }
 
@@ -107,6 +111,8 @@ toEventQuery::~toEventQuery()
     TLOG(7, toDecorator, __HERE__) << "~toEventQuery a" << std::endl;
     // we request bg thread to stop, but do not really wait for thread finish
     stop();
+    if (Trace->finish())
+        toQueryTraceRegistrySingle::Instance().add(Trace);
 }
 
 void toEventQuery::start()
@@ -114,16 +120,21 @@ void toEventQuery::start()
     if ( Worker || Started || WorkDone )
         throw tr("toEventQuery::start - can not restart already stared query");
 
-    Worker = new toEventQueryWorker(this, Connection, CancelCondition, SQL, Param);
+    int maxRows = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::FetchAheadRowsInt).toInt();
+    int maxMB = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::FetchAheadMemoryInt).toInt();
+    Buffer = QSharedPointer<toEventQueryBuffer>(new toEventQueryBuffer(qMax(maxRows, 1), qMax(maxMB, 1) * 1024LL * 1024LL));
+
+    // threads are shared, the pool keeps the sub on the same thread while it has a live worker
+    Thread = toEventQueryPoolSingle::Instance().acquire(Connection->ConnectionSub);
+    Worker = new toEventQueryWorker(this, Connection, CancelCondition, Buffer, SQL, Param);
     Worker->moveToThread(Thread);
-    Thread->Slave = Worker;
 
     // Connect to Worker's API
     connect(Worker, SIGNAL(headers(toQColumnDescriptionList &, int)),      //  BG -> main
             this, SLOT(slotDesc(toQColumnDescriptionList &, int)));
 
-    connect(Worker, SIGNAL(data(const ValuesList &)),                      //  BG -> main
-            this, SLOT(slotData(const ValuesList &)));
+    connect(Worker, SIGNAL(data()),                                        //  BG -> main
+            this, SLOT(slotData()));
 
     connect(Worker, SIGNAL(error(const toConnection::exception &)),        //  BG -> main
             this, SLOT(slotError(const toConnection::exception &)));
@@ -138,29 +149,30 @@ void toEventQuery::start()
 
     connect(this,   SIGNAL(consumed()),       Worker, SLOT(slotRead()));   // main -> BG
 
-    // Connect to QThread's API
     //  error handling
     connect(Worker, SIGNAL(error(toConnection::exception const &))         //  BG -> main
             , this, SLOT(slotError(toConnection::exception const &)));
     //  initization
-    connect(Thread, SIGNAL(started()),        Worker, SLOT(init()));       // main -> BG
     connect(Worker, SIGNAL(started()),        this,   SLOT(slotStarted()));// BG   -> main
-    //  finish
-    connect(Worker, SIGNAL(finished()),       Thread, SLOT(quit()));          // BG -> BG?? (quit event loop)
+    //  finish, the thread itself returns to the pool when Worker is deleted
     connect(Worker, SIGNAL(finished()),       Worker, SLOT(deleteLater()));   // BG -> BG
-    connect(Thread, SIGNAL(finished()),       Thread, SLOT(deleteLater()));   // BG -> main
-    connect(Thread, SIGNAL(destroyed()),      this,   SLOT(slotThreadEnd())); // main -> main
+    connect(Worker, SIGNAL(destroyed()),      this,   SLOT(slotThreadEnd())); // BG -> main
     connect(this,   SIGNAL(stopRequested()),  Worker, SLOT(slotStop()));      // main -> BG
 
     TLOG(7, toDecorator, __HERE__) << "toEventQuery start" << std::endl;
-    // finally start the thread
-    Thread->start();
+    // finally queue the Worker into the thread's event loop
+    QMetaObject::invokeMethod(Worker, "init", Qt::QueuedConnection);
 }
 
 void toEventQuery::setFetchMode(FETCH_MODE m)
 {
     if (Mode == READ_FIRST && m == READ_ALL)
+    {
+        // a full Buffer would keep the Worker waiting, give it all the credit now
+        while (takeBatch())
+            ;
         emit dataRequested();
+    }
     Mode = m;
 }
 
@@ -180,24 +192,39 @@ unsigned long toEventQuery::rowsProcessed(void) const
 }
 
 /* Call stask for this function:
- * Async thread toEventQueryWorker emits signal data()
+ * Async thread toEventQueryWorker pushes a batch into Buffer and emits signal data()
  * the rest is processed in the main thread
- * the slot taskData receives data (runs within the main thread context)
- * taskData emits signal dataAvailable
+ * the slot slotData receives the notification (runs within the main thread context)
+ * slotData emits signal dataAvailable
  * toEventQuery parent(toResulModel for example) receives signal
  * and then calls toEventQeury::readValue
  */
 toQValue toEventQuery::readValue()
 {
-    if (Values.isEmpty())
+    if (Values.isEmpty() && !takeBatch())
         throw tr("Read past end of query");
 
-    if ((Values.size() == ColumnCount) && !eof())
-        emit dataRequested();
-
     return Values.takeFirst();
 }
 
+bool toEventQuery::takeBatch()
+{
+    if (!Buffer)
+        return false;
+
+    ValuesList *values = Buffer->pop();
+    if (!values)
+        return false;
+
+    Values << *values;
+    delete values;
+
+    // there is room in the Buffer now, let the Worker read ahead again
+    if (!WorkDone)
+        emit consumed();
+    return true;
+}
+
 bool toEventQuery::eof(void) const
 {
     if (hasMore())
@@ -212,7 +239,19 @@ QString const& toEventQuery::sql(void) const
 
 bool toEventQuery::hasMore(void) const
 {
-    return !Values.isEmpty();
+    return !Values.isEmpty() || (Buffer && !Buffer->isEmpty());
+}
+
+QString toEventQuery::schema(void) const
+{
+    if (!Connection->Schema.isEmpty())
+        return Connection->Schema;
+    return (*Connection)->schema();
+}
+
+QSharedPointer<toQueryTrace> const& toEventQuery::trace(void) const
+{
+    return Trace;
 }
 
 void toEventQuery::stop(void)
@@ -221,7 +260,7 @@ void toEventQuery::stop(void)
     if (WorkDone)
         return;
 
-    if (Thread && Thread->isRunning())
+    if (Worker)
     {
         Utils::toBusy busy;
         TLOG(7, toDecorator, __HERE__) << "toEventQuery stop Thread is running" << std::endl;
@@ -252,14 +291,20 @@ void toEventQuery::slotStarted()
     emit dataRequested();             // request 1st chunk of rows
 }
 
-// warning: values is a reference only bg thread's stack
-void toEventQuery::slotData(const ValuesList &values)
+void toEventQuery::slotData()
 {
     //TLOG(7, toDecorator, __HERE__) << "toEventQuery slot data" << std::endl;
-    Values << values;
-
+    Trace->delivered();
     if (Mode == READ_ALL)
-        emit consumed();
+    {
+        // READ_ALL consumers may skip dataAvailable (e.g. while a modal dialog is open),
+        // the Worker must not wait for them. So the Buffer is drained here and the query
+        // always reaches its end.
+        while (takeBatch())
+            ;
+    }
+    else if (Values.isEmpty())
+        takeBatch();
 
     // TODO: this signal can also be emitted asynchronically
     // from QTime - once per second
@@ -292,6 +337,7 @@ void toEventQuery::slotDesc(toQColumnDescriptionList &desc, int columns)
 void toEventQuery::slotError(const toConnection::exception &msg)
 {
     TLOG(7, toDecorator, __HERE__) << "toEventQuery slot error" << std::endl;
+    Trace->setError(msg);
     emit error(this, msg);
 }
 
@@ -48,7 +48,9 @@
 #include <QtCore/QWaitCondition>
 
 class toResultStats;
+class toQueryTrace;
 class toEventQueryWorker;
+class toEventQueryBuffer;
 class BGThread;
 
 /**
@@ -187,6 +189,16 @@ class toEventQuery : public QObject
          */
         bool hasMore(void) const;
 
+        /**
+         * Latency breakdown of this query, published to toQueryTraceRegistry when the query is deleted
+         */
+        QSharedPointer<toQueryTrace> const& trace(void) const;
+
+        /**
+         * Schema of the session this query runs on, empty if it was never switched
+         */
+        QString schema(void) const;
+
     public slots:
         /**
          * Stop reading query
@@ -231,7 +243,7 @@ class toEventQuery : public QObject
         void slotStarted();
 
         // handle worker's data() signal. emits dataAvailable()
-        void slotData(const ValuesList &values);
+        void slotData(void);
 
         // handle worker's headers() signal emits descriptionAvailable()
         void slotDesc(toQColumnDescriptionList &desc, int columns);
@@ -245,15 +257,22 @@ class toEventQuery : public QObject
         // sets Processed. signal is sent if > 0
         void slotRowsProcessed(unsigned long rows);
 
-        // emitted immediately before the Thread is destroyed
+        // emitted when the Worker is destroyed, the Thread returns to toEventQueryPool
         void slotThreadEnd();
 
     private:
         /** Undefined copy contructor.Don't clone me. */
         toEventQuery(toEventQuery const& other);
 
+        /** Take next batch from Buffer into Values, gives credit back to the Worker */
+        bool takeBatch(void);
+
+        // batch being read by readValue()
         ValuesList Values;
 
+        // batches read ahead by the Worker
+        QSharedPointer<toEventQueryBuffer> Buffer;
+
         // SQL to execute.
         QString SQL;
 
@@ -269,13 +288,16 @@ class toEventQuery : public QObject
         // Description of result
         toQColumnDescriptionList Description;
 
-        // reference to a BG producer thread, these are deleted from event loop
+        // reference to a pooled BG producer thread (see toEventQueryPool), Worker is deleted from event loop
         BGThread *Thread;
         toEventQueryWorker *Worker;
 
         bool Started;
         bool WorkDone;
 
+        // latency breakdown, must be initialized before Connection (the loan wait is traced)
+        QSharedPointer<toQueryTrace> Trace;
+
         // connection for this query
         QSharedPointer<toConnectionSubLoan> Connection;
 
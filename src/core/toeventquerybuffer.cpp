@@ -0,0 +1,121 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toeventquerybuffer.h"
+
+toEventQueryBuffer::toEventQueryBuffer(unsigned maxRows, qint64 maxBytes)
+    : Head(0)
+    , Tail(0)
+    , Rows(0)
+    , Bytes(0)
+    , MaxRows(maxRows)
+    , MaxBytes(maxBytes)
+{
+    for (int i = 0; i < SLOTS; i++)
+    {
+        Ring[i].values = NULL;
+        Ring[i].rows = 0;
+        Ring[i].bytes = 0;
+    }
+}
+
+toEventQueryBuffer::~toEventQueryBuffer()
+{
+    ValuesList *values;
+    while ((values = pop()) != NULL)
+        delete values;
+}
+
+bool toEventQueryBuffer::full() const
+{
+    int tail = Tail.loadAcquire();
+    int head = Head.loadAcquire();
+    if (tail == head)
+        return false;
+    if (tail - head >= SLOTS)
+        return true;
+    return (unsigned) Rows.loadAcquire() >= MaxRows || Bytes.loadAcquire() >= MaxBytes;
+}
+
+void toEventQueryBuffer::push(ValuesList *values, unsigned rows, qint64 bytes)
+{
+    int tail = Tail.loadAcquire();
+    Q_ASSERT_X(tail - Head.loadAcquire() < SLOTS, "toEventQueryBuffer::push", "ring overflow");
+    Slot &slot = Ring[tail % SLOTS];
+    slot.values = values;
+    slot.rows = rows;
+    slot.bytes = bytes;
+    Rows.fetchAndAddOrdered(rows);
+    Bytes.fetchAndAddOrdered(bytes);
+    Tail.storeRelease(tail + 1);   // publish the slot
+}
+
+ValuesList* toEventQueryBuffer::pop()
+{
+    int head = Head.loadAcquire();
+    if (head == Tail.loadAcquire())
+        return NULL;
+    Slot &slot = Ring[head % SLOTS];
+    ValuesList *retval = slot.values;
+    Rows.fetchAndAddOrdered(-(int)slot.rows);
+    Bytes.fetchAndAddOrdered(-slot.bytes);
+    slot.values = NULL;
+    Head.storeRelease(head + 1);   // release the slot to the producer
+    return retval;
+}
+
+bool toEventQueryBuffer::isEmpty() const
+{
+    return Head.loadAcquire() == Tail.loadAcquire();
+}
+
+unsigned toEventQueryBuffer::rows() const
+{
+    return Rows.loadAcquire();
+}
+
+qint64 toEventQueryBuffer::bytes() const
+{
+    return Bytes.loadAcquire();
+}
+
+qint64 toEventQueryBuffer::sizeOf(toQValue const &value)
+{
+    qint64 retval = sizeof(toQValue) + sizeof(void*); // QList node
+    if (value.isString())
+        retval += value.toQVariant().toString().size() * sizeof(QChar);
+    else if (value.isBinary())
+        retval += value.toQVariant().toByteArray().size();
+    return retval;
+}
@@ -0,0 +1,107 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toqvalue.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QAtomicInteger>
+
+/**
+ * Bounded single-producer/single-consumer ring of row batches.
+ *
+ * toEventQueryWorker (producer, BG thread) pushes batches of values read
+ * from the query, toEventQuery (consumer, main thread) pops them. Neither
+ * side takes a lock. The producer keeps reading ahead until the high-water
+ * mark (rows or bytes buffered) is reached, every popped batch gives the
+ * producer credit to read again.
+ */
+class toEventQueryBuffer
+{
+    public:
+        /**
+         * @param maxRows Row high-water mark
+         * @param maxBytes Memory high-water mark (estimated size of buffered values)
+         */
+        toEventQueryBuffer(unsigned maxRows, qint64 maxBytes);
+        ~toEventQueryBuffer();
+
+        // producer side
+
+        /** True if the producer should not read more rows now.
+         *  An empty buffer is never full, so at least one batch can always be read.
+         */
+        bool full(void) const;
+
+        /** Append a batch, the buffer takes ownership of values.
+         *  Must only be called when full() returned false.
+         */
+        void push(ValuesList *values, unsigned rows, qint64 bytes);
+
+        // consumer side
+
+        /** Take the oldest batch, caller owns it. Returns NULL when buffer is empty.
+         */
+        ValuesList* pop(void);
+
+        bool isEmpty(void) const;
+
+        /** Number of rows currently buffered */
+        unsigned rows(void) const;
+
+        /** Estimated memory held by buffered values */
+        qint64 bytes(void) const;
+
+        /** Estimated memory used by a value */
+        static qint64 sizeOf(toQValue const &value);
+
+    private:
+        struct Slot
+        {
+            ValuesList *values;
+            unsigned rows;
+            qint64 bytes;
+        };
+        enum { SLOTS = 256 };
+
+        Slot Ring[SLOTS];
+        QAtomicInt Head;                // next slot to be popped, written by consumer
+        QAtomicInt Tail;                // next slot to be pushed, written by producer
+        QAtomicInt Rows;
+        QAtomicInteger<qint64> Bytes;
+
+        const unsigned MaxRows;
+        const qint64 MaxBytes;
+};
@@ -0,0 +1,177 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toeventquerypool.h"
+#include "core/toeventqueryworker.h"
+#include "core/toconfiguration.h"
+#include "core/todatabaseconfig.h"
+#include "core/tologger.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QMutexLocker>
+
+toEventQueryPool::toEventQueryPool()
+    : QObject(NULL)
+    , Mutex(QMutex::NonRecursive)
+{
+    if (QCoreApplication::instance())
+        connect(QCoreApplication::instance(), SIGNAL(aboutToQuit()), this, SLOT(shutdown()));
+}
+
+toEventQueryPool::~toEventQueryPool()
+{
+    shutdown();
+}
+
+toEventQueryPool::Metrics toEventQueryPool::metrics() const
+{
+    QMutexLocker lock(&Mutex);
+    return metricsLocked();
+}
+
+toEventQueryPool::Metrics toEventQueryPool::metricsLocked() const
+{
+    Metrics retval;
+    retval.threads = Threads.size();
+    retval.busy = 0;
+    int running = 0;
+    Q_FOREACH(Slot const& slot, Threads)
+    {
+        retval.busy += slot.busy;
+        if (slot.busy > 0)
+            running++;
+    }
+    // one busy worker runs on each thread, the others wait in it's event loop
+    retval.queued = retval.busy - running;
+    return retval;
+}
+
+BGThread* toEventQueryPool::acquire(toConnectionSub *sub)
+{
+    QMutexLocker lock(&Mutex);
+
+    int best = -1;
+    QMap<toConnectionSub*, Pin>::iterator pin = Affinity.find(sub);
+    for (int i = 0; i < Threads.size(); i++)
+    {
+        if (pin != Affinity.end())
+        {
+            if (Threads[i].thread == pin->thread)
+            {
+                best = i;
+                break;
+            }
+        }
+        else if (best < 0 || Threads[i].busy < Threads[best].busy)
+        {
+            best = i;
+        }
+    }
+
+    int maxThreads = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::QueryThreadsInt).toInt();
+    if (best < 0 || (pin == Affinity.end() && Threads[best].busy > 0 && Threads.size() < maxThreads))
+    {
+        /* BIG FAT WARNING QThread's parent must be  NULL, so it is not disposed when toEventQuery is deleted.
+         */
+        Slot slot;
+        slot.thread = new BGThread(NULL);
+        slot.thread->setObjectName("toEventQuery");
+        slot.thread->start();
+        slot.busy = 0;
+        Threads.append(slot);
+        best = Threads.size() - 1;
+        TLOG(7, toDecorator, __HERE__) << "toEventQueryPool new thread: " << Threads.size() << std::endl;
+    }
+
+    Threads[best].busy++;
+    if (pin != Affinity.end())
+    {
+        pin->workers++;
+    }
+    else
+    {
+        Pin p;
+        p.thread = Threads[best].thread;
+        p.workers = 1;
+        Affinity.insert(sub, p);
+    }
+    Metrics m = metricsLocked();
+    TLOG(7, toDecorator, __HERE__) << "toEventQueryPool threads: " << m.threads
+                                   << " busy: " << m.busy << " queued: " << m.queued << std::endl;
+    return Threads[best].thread;
+}
+
+void toEventQueryPool::release(BGThread *thread, toConnectionSub *sub)
+{
+    QMutexLocker lock(&Mutex);
+    QMap<toConnectionSub*, Pin>::iterator pin = Affinity.find(sub);
+    if (pin != Affinity.end() && pin->thread == thread && --pin->workers <= 0)
+        Affinity.erase(pin);
+}
+
+void toEventQueryPool::setBusy(BGThread *thread, bool busy)
+{
+    QMutexLocker lock(&Mutex);
+    for (int i = 0; i < Threads.size(); i++)
+    {
+        if (Threads[i].thread == thread)
+        {
+            Threads[i].busy += busy ? 1 : -1;
+            Q_ASSERT_X(Threads[i].busy >= 0, qPrintable(__QHERE__), "toEventQueryPool::setBusy unbalanced");
+            return;
+        }
+    }
+}
+
+void toEventQueryPool::forget(toConnectionSub *sub)
+{
+    QMutexLocker lock(&Mutex);
+    Affinity.remove(sub);
+}
+
+void toEventQueryPool::shutdown()
+{
+    QList<Slot> threads;
+    {
+        QMutexLocker lock(&Mutex);
+        threads.swap(Threads);
+        Affinity.clear();
+    }
+    Q_FOREACH(Slot const& slot, threads)
+    {
+        slot.thread->quit();
+        if (slot.thread->wait(1000))
+            delete slot.thread;
+    }
+}
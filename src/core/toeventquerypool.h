@@ -0,0 +1,113 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tora_export.h"
+#include "loki/Singleton.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QMutex>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+
+class BGThread;
+class toConnectionSub;
+
+/**
+ * Bounded pool of background threads running toEventQueryWorker(s).
+ *
+ * Threads are created on demand (up to Database::QueryThreadsInt) and reused,
+ * so starting a query does not create and destroy a QThread anymore.
+ * While a toConnectionSub has a live worker, its next queries run on the same
+ * thread, OCI handles must not be used from two threads at once. A sub without
+ * live workers goes to the least busy thread. Only workers executing or reading
+ * a batch count as busy, workers waiting for their consumer do not.
+ * When all threads are busy a new query is queued in the event loop of the least busy one.
+ */
+class TORA_EXPORT toEventQueryPool : public QObject
+{
+        Q_OBJECT;
+    public:
+        struct Metrics
+        {
+            int threads;                // threads started
+            int busy;                   // workers executing or reading a batch, or waiting to
+            int queued;                 // busy workers waiting for their thread
+        };
+
+        toEventQueryPool();
+        virtual ~toEventQueryPool();
+
+        /** Current load of the pool */
+        Metrics metrics(void) const;
+
+        /** Get a thread to run a query on sub. Every call must be paired with release().
+         *  The new worker counts as busy until it calls setBusy(thread, false) after its init. */
+        BGThread* acquire(toConnectionSub *sub);
+
+        /** A worker started on thread for sub has been deleted (called from any thread) */
+        void release(BGThread *thread, toConnectionSub *sub);
+
+        /** A worker on thread started (true) or finished (false) executing or reading a batch */
+        void setBusy(BGThread *thread, bool busy);
+
+        /** Sub is being deleted, drop its thread affinity */
+        void forget(toConnectionSub *sub);
+
+    private slots:
+        /** Stop event loops of all the threads */
+        void shutdown(void);
+
+    private:
+        Metrics metricsLocked(void) const;
+
+        struct Slot
+        {
+            BGThread *thread;
+            int busy;                   // workers executing/reading now or waiting for it in the event loop
+        };
+
+        struct Pin
+        {
+            BGThread *thread;
+            int workers;                // live workers of the sub
+        };
+
+        mutable QMutex Mutex;
+        QList<Slot> Threads;
+        QMap<toConnectionSub*, Pin> Affinity;
+};
+
+class TORA_EXPORT toEventQueryPoolSingle: public ::Loki::SingletonHolder<toEventQueryPool, Loki::CreateUsingNew, Loki::NoDestroy> {};
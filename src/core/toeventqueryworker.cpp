@@ -34,6 +34,8 @@
 
 #include "core/toeventqueryworker.h"
 #include "core/toeventquery.h"
+#include "core/toeventquerybuffer.h"
+#include "core/toeventquerypool.h"
 #include "core/utils.h"
 #include "core/tologger.h"
 //stat #include "widgets/toresultstats.h"
@@ -43,6 +45,7 @@
 #include "core/toqvalue.h"
 #include "core/todatabaseconfig.h"
 #include "core/toconnectiontraits.h"
+#include "core/toquerytrace.h"
 
 #include "widgets/toworkspace.h"
 #include "widgets/totoolwidget.h"
@@ -50,31 +53,51 @@
 #include <QApplication>
 #include <QtCore/QMutexLocker>
 #include <QtCore/QTimer>
+#include <QtCore/QScopedPointer>
+
+// fetch/convert split of a batch is measured on every n-th row only
+static const unsigned TRACE_SAMPLE = 16;
+
+/* Marks the worker's thread as busy in toEventQueryPool while a batch is read */
+class toEventQueryBusy
+{
+    public:
+        toEventQueryBusy(BGThread *thread) : Thread(thread)
+        {
+            toEventQueryPoolSingle::Instance().setBusy(Thread, true);
+        }
+        ~toEventQueryBusy()
+        {
+            toEventQueryPoolSingle::Instance().setBusy(Thread, false);
+        }
+    private:
+        BGThread *Thread;
+};
 
 /* It is not allowed to throw an exception from event slot.
  * So let's catch all the possible errors in slot handlers
  */
 #define CATCH_ALL                                   \
     catch(const toConnection::exception &str) {     \
-        TLOG(7,toDecorator,__HERE__) << "What: " << str << std::endl;\
+        TLOGF(7, "What: %1", str);                  \
         emit error(str);                            \
         Stopped=true;                               \
         close();                                    \
     }                                               \
     catch(const QString &str) {                     \
-        TLOG(7,toDecorator,__HERE__) << "What: " << str << std::endl;\
+        TLOGF(7, "What: %1", str);                  \
         emit error(str);                            \
         Stopped=true;                               \
         close();                                    \
     }                                               \
     catch(std::exception const &e) {                \
-        TLOG(7,toDecorator,__HERE__) << "what: " << e.what() << std::endl;\
+        TLOGF(7, "what: %1", e.what());             \
         emit error(QString(e.what()));              \
         Stopped=true;                               \
         close();                                    \
     }                                               \
     catch(...) {                                    \
-        TLOG(7,toDecorator,__HERE__) << "	Ignored exception." << std::endl; \
+        TLOGF(7, "Ignored exception.");             \
         emit error(tr("Unknown exception."));       \
         Stopped=true;                               \
         close();                                    \
@@ -84,6 +107,7 @@ void toEventQueryWorker::toQueryPriv::init()
 {
     try
     {
+        qint64 initStart = toQueryTrace::now();
         // Try to switch the current db schema
         if (m_ConnectionSubLoan.SchemaInitialized == false && !m_ConnectionSubLoan.Schema.isEmpty())
         {
@@ -122,6 +146,10 @@ void toEventQueryWorker::toQueryPriv::init()
             delete m_Query;
         }
 #endif
+        if (Trace)
+            Trace->addSpan(toQueryTrace::INIT, initStart, toQueryTrace::now() - initStart);
+
+        toQueryTrace::Scope executeSpan(Trace, toQueryTrace::EXECUTE);
         m_Query = m_ConnectionSubLoan->createQuery(this);
         m_ConnectionSubLoan->setQuery(this);
         m_Query->execute();
@@ -139,6 +167,7 @@ void toEventQueryWorker::toQueryPriv::init()
 toEventQueryWorker::toEventQueryWorker(toEventQuery *c
                                        , QSharedPointer<toConnectionSubLoan> &conn
                                        , QSharedPointer<toEventQuery::WaitConditionWithMutex> &wait
+                                       , QSharedPointer<toEventQueryBuffer> &buffer
                                        , QString &sql
                                        , toQueryParams &params)
     : Consumer(c)
@@ -146,24 +175,32 @@ toEventQueryWorker::toEventQueryWorker(toEventQuery *c
     , Params(params)
     , Connection(conn)
     , CancelCondition(wait)
+    , Buffer(buffer)
+    , Thread(c->Thread)
+    , Sub(*conn)
     , ColumnCount(0)
     , Stopped(false)
     , Closed(false)
+    , Busy(true)
     , Query(*Connection, SQL, Params)
 {
-    TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker created" << std::endl;
+    TLOGF(7, "toEventQueryWorker created");
+    Query.Trace = c->Trace;
     connect(this, SIGNAL(readRequested()), this, SLOT(slotRead()));
     Query.moveToThread(c->Thread);
 }
 
 toEventQueryWorker::~toEventQueryWorker()
 {
-    TLOG(7, toDecorator, __HERE__) << "~toEventQueryWorker" << std::endl;
+    TLOGF(7, "~toEventQueryWorker");
+    if (Busy)
+        toEventQueryPoolSingle::Instance().setBusy(Thread, false);
+    toEventQueryPoolSingle::Instance().release(Thread, Sub);
 }
 
 void toEventQueryWorker::init()
 {
-    TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker init a" << std::endl;
+    TLOGF(7, "toEventQueryWorker init a");
     try
     {
         Query.init();
@@ -182,12 +219,15 @@ void toEventQueryWorker::init()
         }
     }
     CATCH_ALL;
-    TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker init b" << std::endl;
+    // waiting for the consumer is not a load for the thread
+    Busy = false;
+    toEventQueryPoolSingle::Instance().setBusy(Thread, false);
+    TLOGF(7, "toEventQueryWorker init b");
 }
 
 void toEventQueryWorker::slotStop()
 {
-    TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker syncStop" << std::endl;
+    TLOGF(7, "toEventQueryWorker syncStop");
     Stopped = true;
     CancelCondition->WaitCondition.wakeAll();
     close();
@@ -195,7 +235,7 @@ void toEventQueryWorker::slotStop()
 
 void toEventQueryWorker::close()
 {
-    TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker close a" << std::endl;
+    TLOGF(7, "toEventQueryWorker close a");
     if (Closed)
         return;
 
@@ -207,14 +247,15 @@ void toEventQueryWorker::close()
 
     Closed = true;
     emit finished();
-    TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker close b" << std::endl;
+    TLOGF(7, "toEventQueryWorker close b");
 }
 
 void toEventQueryWorker::slotRead()
 {
+    toEventQueryBusy busy(Thread);
     try
     {
-        //TLOG(7, toDecorator, __HERE__) << "toEventQueryWorker slot read" << std::endl;
+        TLOGF(7, "toEventQueryWorker slot read");
         if (Query.eof() || ColumnCount == 0 || Stopped)
         {
             Stopped = true;
@@ -222,22 +263,68 @@ void toEventQueryWorker::slotRead()
             return;
         }
 
-        unsigned maxRead = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::InitialFetchInt).toInt();
-        ValuesList values;
-        for (unsigned row = 0; row < maxRead; row++)
+        // Consumer did not drain the buffer yet, it will call us back when it does
+        if (Buffer->full())
+            return;
+
+        int maxRead = toConfigurationNewSingle::Instance().option(ToConfiguration::Database::InitialFetchInt).toInt();
+        if (maxRead <= 0)
+            maxRead = 500; // "fetch all" is done in batches too
+        QScopedPointer<ValuesList> values(new ValuesList);
+        unsigned rows = 0;
+        qint64 bytes = 0;
+        // eof() fetches the next batch when the current one is consumed, readValue() converts.
+        // Both are interleaved per row. The batch is timed as a whole and split into one fetch span
+        // and one convert span by the ratio measured on every TRACE_SAMPLE-th row.
+        QSharedPointer<toQueryTrace> const& trace = Query.Trace;
+        qint64 batchStart = trace ? toQueryTrace::now() : 0, sampledFetch = 0, sampledConvert = 0;
+        for (; rows < (unsigned) maxRead; rows++)
         {
+            bool sample = trace && rows % TRACE_SAMPLE == 0;
+            qint64 t0 = sample ? toQueryTrace::now() : 0;
+            if (Query.eof())
+                break;
+            qint64 t1 = sample ? toQueryTrace::now() : 0;
             for (unsigned i = 0; i < ColumnCount && !Query.eof(); i++)
-                values.append(Query.readValue());
+            {
+                values->append(Query.readValue());
+                bytes += toEventQueryBuffer::sizeOf(values->last());
+            }
+            if (sample)
+            {
+                sampledFetch += t1 - t0;
+                sampledConvert += toQueryTrace::now() - t1;
+            }
+        }
+        if (trace)
+        {
+            qint64 batchTime = toQueryTrace::now() - batchStart;
+            qint64 sampled = sampledFetch + sampledConvert;
+            qint64 fetchTime = sampled > 0 ? batchTime * sampledFetch / sampled : batchTime;
+            trace->addSpan(toQueryTrace::FETCH, batchStart, fetchTime);
+            trace->addSpan(toQueryTrace::CONVERT, batchStart + fetchTime, batchTime - fetchTime);
+            trace->addRows(rows, bytes);
+            trace->setRoundTrips(Query.fetchCount());
         }
 
-        if (values.size() > 0)
-            emit data(values);    // must not access after this line
+        if (values->size() > 0)
+        {
+            Buffer->push(values.take(), rows, bytes);
+            if (trace)
+                trace->markDelivery();
+            emit data();
+        }
 
         if (Query.eof())
         {
             Stopped = true;
             close();
         }
+        else if (!Buffer->full())
+        {
+            // read ahead, queued so that slotStop can get in between
+            QMetaObject::invokeMethod(this, "slotRead", Qt::QueuedConnection);
+        }
     }
     CATCH_ALL
 }
@@ -54,6 +54,8 @@
 class toResultStats;
 class toEventQuery;
 class toEventQueryWorker;
+class toEventQueryBuffer;
+class toQueryTrace;
 
 /* This class is just a temporary wrapper for QThread */
 class BGThread : public QThread
@@ -87,6 +89,7 @@ class toEventQueryWorker : public QObject
         toEventQueryWorker(toEventQuery*
                            , QSharedPointer<toConnectionSubLoan> &
                            , QSharedPointer<toEventQuery::WaitConditionWithMutex> &
+                           , QSharedPointer<toEventQueryBuffer> &
                            , QString &
                            , toQueryParams&);
 
@@ -119,14 +122,13 @@ class toEventQueryWorker : public QObject
         */
         void headers(toQColumnDescriptionList &desc, int columns);
 
-        // must be careful when defining signals. passing by reference
-        // will share memory between threads.
+        // data itself is passed through toEventQueryBuffer, not through the signal.
         // also QObject's will have it's affinity set to background thread
         // and should be disposed within the context of the main thread
         /**
-        * Data read from query
+        * A batch of rows was pushed into the buffer
         */
-        void data(const ValuesList &values);
+        void data();
 
         /**
         * Emitted when sql query is done
@@ -152,6 +154,9 @@ class toEventQueryWorker : public QObject
         	{
         	}
         	void init();
+
+        	// trace of the owning toEventQuery
+        	QSharedPointer<toQueryTrace> Trace;
         };
     private slots:
         void slotRead();
@@ -167,10 +172,16 @@ class toEventQueryWorker : public QObject
 
         QSharedPointer<toConnectionSubLoan> Connection;
         QSharedPointer<toEventQuery::WaitConditionWithMutex> CancelCondition;
+        QSharedPointer<toEventQueryBuffer> Buffer;
+
+        // pooled thread this worker runs in, see toEventQueryPool
+        BGThread *Thread;
+        toConnectionSub *Sub;
 
         unsigned ColumnCount;
 
-        bool Stopped, Closed;
+        // Busy: counted as busy by toEventQueryPool since acquire(), till init() is done
+        bool Stopped, Closed, Busy;
 
         // the real query object
         toQueryPriv Query;
@@ -0,0 +1,304 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toexportstream.h"
+#include "core/toconnection.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toquery.h"
+#include "core/tolistviewformatterfactory.h"
+#include "core/utils.h"
+#include "ts_log/ts_log_utils.h"
+
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QIODevice>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include <memory>
+
+/* Holds one chunk of rows, column 0 is the row number as in toResultModel */
+class toExportChunkModel : public QAbstractTableModel
+{
+    public:
+        toExportChunkModel(toQColumnDescriptionList const &desc)
+            : FirstRow(1)
+            , Rows(0)
+        {
+            Names << QString::fromLatin1("#");
+            Types << QString::fromLatin1("INT");
+            Q_FOREACH(toCache::ColumnDescription const &d, desc)
+            {
+                Names << d.Name;
+                Types << d.Datatype;
+            }
+            Values.reserve(toExportStream::ChunkRows * (Names.size() - 1));
+        }
+
+        int rowCount(const QModelIndex & = QModelIndex()) const override
+        {
+            return Rows;
+        }
+
+        int columnCount(const QModelIndex & = QModelIndex()) const override
+        {
+            return Names.size();
+        }
+
+        QVariant data(const QModelIndex &index, int role) const override
+        {
+            if (role != Qt::EditRole && role != Qt::DisplayRole)
+                return QVariant();
+            if (index.column() == 0)
+                return QVariant((qulonglong) (FirstRow + index.row()));
+            return Values.at(index.row() * (Names.size() - 1) + index.column() - 1);
+        }
+
+        QVariant headerData(int section, Qt::Orientation orientation, int role) const override
+        {
+            if (orientation != Qt::Horizontal || section >= Names.size())
+                return QVariant();
+            if (role == Qt::DisplayRole)
+                return Names.at(section);
+            if (role == Qt::UserRole)
+                return Types.at(section);
+            return QVariant();
+        }
+
+        /** Start a new chunk, firstRow is the number of the first row in it */
+        void clear(unsigned long firstRow)
+        {
+            Values.clear();
+            Rows = 0;
+            FirstRow = firstRow;
+        }
+
+        void readRow(toQuery &query)
+        {
+            for (int i = 1; i < Names.size(); i++)
+            {
+                toQValue v = query.readValue();
+                // same as toResultModel::data(Qt::EditRole)
+                if (v.isComplexType())
+                {
+                    toQValue::complexType *c = v.toQVariant().value<toQValue::complexType*>();
+                    Values.append(QVariant(c->editData()));
+                }
+                else
+                    Values.append(QVariant(v.editData()));
+            }
+            Rows++;
+        }
+
+    private:
+        QStringList Names, Types;
+        QVector<QVariant> Values;
+        unsigned long FirstRow;
+        int Rows;
+};
+
+class toExportStreamThread : public QThread
+{
+    public:
+        toExportStreamThread(toExportStream *stream) : QThread(), Stream(stream) {}
+    protected:
+        void run() override
+        {
+            Stream->run();
+        }
+    private:
+        toExportStream *Stream;
+};
+
+toExportStream::toExportStream(toConnection &conn,
+                               QString const &schema,
+                               QString const &sql,
+                               toQueryParams const &params,
+                               toExportSettings const &settings,
+                               QIODevice *device)
+    : Connection(conn)
+    , Schema(schema)
+    , SQL(sql)
+    , Params(params)
+    , Settings(settings)
+    , Device(device)
+    , Thread(NULL)
+    , Cancel(0)
+    , Rows(0)
+{
+}
+
+toExportStream::~toExportStream()
+{
+    if (Thread)
+    {
+        cancel();
+        Thread->wait();
+        delete Thread;
+    }
+}
+
+bool toExportStream::canStream(toExportSettings const &settings)
+{
+    if (settings.rowsExport != toExportSettings::RowsAll)
+        return false;
+    std::unique_ptr<toListViewFormatter> formatter(toListViewFormatterFactory::Instance().CreateObject(settings.type));
+    return formatter->canStream();
+}
+
+void toExportStream::start(void)
+{
+    Q_ASSERT_X(Thread == NULL, qPrintable(__QHERE__), "Export already started");
+    Thread = new toExportStreamThread(this);
+    connect(Thread, SIGNAL(finished()), this, SIGNAL(finished()));
+    Thread->start();
+}
+
+void toExportStream::cancel(void)
+{
+    Cancel.storeRelease(1);
+}
+
+bool toExportStream::wasCanceled(void) const
+{
+    return Cancel.loadAcquire() != 0;
+}
+
+bool toExportStream::isRunning(void) const
+{
+    return Thread && Thread->isRunning();
+}
+
+bool toExportStream::wait(unsigned long msecs)
+{
+    return !Thread || Thread->wait(msecs);
+}
+
+unsigned long toExportStream::rows(void) const
+{
+    return (unsigned int) Rows.loadAcquire();
+}
+
+QByteArray toExportStream::write(QString &text, bool last)
+{
+    Pending += text.toLocal8Bit();
+    text.clear();
+
+    // CR of a CRLF pair split between two parts must not be converted alone
+    QByteArray part;
+    if (!last && Pending.endsWith('\r'))
+    {
+        part = Pending.left(Pending.size() - 1);
+        Pending = QByteArray(1, '\r');
+    }
+    else
+    {
+        part.swap(Pending);
+    }
+
+    if (part.isEmpty())
+        return part;
+    QByteArray data = Utils::toFileData(part);
+    if (Device->write(data) != data.size())
+        throw QString::fromLatin1("Couldn't write data to file: %1").arg(Device->errorString());
+    return data;
+}
+
+void toExportStream::run(void)
+{
+    try
+    {
+        std::unique_ptr<toListViewFormatter> formatter(toListViewFormatterFactory::Instance().CreateObject(Settings.type));
+        // formatted text of one chunk, encoded and written by write()
+        QString text;
+        QTextStream out(&text);
+
+        QScopedPointer<toConnectionSubLoan> conn(Schema.isEmpty()
+                ? new toConnectionSubLoan(Connection)
+                : new toConnectionSubLoan(Connection, Schema));
+        toQuery query(*conn, SQL, Params);
+        toExportChunkModel chunk(query.describe());
+
+        formatter->writeHeader(out, Settings, &chunk, -1);
+        out.flush();
+        // position of the row count placeholder in the device, -1 if there is none
+        qint64 markPos = -1;
+        QByteArray mark = Utils::toFileData(formatter->rowCountMark(0).toLocal8Bit());
+        qint64 headerPos = Device->pos();
+        QByteArray header = write(text, false);
+        if (!mark.isEmpty() && !Device->isSequential() && header.contains(mark))
+            markPos = headerPos + header.indexOf(mark);
+
+        unsigned long rows = 0;
+        while (!query.eof() && !wasCanceled())
+        {
+            chunk.clear(rows + 1);
+            while (!query.eof() && chunk.rowCount() < ChunkRows)
+                chunk.readRow(query);
+
+            formatter->writeRows(out, Settings, &chunk);
+            out.flush();
+            write(text, false);
+
+            rows += chunk.rowCount();
+            Rows.storeRelease((int) rows);
+            emit progress((int) rows);
+        }
+
+        formatter->writeFooter(out, Settings);
+        out.flush();
+        write(text, true);
+
+        if (markPos >= 0)
+        {
+            qint64 end = Device->pos();
+            QByteArray count = Utils::toFileData(formatter->rowCountMark((int) rows).toLocal8Bit());
+            if (!Device->seek(markPos) || Device->write(count) != count.size() || !Device->seek(end))
+                throw QString::fromLatin1("Couldn't write data to file: %1").arg(Device->errorString());
+        }
+    }
+    catch (QString const &str)
+    {
+        Error = str;
+    }
+    catch (std::exception const &exc)
+    {
+        Error = QString::fromLatin1(exc.what());
+    }
+    catch (...)
+    {
+        Error = QString::fromLatin1("Unknown exception while exporting data");
+    }
+}
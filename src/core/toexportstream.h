@@ -0,0 +1,138 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toqueryimpl.h"
+#include "core/tolistviewformatter.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QObject>
+
+class QIODevice;
+class QThread;
+class toConnection;
+
+/**
+ * Export the result of a query into a QIODevice without holding it in memory.
+ *
+ * The query is executed again in a background thread, on a pooled session switched
+ * to the schema of the session the result was read from (init strings are applied
+ * by @ref toQuery). So it must not be used for results read on a dedicated session
+ * (uncommitted changes, temporary tables).
+ * Rows are read in chunks of @ref ChunkRows, each chunk is passed through the
+ * @ref toListViewFormatter (see toListViewFormatter::writeRows), encoded as by
+ * Utils::toWriteFile (see Utils::toFileData) and written into the device before the
+ * next one is read. So the memory used does not depend on the size of the result.
+ *
+ * The row count some formats hold in the header (see toListViewFormatter::rowCountMark)
+ * is written when all rows are, if the device is not sequential.
+ *
+ * Only toExportSettings::RowsAll is supported, selections are exported from the model.
+ * Progress is reported by the signals @ref progress and @ref finished.
+ */
+class toExportStream : public QObject
+{
+        Q_OBJECT;
+        friend class toExportStreamThread;
+    public:
+        /** Number of rows formatted and written at once */
+        static const int ChunkRows = 1000;
+
+        /**
+         * @param schema schema to execute the query in, empty for any session
+         * @param device opened device, must stay valid till the export is finished
+         */
+        toExportStream(toConnection &conn,
+                       QString const &schema,
+                       QString const &sql,
+                       toQueryParams const &params,
+                       toExportSettings const &settings,
+                       QIODevice *device);
+
+        /** Cancels and waits for the background thread */
+        ~toExportStream();
+
+        /** Return true if the formatter used by settings can be streamed */
+        static bool canStream(toExportSettings const &settings);
+
+        void start(void);
+
+        bool isRunning(void) const;
+
+        /** Wait at most msecs for the export to finish, returns true when finished */
+        bool wait(unsigned long msecs);
+
+        /** Number of rows written so far */
+        unsigned long rows(void) const;
+
+        /** Error message, empty if the export succeeded (valid after @ref wait returned true) */
+        QString const& error(void) const
+        {
+            return Error;
+        }
+
+        bool wasCanceled(void) const;
+
+    public slots:
+        /** Stop after the current chunk, what was written so far stays in the device */
+        void cancel(void);
+
+    signals:
+        /** Emitted from the background thread after each chunk, rows written so far */
+        void progress(int rows);
+
+        /** The background thread finished, see @ref error and @ref wasCanceled */
+        void finished(void);
+
+    private:
+        // executed in the background thread
+        void run(void);
+
+        // encode text and write it into Device, a trailing CR waits for the next part (CRLF)
+        // returns the data written
+        QByteArray write(QString &text, bool last);
+
+        toConnection &Connection;
+        QString Schema;
+        QString SQL;
+        toQueryParams Params;
+        toExportSettings Settings;
+        QIODevice *Device;
+        QByteArray Pending;
+        QThread *Thread;
+        QAtomicInt Cancel;
+        QAtomicInt Rows;
+        QString Error;
+};
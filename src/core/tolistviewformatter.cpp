@@ -35,6 +35,8 @@
 #include "core/tolistviewformatter.h"
 #include "ts_log/ts_log_utils.h"
 
+#include <QtCore/QTextStream>
+
 QVariant ToConfiguration::Exporter::defaultValue(int option) const
 {
     switch (option)
@@ -59,6 +61,37 @@ toListViewFormatter::~toListViewFormatter()
 {
 }
 
+QString toListViewFormatter::getFormattedString(toExportSettings &settings, const QAbstractItemModel * model)
+{
+    QString output;
+    QTextStream out(&output);
+
+    int rows = settings.rowsExport == toExportSettings::RowsSelected ? selectedRows(settings.selected).size() : model->rowCount();
+    writeHeader(out, settings, model, rows);
+    writeRows(out, settings, model);
+    writeFooter(out, settings);
+    out.flush();
+    return output;
+}
+
+bool toListViewFormatter::canStream() const
+{
+    return true;
+}
+
+QString toListViewFormatter::rowCountMark(int) const
+{
+    return QString();
+}
+
+void toListViewFormatter::writeHeader(QTextStream &, toExportSettings &, const QAbstractItemModel *, int)
+{
+}
+
+void toListViewFormatter::writeFooter(QTextStream &, toExportSettings &)
+{
+}
+
 void toListViewFormatter::endLine(QString &output)
 {
 #ifdef Q_OS_WIN32
@@ -68,6 +101,15 @@ void toListViewFormatter::endLine(QString &output)
 #endif
 }
 
+void toListViewFormatter::endLine(QTextStream &out)
+{
+#ifdef Q_OS_WIN32
+    out << "\r\n";
+#else
+    out << "\n";
+#endif
+}
+
 QVector<int> toListViewFormatter::selectedRows(const QModelIndexList &selected)
 {
 
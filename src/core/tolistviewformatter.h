@@ -41,6 +41,7 @@
 #include <QtCore/QVector>
 
 class toListView;
+class QTextStream;
 class toResultModel;
 
 namespace ToConfiguration
@@ -141,10 +142,30 @@ class toListViewFormatter
 public:
 	toListViewFormatter();
 	virtual ~toListViewFormatter();
-	virtual QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model) = 0;
+
+	/** Format the whole model into a string, calls writeHeader, writeRows and writeFooter */
+	virtual QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model);
+
+	/** Streaming export (see @ref toExportStream).
+	 *  writeHeader is called once, then writeRows for each chunk of rows and writeFooter at the end.
+	 *  Formatters which need to see all rows before writing the first one return false
+	 */
+	virtual bool canStream() const;
+
+	/** @param rowCount total number of exported rows, -1 when not known in advance */
+	virtual void writeHeader(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model, int rowCount);
+	virtual void writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model) = 0;
+	virtual void writeFooter(QTextStream &out, toExportSettings &settings);
+
+	/** Text writeHeader puts in place of the row count when it is not known in advance (rowCount -1).
+	 *  toExportStream overwrites it by rowCountMark(rows) when all rows are written, so its length
+	 *  must not depend on rowCount. Empty if the format holds no row count
+	 */
+	virtual QString rowCountMark(int rowCount) const;
 
 protected:
 	virtual void endLine(QString &output);
+	void endLine(QTextStream &out);
 	// build a vector of selected rows for easy searching
 	virtual QVector<int> selectedRows(const QModelIndexList &selected);
 	virtual QVector<int> selectedColumns(const QModelIndexList &selected);
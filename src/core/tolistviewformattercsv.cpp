@@ -37,6 +37,7 @@
 #include "core/tolistviewformatteridentifier.h"
 
 #include <QtCore/QRegExp>
+#include <QtCore/QTextStream>
 
 #include <iostream>
 #include <vector>
@@ -69,41 +70,54 @@ QString toListViewFormatterCSV::QuoteString(const QString &str)
     return t;
 }
 
-QString toListViewFormatterCSV::getFormattedString(toExportSettings &settings,
-        //const toResultModel *model);
-        const QAbstractItemModel * model)
+void toListViewFormatterCSV::writeHeader(QTextStream &out,
+        toExportSettings &settings,
+        const QAbstractItemModel * model,
+        int)
 {
+    if (!settings.columnsHeader)
+        return;
+
     int     columns   = model->columnCount();
-    int     rows      = model->rowCount();
     QString separator = settings.separator;
     QString delimiter = settings.delimiter;
-
     QString output;
-    QString indent;
 
-    QVector<int> rlist = selectedRows(settings.selected);
     QVector<int> clist = selectedColumns(settings.selected);
 
-    if (settings.columnsHeader)
+    for (int j = (settings.rowsHeader ? 0 : 1); j < columns; j++)
     {
-        for (int j = (settings.rowsHeader ? 0 : 1); j < columns; j++)
-        {
-            if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(j))
-                continue;
-            output += QString::fromLatin1("%1%2%3%4").
-                      arg(delimiter).
-                      arg(QuoteString(model->headerData(
-                                          j,
-                                          Qt::Horizontal,
-                                          Qt::DisplayRole).toString())).
-                      arg(delimiter).
-                      arg(separator);
-        }
-        if (output.length() > 0)
-            output = output.left(output.length() - separator.length());
-
-        endLine(output);
+        if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(j))
+            continue;
+        output += QString::fromLatin1("%1%2%3%4").
+                  arg(delimiter).
+                  arg(QuoteString(model->headerData(
+                                      j,
+                                      Qt::Horizontal,
+                                      Qt::DisplayRole).toString())).
+                  arg(delimiter).
+                  arg(separator);
     }
+    if (output.length() > 0)
+        output = output.left(output.length() - separator.length());
+
+    out << output;
+    endLine(out);
+}
+
+void toListViewFormatterCSV::writeRows(QTextStream &out,
+                                       toExportSettings &settings,
+                                       const QAbstractItemModel * model)
+{
+    int     columns   = model->columnCount();
+    int     rows      = model->rowCount();
+    QString separator = settings.separator;
+    QString delimiter = settings.delimiter;
+
+    QString indent;
+
+    QVector<int> rlist = selectedRows(settings.selected);
+    QVector<int> clist = selectedColumns(settings.selected);
 
     QModelIndex mi;
     for (int row = 0; row < rows; row++)
@@ -131,9 +145,7 @@ QString toListViewFormatterCSV::getFormattedString(toExportSettings &settings,
         }
 
         line = line.left(line.length() - separator.length());
-        output += line;
-        endLine(output);
+        out << line;
+        endLine(out);
     }
-
-    return output;
 }
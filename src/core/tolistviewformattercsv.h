@@ -46,8 +46,13 @@ class toListViewFormatterCSV : public toListViewFormatter
     public:
         toListViewFormatterCSV();
         virtual ~toListViewFormatterCSV();
-        virtual QString getFormattedString(toExportSettings &settings,
-                                           const QAbstractItemModel * model);
+        virtual void writeHeader(QTextStream &out,
+                                 toExportSettings &settings,
+                                 const QAbstractItemModel * model,
+                                 int rowCount);
+        virtual void writeRows(QTextStream &out,
+                               toExportSettings &settings,
+                               const QAbstractItemModel * model);
 };
 
 #endif
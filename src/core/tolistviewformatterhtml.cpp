@@ -38,6 +38,7 @@
 #include "core/utils.h"
 
 #include <QtGui/QTextDocument>
+#include <QtCore/QTextStream>
 
 #include <iostream>
 #include "tools/toresultview.h"
@@ -61,25 +62,19 @@ toListViewFormatterHTML::~toListViewFormatterHTML()
 {
 }
 
-QString toListViewFormatterHTML::getFormattedString(toExportSettings &settings, const QAbstractItemModel * model)
+void toListViewFormatterHTML::writeHeader(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model, int)
 {
     int     columns   = model->columnCount();
-    int     rows      = model->rowCount();
-
-    QString output;
-    QString indent;
 
-    QVector<int> rlist = selectedRows(settings.selected);
     QVector<int> clist = selectedColumns(settings.selected);
 
-    output = QString("<HTML><HEAD><TITLE>Export</TITLE></HEAD><BODY><TABLE>");
-    endLine(output);
+    out << "<HTML><HEAD><TITLE>Export</TITLE></HEAD><BODY><TABLE>";
+    endLine(out);
 
-    QString bgcolor;
     if (settings.columnsHeader)
     {
-        output += QString("<TR>");
-        endLine(output);
+        out << "<TR>";
+        endLine(out);
 
         for (int column = 0; column < columns; column++)
         {
@@ -87,21 +82,27 @@ QString toListViewFormatterHTML::getFormattedString(toExportSettings &settings,
                 continue;
             if (!settings.rowsHeader && column == 0)
                 continue;
-            output += QString("\t<TH>");
-            endLine(output);
 
+            out << "\t<TH>";
+            endLine(out);
             QString text = TO_ESCAPE(QString(model->headerData(column, Qt::Horizontal, Qt::DisplayRole).toString()));
-
-            output += "\t\t" + text;
-
-            endLine(output);
-            output += QString("\t</TH>");
-            endLine(output);
+            out << "\t\t" << text;
+            endLine(out);
+            out << "\t</TH>";
+            endLine(out);
         }
-
-        output += "</TR>";
-        endLine(output);
+        out << "</TR>";
+        endLine(out);
     }
+}
+
+void toListViewFormatterHTML::writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model)
+{
+    int     columns   = model->columnCount();
+    int     rows      = model->rowCount();
+
+    QVector<int> rlist = selectedRows(settings.selected);
+    QVector<int> clist = selectedColumns(settings.selected);
 
     QModelIndex mi;
     for (int row = 0; row < rows; row++)
@@ -109,32 +110,30 @@ QString toListViewFormatterHTML::getFormattedString(toExportSettings &settings,
         if (settings.rowsExport == toExportSettings::RowsSelected && !rlist.contains(row))
             continue;
 
-        output += "<TR>";
-        endLine(output);
-
+        out << "<TR>";
+        endLine(out);
         for (int i = 0; i < columns; i++)
         {
             if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(i))
                 continue;
             if (!settings.rowsHeader && i == 0)
                 continue;
-            output += QString("\t<TD>");
-            endLine(output);
 
+            out << "\t<TD>";
+            endLine(out);
             mi = model->index(row, i);
             QString text = TO_ESCAPE(QString(model->data(mi, Qt::EditRole).toString()));
-
-            output += "\t\t" + text;
-            endLine(output);
-
-            output += QString("\t</TD>");
-            endLine(output);
+            out << "\t\t" << text;
+            endLine(out);
+            out << "\t</TD>";
+            endLine(out);
         }
-
-        output += "</TR>";
-        endLine(output);
+        out << "</TR>";
+        endLine(out);
     }
+}
 
-    output += "</TABLE></BODY></HTML>";
-    return output;
+void toListViewFormatterHTML::writeFooter(QTextStream &out, toExportSettings &)
+{
+    out << "</TABLE></BODY></HTML>";
 }
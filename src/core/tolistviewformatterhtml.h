@@ -43,7 +43,9 @@ class toListViewFormatterHTML : public toListViewFormatter
 public:
 	toListViewFormatterHTML();
 	virtual ~toListViewFormatterHTML();
-	QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model) override;
+	void writeHeader(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model, int rowCount) override;
+	void writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model) override;
+	void writeFooter(QTextStream &out, toExportSettings &settings) override;
 };
 
 #endif
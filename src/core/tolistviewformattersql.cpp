@@ -45,7 +45,8 @@
 #include "core/tolistviewformatteridentifier.h"
 #include "core/toeditorconfiguration.h"
 #include "core/utils.h"
-#include "widgets/toresultmodel.h"
+
+#include <QtCore/QTextStream>
 
 namespace
 {
@@ -64,12 +65,11 @@ toListViewFormatterSQL::~toListViewFormatterSQL()
 {}
 
 
-QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
-        //const toResultModel *model);
-        const QAbstractItemModel * model)
+void toListViewFormatterSQL::writeRows(QTextStream &out,
+                                       toExportSettings &settings,
+                                       const QAbstractItemModel * model)
 {
     using namespace ToConfiguration;
-
     toConnection &conn = toConnectionRegistrySing::Instance().currentConnection();
 
     int     columns   = model->columnCount();
@@ -81,7 +81,6 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
     QString sql;
     QString objectName;
     QString columnNames;
-    QString output;
 
     if (toConfigurationNewSingle::Instance().option(Editor::KeywordUpperBool).toBool())
         sql = "INSERT INTO %1%2 VALUES (%3);";
@@ -118,12 +117,12 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
         columnNames = columnNames.left(columnNames.length() - 2) + ")";
     }
 
-    const toResultModel *resultModel = reinterpret_cast<const toResultModel*>(model);
-    if (!model)
-        return "-- cannot access data result. Maybe it's not a SQL export";
+    // column data types (see toResultModel::headerData)
+    QStringList types;
+    for (int i = 0; i < columns; i++)
+        types << model->headerData(i, Qt::Horizontal, Qt::UserRole).toString().toUpper();
 
     QModelIndex mi;
-    toResultModel::HeaderList hdr = resultModel->headers();
     for (int row = 0; row < rows; row++)
     {
         if (settings.rowsExport == toExportSettings::RowsSelected && !rlist.contains(row))
@@ -139,8 +138,7 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
 
             mi = model->index(row, i);
             QVariant currVal(model->data(mi, Qt::EditRole));
-
-            QString h(hdr.at(i).datatype.toUpper());
+            QString const& h = types.at(i);
             if (h.contains("DATE"))
             {
                 if (currVal.toString().isEmpty())
@@ -154,14 +152,10 @@ QString toListViewFormatterSQL::getFormattedString(toExportSettings &settings,
             	values += currVal.toString().isEmpty() ? "NULL" : conn.getTraits().quoteVarchar(currVal.toString());
             else
                 values += currVal.toString().isEmpty() ? "NULL" : currVal.toString();
-
             values += ", ";
         }
         values = values.left(values.length() - 2);
-        QString line(sql.arg(objectName).arg(columnNames).arg(values));
-        endLine(line);
-        output += line;
+        out << sql.arg(objectName).arg(columnNames).arg(values);
+        endLine(out);
     }
-
-    return output;
 }
@@ -50,8 +50,9 @@ class toListViewFormatterSQL : public toListViewFormatter
     public:
         toListViewFormatterSQL();
         virtual ~toListViewFormatterSQL();
-        virtual QString getFormattedString(toExportSettings &settings,
-                                           const QAbstractItemModel * model);
+        virtual void writeRows(QTextStream &out,
+                               toExportSettings &settings,
+                               const QAbstractItemModel * model);
 };
 
 
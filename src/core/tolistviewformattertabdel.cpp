@@ -36,6 +36,8 @@
 #include "core/tolistviewformatterfactory.h"
 #include "core/tolistviewformatteridentifier.h"
 
+#include <QtCore/QTextStream>
+
 #include <iostream>
 #include "tools/toresultview.h"
 
@@ -58,37 +60,45 @@ toListViewFormatterTabDel::~toListViewFormatterTabDel()
 {
 }
 
-QString toListViewFormatterTabDel::getFormattedString(toExportSettings &settings, const QAbstractItemModel * model)
+void toListViewFormatterTabDel::writeHeader(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model, int)
 {
+    if (!settings.columnsHeader)
+        return;
+
     int     columns   = model->columnCount();
-    int     rows      = model->rowCount();
     QString separator("\t");
-
     QString output;
-    QString indent;
 
-    QVector<int> rlist = selectedRows(settings.selected);
     QVector<int> clist = selectedColumns(settings.selected);
 
-    // write header data
-    if (settings.columnsHeader)
+    for (int column = 0; column < columns; column++)
     {
-        for (int column = 0; column < columns; column++)
-        {
-            if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(column))
-                continue;
-            if (!settings.rowsHeader && column == 0)
-                continue;
-            output += QString("%1\t").arg(model->headerData(
-                                              column,
-                                              Qt::Horizontal,
-                                              Qt::DisplayRole).toString());
-        }
-        if (output.length() > 0)
-            output = output.left(output.length() - separator.length());
+        if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(column))
+            continue;
+        if (!settings.rowsHeader && column == 0)
+            continue;
 
-        endLine(output);
+        output += QString("%1\t").arg(model->headerData(
+                                          column,
+                                          Qt::Horizontal,
+                                          Qt::DisplayRole).toString());
     }
+    if (output.length() > 0)
+        output = output.left(output.length() - separator.length());
+
+    out << output;
+    endLine(out);
+}
+
+void toListViewFormatterTabDel::writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model)
+{
+    int     columns   = model->columnCount();
+    int     rows      = model->rowCount();
+    QString separator("\t");
+    QString indent;
+
+    QVector<int> rlist = selectedRows(settings.selected);
+    QVector<int> clist = selectedColumns(settings.selected);
 
     QModelIndex mi;
     for (int row = 0; row < rows; row++)
@@ -103,16 +113,14 @@ QString toListViewFormatterTabDel::getFormattedString(toExportSettings &settings
                 continue;
             if (!settings.rowsHeader && i == 0)
                 continue;
+
             mi = model->index(row, i);
             QString text = model->data(mi, Qt::EditRole).toString();
             line += indent;
             line += QString::fromLatin1("%1\t").arg(text);
         }
-
         line = line.left(line.length() - separator.length());
-        output += line;
-        endLine(output);
+        out << line;
+        endLine(out);
     }
-
-    return output;
 }
@@ -43,9 +43,13 @@ class toListViewFormatterTabDel : public toListViewFormatter
     public:
         toListViewFormatterTabDel();
         virtual ~toListViewFormatterTabDel();
-        //virtual QString getFormattedString(toListView& tListView);
-        virtual QString getFormattedString(toExportSettings &settings,
-                                           const QAbstractItemModel * model);
+        virtual void writeHeader(QTextStream &out,
+                                 toExportSettings &settings,
+                                 const QAbstractItemModel * model,
+                                 int rowCount);
+        virtual void writeRows(QTextStream &out,
+                               toExportSettings &settings,
+                               const QAbstractItemModel * model);
 };
 
 #endif
@@ -37,6 +37,7 @@
 #include "core/tolistviewformatteridentifier.h"
 
 #include <QtCore/QVector>
+#include <QtCore/QTextStream>
 
 #include <iostream>
 #include "tools/toresultview.h"
@@ -166,3 +167,13 @@ QString toListViewFormatterText::getFormattedString(toExportSettings &settings,
 
     return output;
 }
+
+bool toListViewFormatterText::canStream() const
+{
+    return false;
+}
+
+void toListViewFormatterText::writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model)
+{
+    out << getFormattedString(settings, model);
+}
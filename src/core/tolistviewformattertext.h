@@ -42,4 +42,8 @@ class toListViewFormatterText : public toListViewFormatter
         toListViewFormatterText();
 
         QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model) override;
+
+        /** Column widths are computed from all rows, can not be streamed */
+        bool canStream() const override;
+        void writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model) override;
 };
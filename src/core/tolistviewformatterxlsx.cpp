@@ -37,6 +37,7 @@
 #include "core/tolistviewformatteridentifier.h"
 
 #include <QtCore/QVector>
+#include <QtCore/QTextStream>
 
 #include <iostream>
 #include "tools/toresultview.h"
@@ -54,68 +55,80 @@ toListViewFormatterXLSX::toListViewFormatterXLSX() : toListViewFormatter()
 {
 }
 
-QString toListViewFormatterXLSX::getFormattedString(toExportSettings &settings, const QAbstractItemModel * model)
+// Thx to ClipView tool
+static QString const DOC_START(
+"<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n"
+"<?mso-application progid=\"Excel.Sheet\"?>\r\n"
+"<Workbook xmlns=\"urn:schemas-microsoft-com:office:spreadsheet\"\r\n"
+" xmlns:o=\"urn:schemas-microsoft-com:office:office\"\r\n"
+" xmlns:x=\"urn:schemas-microsoft-com:office:excel\"\r\n"
+" xmlns:ss=\"urn:schemas-microsoft-com:office:spreadsheet\"\r\n"
+" xmlns:html=\"http://www.w3.org/TR/REC-html40\">\r\n"
+" <Worksheet ss:Name=\"Sheet1\">\r\n"
+);
+static QString const TABLE_START("  <Table ss:ExpandedColumnCount=\"%1\" %2>\r\n");
+// fixed width, while streaming it is written before the row count is known and overwritten at the end
+static QString const ROW_COUNT("ss:ExpandedRowCount=\"%1\"");
+static QString const ROW_START("   <Row>\r\n");
+static QString const ROW_LINE ("    <Cell><Data ss:Type=\"%1\">%2</Data></Cell>\r\n");
+static QString const ROW_END  ("   </Row>\r\n");
+static QString const DOC_END  (
+"  </Table>\r\n"
+" </Worksheet>\r\n"
+"</Workbook>\r\n"
+);
+
+void toListViewFormatterXLSX::writeHeader(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model, int rowCount)
 {
-    // Thx to ClipView tool
-    static QString const DOC_START(
-    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n"
-    "<?mso-application progid=\"Excel.Sheet\"?>\r\n"
-    "<Workbook xmlns=\"urn:schemas-microsoft-com:office:spreadsheet\"\r\n"
-    " xmlns:o=\"urn:schemas-microsoft-com:office:office\"\r\n"
-    " xmlns:x=\"urn:schemas-microsoft-com:office:excel\"\r\n"
-    " xmlns:ss=\"urn:schemas-microsoft-com:office:spreadsheet\"\r\n"
-    " xmlns:html=\"http://www.w3.org/TR/REC-html40\">\r\n"
-    " <Worksheet ss:Name=\"Sheet1\">\r\n"
-    "  <Table ss:ExpandedColumnCount=\"%1\" ss:ExpandedRowCount=\"%2\">\r\n"
-    );
-    static QString const ROW_START("   <Row>\r\n");
-    static QString const ROW_LINE ("    <Cell><Data ss:Type=\"%1\">%2</Data></Cell>\r\n");
-    static QString const ROW_END  ("   </Row>\r\n");
-    static QString const DOC_END  (
-    "  </Table>\r\n"
-    " </Worksheet>\r\n"
-    "</Workbook>\r\n"
-    );
-
     int columns = model->columnCount();
-    int rows    = model->rowCount();
-
-    QString output;
 
-    QVector<int> rlist = selectedRows(settings.selected);
     QVector<int> clist = selectedColumns(settings.selected);
 
     // -1 for XLSX does not support row number
     int columnCount = settings.columnsExport == toExportSettings::ColumnsSelected ? clist.size()-1 : columns;
-    int rowCount    = settings.rowsExport    == toExportSettings::RowsSelected    ? rlist.size()   : rows;
 
-    output += DOC_START.arg(columnCount).arg(rowCount);
+    out << DOC_START;
+    out << TABLE_START.arg(columnCount).arg(rowCountMark(rowCount < 0 ? 0 : rowCount));
+}
+
+void toListViewFormatterXLSX::writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model)
+{
+    int columns = model->columnCount();
+    int rows    = model->rowCount();
+
+    QVector<int> rlist = selectedRows(settings.selected);
+    QVector<int> clist = selectedColumns(settings.selected);
+
     // write data
     for (int row = 0; row < rows; row++)
     {
         if (settings.rowsExport == toExportSettings::RowsSelected && !rlist.contains(row))
             continue;
 
-        output += ROW_START;
+        out << ROW_START;
         for (int column = 1; column < columns; column++)
         {
             if (settings.columnsExport == toExportSettings::ColumnsSelected && !clist.contains(column))
                 continue;
 
             QVariant data = model->data(model->index(row, column), Qt::EditRole);
-            QVariant type = model->headerData(column, Qt::Horizontal, Qt::UserRole);
-
             QString value;
             if (data.isNull())
                 value = "{null}";
             else
                 value = TO_ESCAPE(data.toString());
-
-            output += ROW_LINE.arg("String").arg(value);
+            out << ROW_LINE.arg("String").arg(value);
         }
-        output += ROW_END;
+        out << ROW_END;
     }
-    output += DOC_END;
+}
 
-    return output;
+void toListViewFormatterXLSX::writeFooter(QTextStream &out, toExportSettings &)
+{
+    out << DOC_END;
+}
+
+QString toListViewFormatterXLSX::rowCountMark(int rowCount) const
+{
+    return ROW_COUNT.arg(rowCount, 10, 10, QLatin1Char('0'));
 }
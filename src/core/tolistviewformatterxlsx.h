@@ -40,5 +40,8 @@ class toListViewFormatterXLSX: public toListViewFormatter
 {
     public:
         toListViewFormatterXLSX();
-        QString getFormattedString(toExportSettings &settings, const QAbstractItemModel * model) override;
+        void writeHeader(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model, int rowCount) override;
+        void writeRows(QTextStream &out, toExportSettings &settings, const QAbstractItemModel * model) override;
+        void writeFooter(QTextStream &out, toExportSettings &settings) override;
+        QString rowCountMark(int rowCount) const override;
 };
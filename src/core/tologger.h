@@ -16,6 +16,7 @@
 #include "ts_log/ts_log_utils.h"
 #include "ts_log/decorator.h"
 #include "ts_log/toostream.h"
+#include "core/toringlog.h"
 
 #include <iostream>
 #include <QtCore/QString>
@@ -46,9 +47,30 @@ using namespace boost::iostreams;
 // TLOG(1, toDecorator, __HERE__) << "The value for a is:" << a << std::endl;
 // TLOG(5, toNoDecorator, __HERE__) << "The value for a is:" << a << std::endl;
 ////////////////////////////////////////////////////////////////////////////////
-#define TLOG(lognumber, decorator, where) get_log(lognumber).ts<decorator>(where)
+//
+// Disabled log channels (DISABLE_LOG) are skipped entirely, neither the stream
+// nor the location and the arguments are built.
+// For hot paths use TLOGF (see toringlog.h), it is compiled in all builds.
+////////////////////////////////////////////////////////////////////////////////
+// The expansion is a single expression (not an if/else) so that TLOG can be
+// used as the body of an unbraced if without -Wdangling-else.
+#define TLOG(lognumber, decorator, where)                                      \
+    !templ_log_enabled(static_cast<int_to_type<lognumber>*>(NULL)) ? (void) 0 \
+    : toLogVoidify() & get_log(lognumber).ts<decorator>(where)
+
+/** Turns the stream expression of TLOG into void, operator& binds looser than << */
+struct toLogVoidify
+{
+    template<typename T>
+    inline void operator&(T const&) const {}
+};
 
 #define DISABLE_LOG(lognumber)                                                 \
+    template<>                                                                 \
+    inline bool templ_log_enabled(int_to_type<lognumber>*)                     \
+    {                                                                          \
+        return false;                                                          \
+    }                                                                          \
     template<>                                                                 \
     inline thread_safe_log templ_get_log_ownthread(int_to_type<lognumber>*)    \
     {                                                                          \
@@ -135,6 +157,12 @@ TSLOG_TYPELIST_2(timeTotalDecorator<DEFAULT_THREAD_MANAGER>,
 // macros DISABLE_LOG, DOCKLET_LOG generate templates specialization
 // these classes use other outputs
 ////////////////////////////////////////////////////////////////////////////////
+template< int idxLog>
+inline bool templ_log_enabled( int_to_type< idxLog> *i = NULL )
+{
+    return true;
+}
+
 template< int idxLog>
 inline thread_safe_log templ_get_log_ownthread( int_to_type< idxLog> *i = NULL )
 {
@@ -214,6 +242,7 @@ inline thread_safe_log get_log(int idxLog)
 
 #include "ts_log/ts_log_utils.h"
 #include "ts_log/decorator.h"
+#include "core/toringlog.h"
 #include <QtCore/QString>
 
 #define TLOG(lognumber, decorator, where) get_null_log()
@@ -138,6 +138,12 @@ class toQueryAbstr : public QObject
                 return m_rowsProcessed;
         }
 
+        /** Get the number of fetch calls (round trips) done so far, 0 if not known. */
+        inline unsigned long fetchCount(void)
+        {
+            return m_Query ? m_Query->fetchCount() : 0;
+        }
+
         /** Get a list of descriptions for the columns. This function is relatively slow. */
         toQColumnDescriptionList describe(void);
 
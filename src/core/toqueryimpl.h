@@ -103,6 +103,13 @@ class TORA_EXPORT queryImpl : public QObject
          * thread than is executing the query.
          */
         virtual void cancel(void) = 0;
+
+        /** Number of fetch calls (server round trips) done so far, 0 if not known.
+         */
+        virtual unsigned long fetchCount(void)
+        {
+            return 0;
+        }
     private:
         toQueryAbstr *Parent;
     protected:
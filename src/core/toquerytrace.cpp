@@ -0,0 +1,271 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toquerytrace.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+
+toQueryTrace::toQueryTrace(QString const& sql, QString const& connection)
+    : m_sql(sql.simplified().left(1000))
+    , m_connection(connection)
+    , m_started(QDateTime::currentDateTime())
+    , m_start(now())
+    , m_end(0)
+    , m_rows(0)
+    , m_roundTrips(0)
+    , m_bytes(0)
+    , m_deliveryMark(0)
+    , m_finished(0)
+{
+}
+
+namespace
+{
+    struct toQueryTraceClock
+    {
+        toQueryTraceClock()
+        {
+            Timer.start();
+        }
+        QElapsedTimer Timer;
+    };
+}
+
+qint64 toQueryTrace::now()
+{
+    static toQueryTraceClock clock;
+    return clock.Timer.nsecsElapsed();
+}
+
+QString toQueryTrace::phaseName(Phase phase)
+{
+    switch (phase)
+    {
+        case LOAN_WAIT:
+            return QString::fromLatin1("Loan wait");
+        case INIT:
+            return QString::fromLatin1("Session init");
+        case EXECUTE:
+            return QString::fromLatin1("Execute");
+        case FETCH:
+            return QString::fromLatin1("Fetch");
+        case CONVERT:
+            return QString::fromLatin1("Convert");
+        case DELIVERY:
+            return QString::fromLatin1("Delivery");
+        case MODEL:
+            return QString::fromLatin1("Model");
+        default:
+            return QString();
+    }
+}
+
+void toQueryTrace::addSpan(Phase phase, qint64 start, qint64 duration)
+{
+    m_totals[phase].fetchAndAddRelaxed(duration);
+    QMutexLocker lock(&m_lock);
+    if (m_spans.size() < MAX_SPANS)
+    {
+        Span s;
+        s.phase = phase;
+        s.start = start;
+        s.duration = duration;
+        s.thread = (quintptr) QThread::currentThreadId();
+        m_spans.append(s);
+    }
+}
+
+void toQueryTrace::addTime(Phase phase, qint64 duration)
+{
+    m_totals[phase].fetchAndAddRelaxed(duration);
+}
+
+void toQueryTrace::addRows(quint64 rows, qint64 bytes)
+{
+    m_rows.fetchAndAddRelaxed(rows);
+    m_bytes.fetchAndAddRelaxed(bytes);
+}
+
+void toQueryTrace::setRoundTrips(quint64 trips)
+{
+    m_roundTrips.store(trips);
+}
+
+void toQueryTrace::markDelivery()
+{
+    m_deliveryMark.storeRelease(now());
+}
+
+void toQueryTrace::delivered()
+{
+    qint64 mark = m_deliveryMark.fetchAndStoreAcquire(0);
+    if (mark)
+        addSpan(DELIVERY, mark, now() - mark);
+}
+
+void toQueryTrace::setError(QString const& error)
+{
+    QMutexLocker lock(&m_lock);
+    m_error = error;
+}
+
+QString toQueryTrace::error() const
+{
+    QMutexLocker lock(&m_lock);
+    return m_error;
+}
+
+bool toQueryTrace::finish()
+{
+    if (!m_finished.testAndSetOrdered(0, 1))
+        return false;
+    m_end.store(now());
+    return true;
+}
+
+qint64 toQueryTrace::elapsed() const
+{
+    qint64 end = m_end.load();
+    return (end ? end : now()) - m_start;
+}
+
+QVector<toQueryTrace::Span> toQueryTrace::spans() const
+{
+    QMutexLocker lock(&m_lock);
+    return m_spans;
+}
+
+toQueryTraceRegistry::toQueryTraceRegistry()
+    : QObject(NULL)
+{
+}
+
+void toQueryTraceRegistry::add(QSharedPointer<toQueryTrace> const& trace)
+{
+    {
+        QMutexLocker lock(&m_lock);
+        m_traces.append(trace);
+        while (m_traces.size() > MAX_TRACES)
+            m_traces.removeFirst();
+    }
+    QMetaObject::invokeMethod(this, "changed", Qt::QueuedConnection);
+}
+
+void toQueryTraceRegistry::clear()
+{
+    {
+        QMutexLocker lock(&m_lock);
+        m_traces.clear();
+    }
+    emit changed();
+}
+
+QList<QSharedPointer<toQueryTrace> > toQueryTraceRegistry::recent() const
+{
+    QMutexLocker lock(&m_lock);
+    return m_traces;
+}
+
+QByteArray toQueryTraceRegistry::exportJson() const
+{
+    QJsonArray queries;
+    Q_FOREACH(QSharedPointer<toQueryTrace> const& t, recent())
+    {
+        QJsonObject q;
+        q.insert("sql", t->sql());
+        q.insert("connection", t->connection());
+        q.insert("started", t->started().toString(Qt::ISODate));
+        q.insert("elapsedUs", double(t->elapsed() / 1000));
+        q.insert("rows", double(t->rows()));
+        q.insert("bytes", double(t->bytes()));
+        q.insert("roundTrips", double(t->roundTrips()));
+        if (!t->error().isEmpty())
+            q.insert("error", t->error());
+
+        QJsonObject phases;
+        for (int p = 0; p < toQueryTrace::PHASES; p++)
+            phases.insert(toQueryTrace::phaseName((toQueryTrace::Phase) p), double(t->total((toQueryTrace::Phase) p) / 1000));
+        q.insert("phasesUs", phases);
+        queries.append(q);
+    }
+    return QJsonDocument(queries).toJson();
+}
+
+QByteArray toQueryTraceRegistry::exportChromeTrace() const
+{
+    // Complete events ("ph":"X"), timestamps in us
+    QJsonArray events;
+    Q_FOREACH(QSharedPointer<toQueryTrace> const& t, recent())
+    {
+        QJsonObject args;
+        args.insert("sql", t->sql());
+        args.insert("rows", double(t->rows()));
+        args.insert("bytes", double(t->bytes()));
+        args.insert("roundTrips", double(t->roundTrips()));
+        if (!t->error().isEmpty())
+            args.insert("error", t->error());
+
+        QJsonObject query;
+        query.insert("name", t->sql().left(80));
+        query.insert("cat", QString::fromLatin1("query"));
+        query.insert("ph", QString::fromLatin1("X"));
+        query.insert("ts", double(t->startTime() / 1000));
+        query.insert("dur", double(t->elapsed() / 1000));
+        query.insert("pid", 1);
+        query.insert("tid", 0);
+        query.insert("args", args);
+        events.append(query);
+
+        Q_FOREACH(toQueryTrace::Span const& s, t->spans())
+        {
+            QJsonObject span;
+            span.insert("name", toQueryTrace::phaseName(s.phase));
+            span.insert("cat", QString::fromLatin1("phase"));
+            span.insert("ph", QString::fromLatin1("X"));
+            span.insert("ts", double(s.start / 1000));
+            span.insert("dur", double(s.duration / 1000));
+            span.insert("pid", 1);
+            span.insert("tid", double(s.thread));
+            events.append(span);
+        }
+    }
+    QJsonObject root;
+    root.insert("traceEvents", events);
+    root.insert("displayTimeUnit", QString::fromLatin1("ms"));
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,212 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tora_export.h"
+#include "loki/Singleton.h"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+/**
+ * Latency breakdown of one query run by toEventQuery.
+ *
+ * Spans are recorded along toEventQuery -> toEventQueryWorker -> queryImpl -> toResultModel,
+ * from the main and the background thread. Totals per phase are atomic, the span list is
+ * guarded by a mutex and bounded (MAX_SPANS). Finished traces are kept by @ref toQueryTraceRegistry.
+ */
+class TORA_EXPORT toQueryTrace
+{
+    public:
+        enum Phase
+        {
+            LOAN_WAIT = 0,  // waiting for a connection loan
+            INIT,           // schema switch and session init statements
+            EXECUTE,        // execute and describe
+            FETCH,          // fetch round trips (queryImpl::eof)
+            CONVERT,        // conversion into toQValue (queryImpl::readValue)
+            DELIVERY,       // worker's data() signal until the main thread handled it
+            MODEL,          // insertion into toResultModel
+            PHASES
+        };
+
+        enum
+        {
+            MAX_SPANS = 512
+        };
+
+        struct Span
+        {
+            Phase phase;
+            qint64 start;       // ns, see now()
+            qint64 duration;    // ns
+            quintptr thread;
+        };
+
+        toQueryTrace(QString const& sql, QString const& connection);
+
+        /** Monotonic process wide clock in ns */
+        static qint64 now();
+        static QString phaseName(Phase phase);
+
+        void addSpan(Phase phase, qint64 start, qint64 duration);
+        /** Add to the phase total only (no span), used for short repeated work */
+        void addTime(Phase phase, qint64 duration);
+        void addRows(quint64 rows, qint64 bytes);
+        void setRoundTrips(quint64 trips);
+
+        /** Worker is about to signal data, main thread calls delivered() when it handles the signal */
+        void markDelivery();
+        void delivered();
+
+        void setError(QString const& error);
+        /** Query is gone, stops the wall clock.
+         *  @return true on the first call, the caller then adds the trace to @ref toQueryTraceRegistry
+         */
+        bool finish();
+
+        QString const& sql() const
+        {
+            return m_sql;
+        }
+        QString const& connection() const
+        {
+            return m_connection;
+        }
+        QDateTime const& started() const
+        {
+            return m_started;
+        }
+        qint64 startTime() const
+        {
+            return m_start;
+        }
+        /** Wall time from creation until finish (or now) in ns */
+        qint64 elapsed() const;
+        qint64 total(Phase phase) const
+        {
+            return m_totals[phase].load();
+        }
+        quint64 rows() const
+        {
+            return m_rows.load();
+        }
+        qint64 bytes() const
+        {
+            return m_bytes.load();
+        }
+        quint64 roundTrips() const
+        {
+            return m_roundTrips.load();
+        }
+        QString error() const;
+        QVector<Span> spans() const;
+
+        /** Record a span of phase for the life time of the scope, does nothing if trace is null */
+        class Scope
+        {
+            public:
+                Scope(QSharedPointer<toQueryTrace> const& trace, Phase phase)
+                    : m_trace(trace)
+                    , m_phase(phase)
+                    , m_start(trace ? now() : 0)
+                {}
+                ~Scope()
+                {
+                    if (m_trace)
+                        m_trace->addSpan(m_phase, m_start, now() - m_start);
+                }
+            private:
+                QSharedPointer<toQueryTrace> m_trace;
+                Phase m_phase;
+                qint64 m_start;
+        };
+
+    private:
+        QString m_sql, m_connection;
+        QDateTime m_started;
+        qint64 m_start;
+        QAtomicInteger<qint64> m_end;
+        QAtomicInteger<qint64> m_totals[PHASES];
+        QAtomicInteger<quint64> m_rows, m_roundTrips;
+        QAtomicInteger<qint64> m_bytes;
+        QAtomicInteger<qint64> m_deliveryMark;
+        QAtomicInt m_finished;
+
+        mutable QMutex m_lock;
+        QVector<Span> m_spans;
+        QString m_error;
+};
+
+/** Keeps the recently finished query traces */
+class TORA_EXPORT toQueryTraceRegistry : public QObject
+{
+        Q_OBJECT;
+    public:
+        enum
+        {
+            MAX_TRACES = 200
+        };
+
+        toQueryTraceRegistry();
+
+        /** Called from any thread */
+        void add(QSharedPointer<toQueryTrace> const& trace);
+        void clear();
+
+        /** Most recent last */
+        QList<QSharedPointer<toQueryTrace> > recent() const;
+
+        /** Export traces as plain JSON, one object per query */
+        QByteArray exportJson() const;
+        /** Export traces in Chrome trace event format (chrome://tracing, Perfetto) */
+        QByteArray exportChromeTrace() const;
+
+    signals:
+        /** Emitted (queued) when a trace was added or the list cleared */
+        void changed();
+
+    private:
+        mutable QMutex m_lock;
+        QList<QSharedPointer<toQueryTrace> > m_traces;
+};
+
+typedef Loki::SingletonHolder<toQueryTraceRegistry, Loki::CreateUsingNew, Loki::NoDestroy> toQueryTraceRegistrySingle;
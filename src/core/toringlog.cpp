@@ -0,0 +1,337 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "core/toringlog.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+
+#include <iostream>
+
+namespace
+{
+    struct toRingLogRecord
+    {
+        char const* format;
+        char const* where;
+        qint64 time;
+        quint8 log;
+        quint8 count;
+        quint8 types[toRingLog::MAX_ARGS];
+        union
+        {
+            qint64 i;
+            quint64 u;
+            double d;
+            void const* p;
+        } args[toRingLog::MAX_ARGS];
+        char text[toRingLog::TEXT_SIZE]; // 8 byte aligned, UTF-16 arguments start at even offsets
+    };
+
+    /** Written only by the owning thread (Head), read by the consumer (Tail) */
+    struct toRingLogBuffer
+    {
+        toRingLogBuffer()
+            : Thread((quintptr)QThread::currentThreadId())
+        {}
+
+        QAtomicInteger<quint32> Head, Tail;
+        QAtomicInt Orphaned;
+        quintptr Thread;
+        toRingLogRecord Records[toRingLog::BUFFER_RECORDS];
+    };
+
+    /** Marks the thread's buffer as orphaned when the thread exits, consumer deletes it then */
+    struct toRingLogBufferHolder
+    {
+        toRingLogBufferHolder() : Buffer(NULL) {}
+        ~toRingLogBufferHolder()
+        {
+            if (Buffer)
+                Buffer->Orphaned.storeRelease(1);
+        }
+        toRingLogBuffer *Buffer;
+    };
+
+    void stderrSink(int log, QString const& line)
+    {
+        std::cerr << '<' << log << "> " << line.toLocal8Bit().constData() << std::endl;
+    }
+
+    class toRingLogConsumer : public QThread
+    {
+        public:
+            toRingLogConsumer()
+                : Stop(0)
+                , Sink(&stderrSink)
+            {
+                setObjectName("toRingLog consumer");
+            }
+
+            void run() override
+            {
+                while (!Stop.loadAcquire())
+                {
+                    drain();
+                    msleep(50);
+                }
+                drain();
+            }
+
+            void registerBuffer(toRingLogBuffer *buffer)
+            {
+                QMutexLocker lock(&BuffersLock);
+                Buffers.append(buffer);
+                if (!isRunning() && !Stop.loadAcquire())
+                    start(QThread::LowestPriority);
+            }
+
+            void drain();
+
+            QAtomicInt Stop, Dropped;
+            toRingLog::Sink Sink;
+            QMutex SinkLock;
+
+        private:
+            QString format(toRingLogRecord const& r, quintptr thread);
+
+            QMutex BuffersLock;
+            QList<toRingLogBuffer*> Buffers;
+            QMutex DrainLock; // single consumer
+    };
+
+    void stopConsumer();
+
+    toRingLogConsumer* createConsumer()
+    {
+        // Drain the last records when the application exits, whichever thread logged first
+        qAddPostRoutine(stopConsumer);
+        return new toRingLogConsumer();
+    }
+
+    toRingLogConsumer& consumer()
+    {
+        // Never deleted, producers can still log during static destruction
+        static toRingLogConsumer *c = createConsumer();
+        return *c;
+    }
+
+    void stopConsumer()
+    {
+        toRingLogConsumer &c = consumer();
+        c.Stop.storeRelease(1);
+        c.wait();
+        c.drain();
+    }
+
+    quint32 initialMask()
+    {
+        QByteArray env = qgetenv("TORA_LOG");
+        quint32 retval = 0;
+#if defined(DEBUG) || defined(TORA_EXPERIMENTAL)
+        // channels enabled in tologger.h
+        retval |= (1u << 0) | (1u << 5) | (1u << 8);
+#endif
+        if (env == "all")
+            return ~0u;
+        Q_FOREACH(QByteArray const& n, env.split(','))
+        {
+            bool ok;
+            int log = n.trimmed().toInt(&ok);
+            if (ok && log >= 0 && log < toRingLog::MAX_LOGS)
+                retval |= 1u << log;
+        }
+        return retval;
+    }
+}
+
+// Logs are disabled until this is initialized
+QAtomicInteger<quint32> toRingLog::Mask(initialMask());
+
+void toRingLogConsumer::drain()
+{
+    QMutexLocker dLock(&DrainLock);
+    QList<toRingLogBuffer*> buffers;
+    {
+        QMutexLocker lock(&BuffersLock);
+        buffers = Buffers;
+    }
+
+    Q_FOREACH(toRingLogBuffer *b, buffers)
+    {
+        bool orphaned = b->Orphaned.loadAcquire();
+        quint32 tail = b->Tail.load();
+        quint32 head = b->Head.loadAcquire();
+        for (; tail != head; tail++)
+        {
+            toRingLogRecord const& r = b->Records[tail & (toRingLog::BUFFER_RECORDS - 1)];
+            QString line = format(r, b->Thread);
+            QMutexLocker sLock(&SinkLock);
+            Sink(r.log, line);
+        }
+        b->Tail.storeRelease(tail);
+
+        if (orphaned)
+        {
+            QMutexLocker lock(&BuffersLock);
+            Buffers.removeAll(b);
+            delete b;
+        }
+    }
+}
+
+QString toRingLogConsumer::format(toRingLogRecord const& r, quintptr thread)
+{
+    QString msg = QString::fromUtf8(r.format);
+    for (int i = 0; i < r.count; i++)
+    {
+        switch (r.types[i])
+        {
+            case toRingLog::Arg::INT:
+                msg = msg.arg(r.args[i].i);
+                break;
+            case toRingLog::Arg::UINT:
+                msg = msg.arg(r.args[i].u);
+                break;
+            case toRingLog::Arg::DOUBLE:
+                msg = msg.arg(r.args[i].d);
+                break;
+            case toRingLog::Arg::POINTER:
+                msg = msg.arg(QString::fromLatin1("0x%1").arg((quintptr)r.args[i].p, 0, 16));
+                break;
+            case toRingLog::Arg::TEXT_UTF8:
+                msg = msg.arg(QString::fromUtf8(r.text + (r.args[i].u >> 16), r.args[i].u & 0xffff));
+                break;
+            case toRingLog::Arg::TEXT_QSTRING:
+                msg = msg.arg(QString((QChar const*) (r.text + (r.args[i].u >> 16)), r.args[i].u & 0xffff));
+                break;
+        }
+    }
+    return QString::fromLatin1("%1 <%2> %3 %4")
+           .arg(QDateTime::fromMSecsSinceEpoch(r.time).toString("hh:mm:ss.zzz"))
+           .arg(thread, 0, 16)
+           .arg(QString::fromLatin1(r.where))
+           .arg(msg);
+}
+
+void toRingLog::setEnabled(int log, bool enabled)
+{
+    if (log < 0 || log >= MAX_LOGS)
+        return;
+    if (enabled)
+        Mask.fetchAndOrOrdered(1u << log);
+    else
+        Mask.fetchAndAndOrdered(~(1u << log));
+}
+
+void toRingLog::setSink(Sink sink)
+{
+    toRingLogConsumer &c = consumer();
+    QMutexLocker lock(&c.SinkLock);
+    c.Sink = sink ? sink : &stderrSink;
+}
+
+void toRingLog::flush()
+{
+    consumer().drain();
+}
+
+int toRingLog::dropped()
+{
+    return consumer().Dropped.load();
+}
+
+void toRingLog::append(int log, char const* where, char const* format, Arg const* args, int count)
+{
+    static thread_local toRingLogBufferHolder holder;
+    toRingLogBuffer *b = holder.Buffer;
+    if (!b)
+    {
+        b = holder.Buffer = new toRingLogBuffer();
+        consumer().registerBuffer(b);
+    }
+
+    quint32 head = b->Head.load();
+    if (head - b->Tail.loadAcquire() >= (quint32) BUFFER_RECORDS)
+    {
+        consumer().Dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    toRingLogRecord &r = b->Records[head & (BUFFER_RECORDS - 1)];
+    r.format = format;
+    r.where = where;
+    r.time = QDateTime::currentMSecsSinceEpoch();
+    r.log = log;
+    r.count = count;
+    int textPos = 0;
+    for (int i = 0; i < count; i++)
+    {
+        Arg const& a = args[i];
+        r.types[i] = a.type;
+        switch (a.type)
+        {
+            case Arg::TEXT_UTF8:
+                {
+                    int len = qMax(qMin(a.length, TEXT_SIZE - textPos), 0);
+                    if (len > 0)
+                        memcpy(r.text + textPos, a.value.p, len);
+                    r.args[i].u = ((quint64) textPos << 16) | (quint64) len;
+                    textPos += len;
+                }
+                break;
+            case Arg::TEXT_QSTRING:
+                {
+                    // raw UTF-16 copy, the conversion is left to the consumer
+                    QString const* str = static_cast<QString const*>(a.value.p);
+                    textPos = (textPos + 1) & ~1;
+                    int len = qMax(qMin(str->size(), (TEXT_SIZE - textPos) / 2), 0);
+                    if (len > 0 && len < str->size() && str->at(len - 1).isHighSurrogate())
+                        len--;
+                    if (len > 0)
+                        memcpy(r.text + textPos, str->constData(), len * sizeof(QChar));
+                    r.args[i].u = ((quint64) textPos << 16) | (quint64) len;
+                    textPos += len * sizeof(QChar);
+                }
+                break;
+            default:
+                r.args[i].u = a.value.u;
+        }
+    }
+    b->Head.storeRelease(head + 1);
+}
@@ -0,0 +1,151 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tora_export.h"
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QString>
+
+#include <string>
+#include <string.h>
+
+/** Low overhead binary log.
+ *
+ * Each thread writes fixed size records into its own lock-free ring buffer (single producer,
+ * single consumer). A record holds a pointer to the static format string, the source location
+ * and up to MAX_ARGS raw arguments, strings are copied (truncated) into the record, QStrings as raw
+ * UTF-16 so the producer never converts them. Formatting
+ * (QString::arg style placeholders %1..%4) is done by the consumer thread, which drains the buffers
+ * periodically and passes the lines to a sink (stderr by default).
+ *
+ * Logs are enabled at runtime by a bit mask. A disabled log costs one relaxed atomic load.
+ * Initial mask is taken from the TORA_LOG environment variable (comma separated log numbers, or "all").
+ * When a ring buffer is full the record is dropped and counted, the producer never blocks.
+ *
+ * Usage:
+ * TLOGF(6, "eof(%1)", Query->row_count());
+ */
+class TORA_EXPORT toRingLog
+{
+    public:
+        enum
+        {
+            MAX_LOGS = 32,
+            MAX_ARGS = 4,
+            TEXT_SIZE = 96,
+            BUFFER_RECORDS = 1024 // must be power of 2
+        };
+
+        /** One raw argument, implicitly constructed from the supported types */
+        class Arg
+        {
+            public:
+                enum Type
+                {
+                    NONE = 0,
+                    INT,
+                    UINT,
+                    DOUBLE,
+                    POINTER,
+                    TEXT_UTF8,
+                    TEXT_QSTRING
+                };
+
+                Arg() : type(NONE) {}
+                Arg(bool v) : type(INT) { value.i = v; }
+                Arg(int v) : type(INT) { value.i = v; }
+                Arg(long v) : type(INT) { value.i = v; }
+                Arg(long long v) : type(INT) { value.i = v; }
+                Arg(unsigned v) : type(UINT) { value.u = v; }
+                Arg(unsigned long v) : type(UINT) { value.u = v; }
+                Arg(unsigned long long v) : type(UINT) { value.u = v; }
+                Arg(double v) : type(DOUBLE) { value.d = v; }
+                Arg(void const* v) : type(POINTER) { value.p = v; }
+                Arg(char const* v) : type(TEXT_UTF8), length(v ? (int)strlen(v) : 0) { value.p = v; }
+                Arg(std::string const& v) : type(TEXT_UTF8), length((int)v.size()) { value.p = v.data(); }
+                Arg(QString const& v) : type(TEXT_QSTRING) { value.p = &v; }
+
+                Type type;
+                int length;
+                union
+                {
+                    qint64 i;
+                    quint64 u;
+                    double d;
+                    void const* p;
+                } value;
+        };
+
+        static inline bool enabled(int log)
+        {
+            return (Mask.load() >> log) & 1;
+        }
+
+        static void setEnabled(int log, bool enabled);
+
+        /** Sink receives formatted lines in the consumer thread */
+        typedef void (*Sink)(int log, QString const& line);
+        static void setSink(Sink sink);
+
+        template<typename... Args>
+        static void write(int log, char const* where, char const* format, Args const&... args)
+        {
+            static_assert(sizeof...(Args) <= MAX_ARGS, "toRingLog: too many arguments");
+            Arg const a[] = { Arg(), Arg(args)... };
+            append(log, where, format, a + 1, sizeof...(Args));
+        }
+
+        /** Format and pass all the pending records to the sink, in the calling thread */
+        static void flush();
+
+        /** Number of records lost because of full buffers */
+        static int dropped();
+
+    private:
+        static void append(int log, char const* where, char const* format, Arg const* args, int count);
+
+        static QAtomicInteger<quint32> Mask;
+};
+
+#define TLOG_STRINGIFY_(x) #x
+#define TLOG_STRINGIFY(x) TLOG_STRINGIFY_(x)
+
+#define TLOGF(lognumber, ...)                                                                           \
+    do                                                                                                  \
+    {                                                                                                   \
+        if (toRingLog::enabled(lognumber))                                                              \
+            toRingLog::write(lognumber, __FILE__ ":" TLOG_STRINGIFY(__LINE__), __VA_ARGS__);            \
+    } while (0)
@@ -45,6 +45,9 @@
 #define QT_TRANSLATE_NOOP(x,y) QTRANS(x,y)
 
 toSQL::sqlMap *toSQL::Definitions;
+QHash<QString, int> *toSQL::Ids;
+// Incremented after each change of the SQL texts in Definitions, statically initialized as it is used by toSQL global instances
+static QBasicAtomicInt sqlGeneration = Q_BASIC_ATOMIC_INITIALIZER(1);
 const char * const toSQL::TOSQL_USERLIST = "Global:UserList";
 const char * const toSQL::TOSQL_CREATEPLAN = "Global:CreatePlan";
 
@@ -67,16 +70,20 @@ toSQL::toSQL(char const *name,
     : Name(name)
 {
     updateSQL(name, sql, description, ver, provider, false);
+    Id = id(Name);
 }
 
 toSQL::toSQL(const QString &name)
     : Name(name)
+    , Id(id(name))
 {}
 
 void toSQL::allocCheck(void)
 {
     if (!Definitions)
         Definitions = new sqlMap;
+    if (!Ids)
+        Ids = new QHash<QString, int>;
 }
 
 bool toSQL::updateSQL(char const *_name,
@@ -98,6 +105,9 @@ bool toSQL::updateSQL(char const *_name,
             fprintf(stderr, "ERROR:Tried add new version to unknown SQL (%s)\n", _name);
             return false;
         }
+        QString name(_name);
+        if (!Ids->contains(name))
+            Ids->insert(name, Ids->size());
         definition newDef;
         newDef.Modified = modified;
         newDef.Description = _description;
@@ -107,6 +117,7 @@ bool toSQL::updateSQL(char const *_name,
             cl.insert(cl.end(), def);
         }
         (*Definitions)[_name] = newDef;
+        sqlGeneration.fetchAndAddOrdered(1);
         return true;
     }
 
@@ -128,20 +139,27 @@ bool toSQL::updateSQL(char const *_name,
     	{
     		if (!def.SQL.isNull())
     		{
-    			if (def.SQL != j->SQL)
+    			bool changed = def.SQL != j->SQL;
+    			if (changed)
     				def.Modified = modified;
     			(*j) = def;
+    			if (changed)
+    				sqlGeneration.fetchAndAddOrdered(1);
     		}
     		return false;
     	}
     	else if (j->Provider > def.Provider || (j->Provider == def.Provider && j->Version > def.Version))
     	{
     		if (!def.SQL.isNull())
+    		{
     			cl.insert(j, def);
+    			sqlGeneration.fetchAndAddOrdered(1);
+    		}
     		return true;
     	}
     }
     cl.insert(cl.end(), def);
+    sqlGeneration.fetchAndAddOrdered(1);
     return true;
 }
 
@@ -165,6 +183,7 @@ bool toSQL::deleteSQL(QString const& name,
                 cl.erase(j);
                 if ( cl.empty() )
                     Definitions->erase(i);
+                sqlGeneration.fetchAndAddOrdered(1);
                 return true;
             }
             else if (j->Provider > provider ||
@@ -186,18 +205,11 @@ toSQL toSQL::sql(const QString &name)
     throw qApp->translate("toSQL", "01: Tried to get unknown SQL (%1)").arg(QString(name));
 }
 
-QString toSQL::string(const QString &name, const toConnection &conn)
+QString toSQL::resolve(definition const& def, QString const& provider, QString const& ver)
 {
-    allocCheck();
-    QString SessionVersion = conn.version();
-    QString SessionProvider = conn.provider();
-
+    QString SessionProvider = provider;
     bool quit = false;
 
-    sqlMap::iterator i = Definitions->find(name);
-    if (i == Definitions->end())
-        goto fail;
-
     // Loop over our connections' provider queries, if nothing is found also loop over "ANY" providers' queries
     do
     {
@@ -205,15 +217,14 @@ QString toSQL::string(const QString &name, const toConnection &conn)
     		quit = true;
     	QString retval;
     	QString SqlVersion = defaultVersion;
-    	std::list<version> &cl = (*i).second.Versions;
-    	for (std::list<version>::iterator j = cl.begin(); j != cl.end(); j++)
+    	std::list<version> const& cl = def.Versions;
+    	for (std::list<version>::const_iterator j = cl.begin(); j != cl.end(); j++)
     	{
     		if (j->Provider != SessionProvider)
     			continue;
 
     		QString const& QueryVersion = j->Version;
-    		QString const& QueryProvider = j->Provider;
-    		if (SqlVersion <= QueryVersion && QueryVersion <= SessionVersion)
+    		if (SqlVersion <= QueryVersion && QueryVersion <= ver)
     		{
     			retval = j->SQL;
     			SqlVersion = QueryVersion;
@@ -226,10 +237,48 @@ QString toSQL::string(const QString &name, const toConnection &conn)
     }
     while (!quit);
 
-fail:
+    return QString();
+}
+
+QString toSQL::string(const QString &name, const toConnection &conn)
+{
+    return string(id(name), name, conn);
+}
+
+QString toSQL::string(int id, const QString &name, const toConnection &conn)
+{
+    QSharedPointer<toSQLTable const> table = conn.sqlTable();
+    if (id >= 0 && id < table->Statements.size())
+    {
+        QString const& retval = table->Statements.at(id);
+        if (!retval.isNull())
+            return retval;
+    }
     throw qApp->translate("toSQL", "02: Tried to get unknown SQL (%1)").arg(QString(name));
 }
 
+int toSQL::id(const QString &name)
+{
+    allocCheck();
+    return Ids->value(name, -1);
+}
+
+int toSQL::generation(void)
+{
+    return sqlGeneration.loadAcquire();
+}
+
+toSQLTable* toSQL::resolveAll(const QString &provider, const QString &version)
+{
+    allocCheck();
+    toSQLTable *retval = new toSQLTable;
+    retval->Generation = generation();
+    retval->Statements.resize(Ids->size());
+    for (sqlMap::const_iterator i = Definitions->begin(); i != Definitions->end(); i++)
+        retval->Statements[Ids->value(i->first)] = resolve(i->second, provider, version);
+    return retval;
+}
+
 bool toSQL::saveSQL(const QString &filename, bool all)
 {
     allocCheck();
@@ -39,8 +39,11 @@
 
 #include <QtCore/QString>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
 
 class toConnection;
+class toSQLTable;
 
 /**
  * This class handles an abstraction of SQL statements used by TOra to extract
@@ -65,6 +68,11 @@ class toConnection;
  *
  * All strings are specific for a given database provider. No attempt to use
  * strings from other providers will be made.
+ *
+ * Each statement name is given an integer id when it is first defined. Connections
+ * hold a @ref toSQLTable with the statements resolved for their provider and version
+ * indexed by this id, so a lookup is an array access. The table is rebuilt when
+ * the definitions are changed (see @ref generation).
  */
 
 class toSQL
@@ -126,10 +134,19 @@ class toSQL
          */
         static sqlMap *Definitions;
 
+        /** Map of statement names to statement ids. Ids are never reused, not even when
+         * the statement is deleted.
+         */
+        static QHash<QString, int> *Ids;
+
         /** Name of this SQL statement
          */
         QString Name;
 
+        /** Id of this SQL statement
+         */
+        int Id;
+
         /** Internal constructor used by some of the internal functions. Creates an
          * SQL statement with a name but without an entry in the @ref Definitions map.
          */
@@ -141,6 +158,16 @@ class toSQL
 
         /** default database version for toSql instances where version is defined and empty string "" */
         static QString defaultVersion;
+
+        /** Pick the statement for provider and version from definition, falls back to provider "Any".
+         * @return Statement or null string if there is none.
+         */
+        static QString resolve(definition const& def, QString const& provider, QString const& version);
+
+        /** Get the statement with id from connection's statement table.
+         * @exception QString if the statement is not defined for the connection.
+         */
+        static QString string(int id, const QString &name, const toConnection &conn);
     public:
         /** Name of the SQL to get a userlist
          */
@@ -190,7 +217,7 @@ class toSQL
          */
         static QString string(const toSQL &sqldef, const toConnection &conn)
         {
-            return string(sqldef.Name, conn);
+            return string(sqldef.Id, sqldef.Name, conn);
         }
 
         /** Get description of an SQL.
@@ -227,7 +254,7 @@ class toSQL
          */
         static QString sql(const toSQL &sqldef, const toConnection &conn)
         {
-            return sql(sqldef.Name, conn);
+            return string(sqldef.Id, sqldef.Name, conn).toUtf8();
         }
 
         /** Get an SQL from a specified name.
@@ -243,6 +270,20 @@ class toSQL
          */
         static QList<QString> range(const QString &startWith);
 
+        /** Get id of a statement name.
+         * @return Id or -1 if the name was never defined.
+         */
+        static int id(const QString &name);
+
+        /** Counter incremented on each change of the definitions.
+         */
+        static int generation(void);
+
+        /** Resolve all statements for provider and version.
+         * @return New table, caller takes ownership.
+         */
+        static toSQLTable* resolveAll(const QString &provider, const QString &version);
+
         /** Save SQL definitions to file.
          * @param file Filename to save to.
          * @param all If true all statements will be saved, otherwised only modified are saved.
@@ -270,7 +311,7 @@ class toSQL
          */
         const QString operator () (const toConnection &conn) const
         {
-            return string(Name, conn);
+            return string(Id, Name, conn);
         }
 
         /** Get name of this SQL.
@@ -297,4 +338,16 @@ class toSQL
               char const *provider = "Oracle");
 };
 
+/** Statements resolved for one provider and version, indexed by statement id.
+ *  Immutable once built, shared by all users of a connection.
+ */
+class toSQLTable
+{
+    public:
+        /** @ref toSQL::generation of the definitions this table was built from */
+        int Generation;
+        /** Statement texts, null string if the statement is not defined for the provider */
+        QVector<QString> Statements;
+};
+
 #endif
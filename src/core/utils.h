@@ -73,6 +73,7 @@ typedef Qt::WFlags toWFlags;
 #endif
 
 class QComboBox;
+class QTextCodec;
 class toConnection;
 class toConnectionRegistry;
 
@@ -312,6 +313,18 @@ namespace Utils
     */
     bool toWriteFile(const QString &filename, const QString &data);
 
+    /** Encode data the way @ref toWriteFile writes it: line ends according to the LineEnd option
+    * and the codec returned by @ref toGetCodec. Used when a file is written in several parts.
+    * @param data Data to encode.
+    */
+    QByteArray toFileData(const QByteArray &data);
+
+    /** Get the codec used to read/write files (see ToConfiguration::Main::Encoding) */
+    QTextCodec* toGetCodec(void);
+
+    /** Expand ~ (home directory) in the filename */
+    QString toExpandFile(const QString &file);
+
     /** Convert a font to a string representation.
      * @param fnt Font to convert.
      * @return String representation of font.
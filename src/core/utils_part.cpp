@@ -288,6 +288,22 @@ namespace Utils
                     QString("Couldn't open %1 for writing").arg(filename).toLatin1().constData()));
             return false;
         }
+        file.write(toFileData(data));
+
+        if (file.error() != QFile::NoError)
+        {
+            TOMessageBox::warning(
+                toQMainWindow(),
+                QT_TRANSLATE_NOOP("toWriteFile", "File error"),
+                QT_TRANSLATE_NOOP("toWriteFile", "Couldn't write data to file"));
+            return false;
+        }
+        toStatusMessage(QT_TRANSLATE_NOOP("toWriteFile", "File saved successfully"), false, false);
+        return true;
+    }
+
+    QByteArray toFileData(const QByteArray &data)
+    {
         QTextCodec *codec = toGetCodec();
 
         // Check if line end type should be changed to particular one
@@ -304,21 +320,10 @@ namespace Utils
                 changeLineEnds(&ba, T_EOL_CRLF);
             else if (lineEndSetting == "Mac")
                 changeLineEnds(&ba, T_EOL_CR);
-            file.write(codec->fromUnicode(ba));
+            return codec->fromUnicode(ba);
         }
         else
-            file.write(codec->fromUnicode(data));
-
-        if (file.error() != QFile::NoError)
-        {
-            TOMessageBox::warning(
-                toQMainWindow(),
-                QT_TRANSLATE_NOOP("toWriteFile", "File error"),
-                QT_TRANSLATE_NOOP("toWriteFile", "Couldn't write data to file"));
-            return false;
-        }
-        toStatusMessage(QT_TRANSLATE_NOOP("toWriteFile", "File saved successfully"), false, false);
-        return true;
+            return codec->fromUnicode(data);
     }
 
     void toStatusMessage(const QString &str, bool save, bool log)
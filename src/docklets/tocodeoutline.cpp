@@ -36,12 +36,15 @@
 #include "docklets/tocodeoutline.h"
 #include "core/tologger.h"
 
+#include "docklets/toparseservice.h"
+#include "editor/toscintilla.h"
 #include "parsing/tsqlparse.h"
 
 //#include "tomain.h"
 //#include "toconnectionmodel.h"
 
-#include <QtCore/QTimerEvent>
+#include <QtCore/QTimer>
+#include <QApplication>
 #include <QListWidget>
 //#include <QListView>
 //#include <QHeaderView>
@@ -51,8 +54,7 @@ REGISTER_VIEW("Outline", toCodeOutline);
 toCodeOutline::toCodeOutline(QWidget *parent,
                              toWFlags flags)
     : toDocklet(tr("Outline"), parent, flags)
-    , m_currentEditor(new editHandlerHolder())
-    , m_timerID(-1)
+    , m_refreshTimer(NULL)
 {
     setObjectName("Code Outline");
 
@@ -98,79 +100,92 @@ toCodeOutline::toCodeOutline(QWidget *parent,
 
     setWidget(TabWidget);
 
-    m_timerID = startTimer(5000);
-    TLOG(0, toDecorator, __HERE__) << "void toQueryModel::timerEvent(QTimerEvent *e) fired" << std::endl;
+    connect(&toParseServiceSingle::Instance(), SIGNAL(parsed(QObject*, toStatementPtr)),
+            this, SLOT(parsed(QObject*, toStatementPtr)));
+
+    // the text is copied only once typing pauses, parsing is done by toParseService in the background
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(qApp, SIGNAL(focusChanged(QWidget*, QWidget*)),
+            this, SLOT(focusChanged(QWidget*, QWidget*)));
+    connect(this, SIGNAL(visibilityChanged(bool)), m_refreshTimer, SLOT(start()));
 }
 
-void toCodeOutline::timerEvent(QTimerEvent *e)
+void toCodeOutline::focusChanged(QWidget *old, QWidget *now)
 {
-    QString newText;
+    // keep the last editor when the focus moves to a non-editor (e.g. this docklet)
+    toScintilla *editor = dynamic_cast<toScintilla*>(toEditWidget::findEdit(now));
+    if (editor == NULL || editor == m_currentEditor)
+        return;
 
-    //TLOG(0,toDecorator,__HERE__) << "void toQueryModel::timerEvent(QTimerEvent *e) fired" << std::endl;
+    if (m_currentEditor)
+        m_currentEditor->disconnect(m_refreshTimer);
+    m_currentEditor = editor;
+    connect(m_currentEditor, SIGNAL(textChanged()), m_refreshTimer, SLOT(start()));
+    m_refreshTimer->start();
+}
 
-    if ( m_timerID != e->timerId())
-    {
-        toDocklet::timerEvent(e);
-        return;
-    }
+void toCodeOutline::refresh()
+{
+    QString newText;
 
-    if ( m_currentEditor->m_current == NULL)
+    if (!isVisible() || m_currentEditor.isNull())
         return;
 
-    newText = m_currentEditor->m_current->editText();
+    newText = m_currentEditor->editText();
     if ( newText == m_lastText)
         return;
 
     m_lastText = newText;
-    TLOG(0, toDecorator, __HERE__) << "New text: " << std::endl << m_lastText  << std::endl;
+    toParseServiceSingle::Instance().request(this, "OraclePLSQL", m_lastText);
+}
 
-    try
+void toCodeOutline::parsed(QObject *client, toStatementPtr stat)
+{
+    if (client != this || stat.isNull())
+        return;
+
+    TLOG(0, toDecorator, __HERE__) << "Parsing ok:" << std::endl
+                                   << stat->root()->toStringRecursive().toStdString() << std::endl;
+
+    procedures->clear();
+    functions->clear();
+    cursors->clear();
+    types->clear();
+    exceptions->clear();
+
+    QMap<QString, const SQLParser::Token*>::const_iterator i = stat->declarations().begin();
+    for (; i != stat->declarations().end(); ++i)
     {
-        std::unique_ptr <SQLParser::Statement> stat = StatementFactTwoParmSing::Instance().create("OraclePLSQL", m_lastText, "");
-        TLOG(0, toDecorator, __HERE__) << "Parsing ok:" << std::endl
-                                       << stat->root()->toStringRecursive().toStdString() << std::endl;
-
-        procedures->clear();
-        functions->clear();
-        cursors->clear();
-        types->clear();
-        exceptions->clear();
-
-        QMap<QString, const SQLParser::Token*>::const_iterator i = stat->declarations().begin();
-        for (; i != stat->declarations().end(); ++i)
-        {
-            TLOG(0, toDecorator, __HERE__) << i.key() << ' ' << i.value()->getPosition().toString() << std::endl;
-            QListWidgetItem *wi = new QListWidgetItem(i.key());
-            wi->setToolTip(i.value()->getPosition().toString());
+        TLOG(0, toDecorator, __HERE__) << i.key() << ' ' << i.value()->getPosition().toString() << std::endl;
+        QListWidgetItem *wi = new QListWidgetItem(i.key());
+        wi->setToolTip(i.value()->getPosition().toString());
 
-            SQLParser::Token const &node = *i.value();
-            if (node.getTokenUsageType() == SQLParser::Token::Declaration)
+        SQLParser::Token const &node = *i.value();
+        if (node.getTokenUsageType() == SQLParser::Token::Declaration)
+        {
+            switch (node.getTokenType())
             {
-                switch (node.getTokenType())
-                {
-                    case SQLParser::Token::L_DATATYPE:
-                        types->addItem(wi);
-                        break;
-                    case SQLParser::Token::L_FUNCTIONNAME:
-                        functions->addItem(wi);
-                        break;
-                    case SQLParser::Token::L_PROCEDURENAME:
-                        procedures->addItem(wi);
-                        break;
-                    case SQLParser::Token::L_CURSORNAME:
-                        cursors->addItem(wi);
-                        break;
-                    case SQLParser::Token::L_EXCEPTIONNAME:
-                        exceptions->addItem(wi);
-                        break;
-                }
+                case SQLParser::Token::L_DATATYPE:
+                    types->addItem(wi);
+                    break;
+                case SQLParser::Token::L_FUNCTIONNAME:
+                    functions->addItem(wi);
+                    break;
+                case SQLParser::Token::L_PROCEDURENAME:
+                    procedures->addItem(wi);
+                    break;
+                case SQLParser::Token::L_CURSORNAME:
+                    cursors->addItem(wi);
+                    break;
+                case SQLParser::Token::L_EXCEPTIONNAME:
+                    exceptions->addItem(wi);
+                    break;
             }
         }
     }
-    catch ( SQLParser::ParseException const &e)
-    {
-
-    }
 }
 
 QIcon toCodeOutline::icon() const
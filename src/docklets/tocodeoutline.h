@@ -38,42 +38,27 @@
 
 #include "core/todocklet.h"
 #include "core/toeditwidget.h"
+#include "docklets/toparseservice.h"
 
 #include <QtCore/QModelIndex>
+#include <QtCore/QPointer>
 
 class QTabWidget;
 class QListWidget;
-class QTimerEvent;
+class QTimer;
+class toScintilla;
 
 class toCodeOutline : public toDocklet
 {
         Q_OBJECT;
 
-        class editHandlerHolder
-        {
-            public:
-                editHandlerHolder() : m_current(NULL) {};
-                virtual ~editHandlerHolder() {};
-                virtual void receivedFocus(toEditWidget *widget)
-                {
-                    m_current = widget;
-                }
-                virtual void lostFocus(toEditWidget *widget)
-                {
-                    m_current = NULL;
-                }
-                toEditWidget *m_current;
-        };
-
     private:
         QTabWidget *TabWidget;
         QListWidget *procedures, *functions, *cursors, *types, *exceptions;
 
         QString m_lastText;
-        editHandlerHolder *m_currentEditor;
-        int m_timerID;
-
-        void timerEvent(QTimerEvent *e);
+        QPointer<toScintilla> m_currentEditor;
+        QTimer *m_refreshTimer;
     public:
         toCodeOutline(QWidget *parent = 0, toWFlags flags = 0);
 
@@ -92,6 +77,11 @@ class toCodeOutline : public toDocklet
 
     public slots:
         void handleActivated(const QModelIndex &index);
+
+    private slots:
+        void parsed(QObject *client, toStatementPtr stat);
+        void focusChanged(QWidget *old, QWidget *now);
+        void refresh();
 };
 
 
@@ -0,0 +1,175 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "docklets/toparseservice.h"
+#include "parsing/tsqlparse.h"
+#include "core/tologger.h"
+
+#include <QtCore/QTimer>
+#include <QtCore/QMutexLocker>
+
+toParseService::toParseService()
+    : QObject(NULL)
+    , m_timer(new QTimer(this))
+    , m_thread(new toParseServiceThread(this))
+    , m_generation(0)
+    , m_quit(false)
+{
+    qRegisterMetaType<toStatementPtr>("toStatementPtr");
+
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(DEBOUNCE_MS);
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(debounced()));
+
+    m_thread->setObjectName("ParseServiceThread");
+    m_thread->start(QThread::LowPriority);
+}
+
+toParseService::~toParseService()
+{
+    {
+        QMutexLocker lock(&m_mutex);
+        m_quit = true;
+        m_queue.clear();
+        m_wake.wakeAll();
+    }
+    m_thread->wait();
+    delete m_thread;
+}
+
+void toParseService::request(QObject *client, QString const& parser, QString const& text)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!m_latest.contains(client))
+        connect(client, SIGNAL(destroyed(QObject*)), this, SLOT(clientDestroyed(QObject*)));
+
+    Job job;
+    job.client = client;
+    job.parser = parser;
+    job.text = text;
+    job.generation = ++m_generation;
+    m_pending[client] = job;
+    m_latest[client] = job.generation;
+
+    // restart the timer, text is parsed only after the user stopped typing
+    m_timer->start();
+}
+
+void toParseService::cancel(QObject *client)
+{
+    QMutexLocker lock(&m_mutex);
+    m_pending.remove(client);
+    m_latest[client] = ++m_generation; // running parse will not be delivered
+}
+
+void toParseService::clientDestroyed(QObject *client)
+{
+    QMutexLocker lock(&m_mutex);
+    m_pending.remove(client);
+    m_latest.remove(client);
+}
+
+void toParseService::debounced()
+{
+    QMutexLocker lock(&m_mutex);
+    // drop queued jobs superseded by the new ones
+    for (QList<Job>::iterator i = m_queue.begin(); i != m_queue.end();)
+    {
+        if (m_pending.contains(i->client))
+            i = m_queue.erase(i);
+        else
+            ++i;
+    }
+    m_queue.append(m_pending.values());
+    m_pending.clear();
+    m_wake.wakeAll();
+}
+
+bool toParseService::takeJob(Job &job)
+{
+    QMutexLocker lock(&m_mutex);
+    while (!m_quit && m_queue.isEmpty())
+        m_wake.wait(&m_mutex);
+    if (m_quit)
+        return false;
+    job = m_queue.takeFirst();
+    return true;
+}
+
+bool toParseService::isCurrent(QObject *client, unsigned generation)
+{
+    QMutexLocker lock(&m_mutex);
+    return !m_quit && m_latest.value(client) == generation;
+}
+
+void toParseService::deliver(QObject *client, unsigned generation, toStatementPtr statement)
+{
+    // the client might have submitted newer text or might have been destroyed while parsing
+    if (!isCurrent(client, generation))
+        return;
+    emit parsed(client, statement);
+}
+
+void toParseServiceThread::run()
+{
+    toParseService::Job job;
+    while (m_service->takeJob(job))
+    {
+        if (!m_service->isCurrent(job.client, job.generation))
+            continue;
+
+        toStatementPtr stat;
+        try
+        {
+            std::unique_ptr <SQLParser::Statement> s = StatementFactTwoParmSing::Instance().create(job.parser, job.text, "");
+            stat = toStatementPtr(s.release());
+        }
+        catch (SQLParser::ParseException const &e)
+        {
+        }
+        catch (std::exception const &e)
+        {
+            TLOG(0, toDecorator, __HERE__) << job.parser << ": " << e.what() << std::endl;
+        }
+        catch (...)
+        {
+            TLOG(0, toDecorator, __HERE__) << job.parser << ": parsing failed" << std::endl;
+        }
+
+        QMetaObject::invokeMethod(m_service, "deliver", Qt::QueuedConnection,
+                                  Q_ARG(QObject*, job.client),
+                                  Q_ARG(unsigned, job.generation),
+                                  Q_ARG(toStatementPtr, stat));
+    }
+}
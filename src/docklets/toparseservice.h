@@ -0,0 +1,127 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "loki/Singleton.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QMap>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QThread>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QMetaType>
+
+class QTimer;
+class toParseServiceThread;
+
+namespace SQLParser
+{
+    class Statement;
+};
+
+typedef QSharedPointer<SQLParser::Statement> toStatementPtr;
+Q_DECLARE_METATYPE(toStatementPtr);
+
+/** Parses editor text snapshots in a background thread on behalf of docklets (Outline, Query model).
+ *
+ * Clients submit a text snapshot with @ref request. Requests are debounced, only the newest snapshot of each client
+ * is parsed and results of parses superseded in the meantime are dropped. The parsed statement is delivered
+ * to the GUI thread by @ref parsed signal, it is NULL when the text could not be parsed.
+ */
+class toParseService : public QObject
+{
+        Q_OBJECT;
+        friend class toParseServiceThread;
+    public:
+        toParseService();
+        virtual ~toParseService();
+
+        /** Queue text for parsing by statement factory parser (OracleDML, OraclePLSQL)
+         *  Any pending request of the same client is replaced.
+         */
+        void request(QObject *client, QString const& parser, QString const& text);
+
+        /** Drop all pending and running requests of the client */
+        void cancel(QObject *client);
+
+    signals:
+        void parsed(QObject *client, toStatementPtr statement);
+
+    private slots:
+        void debounced();
+        void clientDestroyed(QObject *client);
+        void deliver(QObject *client, unsigned generation, toStatementPtr statement);
+
+    private:
+        struct Job
+        {
+            QObject *client;
+            QString parser, text;
+            unsigned generation;
+        };
+
+        // Called from the parser thread, waits for the next job, returns false when the service is shutting down
+        bool takeJob(Job &job);
+        bool isCurrent(QObject *client, unsigned generation);
+
+        // Delay between the last request and the start of parsing
+        static const int DEBOUNCE_MS = 750;
+
+        QTimer *m_timer;
+        toParseServiceThread *m_thread;
+
+        QMutex m_mutex;
+        QWaitCondition m_wake;
+        QMap<QObject*, Job> m_pending;     // waiting for the debounce timer
+        QList<Job> m_queue;                // passed to parser thread
+        QMap<QObject*, unsigned> m_latest; // newest generation of each client
+        unsigned m_generation;
+        bool m_quit;
+};
+
+class toParseServiceThread : public QThread
+{
+    public:
+        toParseServiceThread(toParseService *service) : QThread(), m_service(service) {};
+    protected:
+        void run() override;
+    private:
+        toParseService *m_service;
+};
+
+class toParseServiceSingle: public ::Loki::SingletonHolder<toParseService, Loki::CreateUsingNew, Loki::NoDestroy> {};
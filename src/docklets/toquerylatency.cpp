@@ -0,0 +1,239 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "docklets/toquerylatency.h"
+#include "core/toquerytrace.h"
+#include "core/utils.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QPainter>
+#include <QStyledItemDelegate>
+#include <QToolBar>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+REGISTER_VIEW("Query latency", toQueryLatencyDocklet);
+
+namespace
+{
+    enum
+    {
+        COL_STARTED = 0,
+        COL_ELAPSED,
+        COL_ROWS,
+        COL_BYTES,
+        COL_TRIPS,
+        COL_BREAKDOWN,
+        COL_SQL
+    };
+
+    // ns per phase (QVariantList) and the scale (ns of the whole bar width)
+    const int PhasesRole = Qt::UserRole;
+    const int ScaleRole = Qt::UserRole + 1;
+    const int LaneHeight = 3;
+
+    QColor phaseColor(int phase)
+    {
+        static const QColor colors[toQueryTrace::PHASES] =
+        {
+            QColor(0xa0, 0xa0, 0xa0),   // loan wait
+            QColor(0x9c, 0x6a, 0xde),   // init
+            QColor(0xe0, 0x60, 0x4c),   // execute
+            QColor(0xf0, 0xb0, 0x30),   // fetch
+            QColor(0x4c, 0xaf, 0x50),   // convert
+            QColor(0x50, 0xb8, 0xe0),   // delivery
+            QColor(0x30, 0x60, 0xc0)    // model
+        };
+        return colors[phase];
+    }
+
+    QString ms(qint64 ns)
+    {
+        return QString::number(ns / 1000000.0, 'f', 1);
+    }
+
+    class toLatencyBarDelegate : public QStyledItemDelegate
+    {
+        public:
+            toLatencyBarDelegate(QObject *parent) : QStyledItemDelegate(parent) {}
+
+            void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+            {
+                QStyledItemDelegate::paint(painter, option, QModelIndex());
+
+                QVariantList phases = index.data(PhasesRole).toList();
+                double scale = index.data(ScaleRole).toDouble();
+                if (phases.isEmpty() || scale <= 0)
+                    return;
+
+                // phases overlap in time (worker and main thread), so each one gets its own lane
+                QRect r = option.rect.adjusted(2, 3, -2, -3);
+                double lane = double(r.height()) / toQueryTrace::PHASES;
+                painter->save();
+                for (int p = 0; p < phases.size() && p < toQueryTrace::PHASES; p++)
+                {
+                    double w = qMin(double(r.width()), r.width() * phases.at(p).toLongLong() / scale);
+                    if (w <= 0)
+                        continue;
+                    painter->fillRect(QRectF(r.left(), r.top() + p * lane, w, lane), phaseColor(p));
+                }
+                painter->restore();
+            }
+
+            QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override
+            {
+                QSize size = QStyledItemDelegate::sizeHint(option, index);
+                size.setHeight(qMax(size.height(), LaneHeight * toQueryTrace::PHASES + 6));
+                return size;
+            }
+    };
+}
+
+toQueryLatencyDocklet::toQueryLatencyDocklet(QWidget *parent, toWFlags flags)
+    : toDocklet(tr("Query latency"), parent, flags)
+{
+    setObjectName("Query Latency Docklet");
+
+    QToolBar *toolbar = Utils::toAllocBar(this, tr("Query latency"));
+    toolbar->addAction(QIcon(":/icons/trash.xpm"), tr("Clear"), this, SLOT(clear()));
+    toolbar->addSeparator();
+    toolbar->addAction(QIcon(":/icons/filesave.xpm"), tr("Export as JSON"), this, SLOT(exportJson()));
+    toolbar->addAction(tr("Chrome trace"), this, SLOT(exportChromeTrace()))->setToolTip(tr("Export in Chrome trace format"));
+
+    QString legend;
+    for (int p = 0; p < toQueryTrace::PHASES; p++)
+        legend += QString::fromLatin1("<font color=\"%1\">&#9632;</font>&nbsp;%2 ")
+                  .arg(phaseColor(p).name())
+                  .arg(toQueryTrace::phaseName((toQueryTrace::Phase) p));
+
+    Queries = new QTreeWidget(this);
+    Queries->setRootIsDecorated(false);
+    Queries->setAlternatingRowColors(true);
+    Queries->setHeaderLabels(QStringList()
+                             << tr("Started")
+                             << tr("ms")
+                             << tr("Rows")
+                             << tr("Bytes")
+                             << tr("Round trips")
+                             << tr("Breakdown")
+                             << tr("SQL"));
+    Queries->setItemDelegateForColumn(COL_BREAKDOWN, new toLatencyBarDelegate(Queries));
+    Queries->header()->resizeSection(COL_BREAKDOWN, 200);
+    setFocusProxy(Queries);
+
+    QWidget *w = new QWidget(this);
+    QVBoxLayout *l = new QVBoxLayout();
+    l->setSpacing(0);
+    l->setContentsMargins(0, 0, 0, 0);
+    l->addWidget(toolbar);
+    l->addWidget(new QLabel(legend, w));
+    l->addWidget(Queries);
+    w->setLayout(l);
+    setWidget(w);
+
+    connect(&toQueryTraceRegistrySingle::Instance(), SIGNAL(changed()), this, SLOT(refresh()));
+    refresh();
+}
+
+QIcon toQueryLatencyDocklet::icon() const
+{
+    return QIcon(":/icons/clock.xpm");
+}
+
+QString toQueryLatencyDocklet::name() const
+{
+    return tr("Query latency");
+}
+
+void toQueryLatencyDocklet::refresh()
+{
+    QList<QSharedPointer<toQueryTrace> > traces = toQueryTraceRegistrySingle::Instance().recent();
+
+    qint64 scale = 0;
+    Q_FOREACH(QSharedPointer<toQueryTrace> const& t, traces)
+        scale = qMax(scale, t->elapsed());
+
+    Queries->clear();
+    QList<QTreeWidgetItem*> items;
+    for (int i = traces.size() - 1; i >= 0; i--) // most recent first
+    {
+        QSharedPointer<toQueryTrace> const& t = traces.at(i);
+        QTreeWidgetItem *item = new QTreeWidgetItem();
+        item->setText(COL_STARTED, t->started().toString("hh:mm:ss.zzz"));
+        item->setText(COL_ELAPSED, ms(t->elapsed()));
+        item->setText(COL_ROWS, QString::number(t->rows()));
+        item->setText(COL_BYTES, QString::number(t->bytes()));
+        item->setText(COL_TRIPS, QString::number(t->roundTrips()));
+        item->setText(COL_SQL, t->sql());
+        for (int c = COL_ELAPSED; c <= COL_TRIPS; c++)
+            item->setTextAlignment(c, Qt::AlignRight | Qt::AlignVCenter);
+
+        QVariantList phases;
+        QString tooltip;
+        for (int p = 0; p < toQueryTrace::PHASES; p++)
+        {
+            qint64 ns = t->total((toQueryTrace::Phase) p);
+            phases << ns;
+            tooltip += QString::fromLatin1("%1: %2 ms\n").arg(toQueryTrace::phaseName((toQueryTrace::Phase) p)).arg(ms(ns));
+        }
+        if (!t->error().isEmpty())
+            tooltip += t->error();
+        item->setData(COL_BREAKDOWN, PhasesRole, phases);
+        item->setData(COL_BREAKDOWN, ScaleRole, double(scale));
+        item->setToolTip(COL_BREAKDOWN, tooltip.trimmed());
+        item->setToolTip(COL_SQL, t->sql());
+        items << item;
+    }
+    Queries->addTopLevelItems(items);
+}
+
+void toQueryLatencyDocklet::clear()
+{
+    toQueryTraceRegistrySingle::Instance().clear();
+}
+
+void toQueryLatencyDocklet::exportJson()
+{
+    QString filename = Utils::toSaveFilename(QString::fromLatin1("queries.json"), QString::fromLatin1("*.json"), this);
+    if (!filename.isEmpty())
+        Utils::toWriteFile(filename, toQueryTraceRegistrySingle::Instance().exportJson());
+}
+
+void toQueryLatencyDocklet::exportChromeTrace()
+{
+    QString filename = Utils::toSaveFilename(QString::fromLatin1("queries.trace.json"), QString::fromLatin1("*.json"), this);
+    if (!filename.isEmpty())
+        Utils::toWriteFile(filename, toQueryTraceRegistrySingle::Instance().exportChromeTrace());
+}
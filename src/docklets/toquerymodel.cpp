@@ -36,6 +36,7 @@
 #include "core/utils.h"
 #include "core/tologger.h"
 
+#include "docklets/toparseservice.h"
 #include "parsing/tsqlparse.h"
 #include "docklets/toastwalk.h"
 #include "editor/toworksheettext.h"
@@ -44,7 +45,8 @@
 #include "dotgraphview.h"
 #include "dotgraph.h"
 
-#include <QtCore/QTimerEvent>
+#include <QtCore/QTimer>
+#include <QApplication>
 #include <QTabWidget>
 #include <QListView>
 
@@ -60,7 +62,7 @@ REGISTER_VIEW(TOOL_NAME, toQueryModel);
 toQueryModel::toQueryModel(QWidget *parent, toWFlags flags)
     : toDocklet(tr(TOOL_NAME), parent, flags)
     , m_widget(NULL)
-    , m_timerID(-1)
+    , m_refreshTimer(NULL)
 {
     setObjectName("Query model");
 
@@ -143,39 +145,48 @@ toQueryModel::toQueryModel(QWidget *parent, toWFlags flags)
 
     if (DotGraph::hasValidPath())
     {
-        m_timerID = startTimer(5000);
+        connect(&toParseServiceSingle::Instance(), SIGNAL(parsed(QObject*, toStatementPtr)),
+                this, SLOT(parsed(QObject*, toStatementPtr)));
+        // the text is copied only once typing pauses, parsing is done by toParseService in the background
+        m_refreshTimer = new QTimer(this);
+        m_refreshTimer->setSingleShot(true);
+        m_refreshTimer->setInterval(500);
+        connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+        connect(qApp, SIGNAL(focusChanged(QWidget*, QWidget*)),
+                this, SLOT(focusChanged(QWidget*, QWidget*)));
+        connect(this, SIGNAL(visibilityChanged(bool)), m_refreshTimer, SLOT(start()));
     }
     else
     {
         setDisabled(true);
         blockSignals(true);
     }
-    ///TLOG(0,toDecorator,__HERE__) << "void toQueryModel::timerEvent(QTimerEvent *e) fired" << std::endl;
 }
 
-void toQueryModel::timerEvent(QTimerEvent *e)
+void toQueryModel::focusChanged(QWidget *old, QWidget *now)
 {
-    QString newText;
-    ///TLOG(0,toDecorator,__HERE__) << "void toQueryModel::timerEvent(QTimerEvent *e) fired" << std::endl;
+    // keep the last editor when the focus moves to a non-editor (e.g. this docklet)
+    toScintilla *editor = dynamic_cast<toScintilla*>(toEditWidget::findEdit(now));
+    if (editor == NULL || editor == m_currentEditor)
+        return;
 
-    if (m_timerID == e->timerId())
-    {
-        // if( m_currentEditor->m_current)
-        //  TLOG(0,toDecorator,__HERE__) << m_currentEditor->m_current->editText().toStdString() << std::endl;
-    }
-    else
-    {
-        toDocklet::timerEvent(e);
-    }
+    if (m_currentEditor)
+        m_currentEditor->disconnect(m_refreshTimer);
+    m_currentEditor = editor;
+    connect(m_currentEditor, SIGNAL(textChanged()), m_refreshTimer, SLOT(start()));
+    // the worksheet's current statement follows the cursor
+    connect(m_currentEditor, SIGNAL(cursorPositionChanged(int, int)), m_refreshTimer, SLOT(start()));
+    m_refreshTimer->start();
+}
 
-    if (!isVisible())
-        return;
+void toQueryModel::refresh()
+{
+    QString newText;
 
-    m_currentEditor = toEditWidget::findEdit(QApplication::focusWidget());
-    if ( m_currentEditor == NULL)
+    if (!isVisible() || m_currentEditor.isNull())
         return;
 
-    if (toWorksheetText *t = dynamic_cast<toWorksheetText*>(m_currentEditor))
+    if (toWorksheetText *t = dynamic_cast<toWorksheetText*>(m_currentEditor.data()))
     {
         QWidget *widget = t->parentWidget()->parentWidget();
         toWorksheet *w = dynamic_cast<toWorksheet*>(widget);
@@ -193,26 +204,31 @@ void toQueryModel::timerEvent(QTimerEvent *e)
     m_lastText = newText;
 
     if (newText.isEmpty())
+    {
+        toParseServiceSingle::Instance().cancel(this);
         return;
+    }
+
+    toParseServiceSingle::Instance().request(this, "OracleDML", m_lastText);
+}
 
+void toQueryModel::parsed(QObject *client, toStatementPtr stat)
+{
+    if (client != this || stat.isNull())
+        return;
+
+    TLOG(0, toDecorator, __HERE__) << "Parsing ok:" << std::endl
+                                   << stat->root()->toStringRecursive().toStdString() << std::endl;
     try
     {
-        std::unique_ptr <SQLParser::Statement> stat = StatementFactTwoParmSing::Instance().create("OracleDML", m_lastText, "");
-        TLOG(0, toDecorator, __HERE__) << "Parsing ok:" << std::endl
-                                       << stat->root()->toStringRecursive().toStdString() << std::endl;
-
         //delete(m_widget);
         //m_widget = new KGraphViewer::DotGraphView( NULL /*actionCollection()*/, this);
         m_widget->initEmpty();
         //m_widget->setSizePolicy(QSizePolicy::Expanding,QSizePolicy::Expanding);
         //setFocusProxy(m_widget); // TODO ?? What is this??
         //setWidget(m_widget); // TODO ?? What is this??
-        toASTWalk(stat.get(), m_widget->graph());
+        toASTWalk(stat.data(), m_widget->graph());
         m_widget->prepareSelectSinlgeElement();
-    }
-    catch ( SQLParser::ParseException const &e)
-    {
-
     }
     catch (...)
     {
@@ -259,11 +275,10 @@ void toQueryModel::describeSlot(void)
 
 void toQueryModel::elementSelected(const QMap<QString,QString>&element)
 {
-    // TODO if m_currentEditor already closed, this will SEGFAULT
-    if (!m_currentEditor)
+    if (m_currentEditor.isNull())
         return;
 
-    if (toWorksheetText *t = dynamic_cast<toWorksheetText*>(m_currentEditor))
+    if (toWorksheetText *t = dynamic_cast<toWorksheetText*>(m_currentEditor.data()))
     {
         if (!element.contains("comment"))
             return;
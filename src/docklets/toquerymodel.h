@@ -36,12 +36,14 @@
 #define TOQUERYMODEL_H
 
 #include "core/todocklet.h"
+#include "docklets/toparseservice.h"
 
 #include <QSortFilterProxyModel>
+#include <QtCore/QPointer>
 
-class toEditWidget;
+class toScintilla;
 class DotGraphView;
-class QTimerEvent;
+class QTimer;
 
 class toQueryModel : public toDocklet
 {
@@ -49,9 +51,9 @@ class toQueryModel : public toDocklet
 
     private:
         DotGraphView *m_widget;
-        toEditWidget *m_currentEditor;
+        QPointer<toScintilla> m_currentEditor;
         QString m_lastText;
-        int m_timerID;
+        QTimer *m_refreshTimer;
     public:
         toQueryModel(QWidget *parent = 0, toWFlags flags = 0);
 
@@ -67,12 +69,14 @@ class toQueryModel : public toDocklet
          */
         virtual QString name() const;
 
-        virtual void timerEvent(QTimerEvent *e);
     public slots:
         void describeSlot(void);
 
     protected slots:
         void elementSelected(const QMap<QString,QString>&element);
+        void parsed(QObject *client, toStatementPtr stat);
+        void focusChanged(QWidget *old, QWidget *now);
+        void refresh();
 };
 
 
@@ -0,0 +1,258 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "editor/toscriptanalysis.h"
+#include "editor/tosyntaxanalyzernl.h"
+#include "parsing/tsqlparse.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRunnable>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <memory>
+
+// Minimal number of statements analyzed by one worker task
+static const int CHUNK_MIN = 16;
+
+class toScriptAnalysisTask : public QRunnable
+{
+    public:
+        toScriptAnalysisTask(toScriptAnalysis::entry *from, toScriptAnalysis::entry *to, int details)
+            : m_from(from), m_to(to), m_details(details)
+        {}
+
+        void run() override
+        {
+            for (toScriptAnalysis::entry *e = m_from; e != m_to; ++e)
+                toScriptAnalysis::analyzeEntry(*e, m_details);
+        }
+    private:
+        toScriptAnalysis::entry *m_from, *m_to;
+        int m_details;
+};
+
+toScriptAnalysisPtr toScriptAnalysis::analyze(toSyntaxAnalyzer &splitter, QString const& text, int details)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    toScriptAnalysis *retval = new toScriptAnalysis();
+
+    // Split once, then copy the text of each statement so workers never touch the editor
+    toSyntaxAnalyzer::statementList stats = splitter.getStatements(text);
+    QVector<int> lineStart;
+    lineStart << 0;
+    for (int i = text.indexOf('\n'); i >= 0; i = text.indexOf('\n', i + 1))
+        lineStart << i + 1;
+    lineStart << text.length() + 1;
+
+    retval->m_entries.resize(stats.size());
+    int n = 0;
+    foreach(toSyntaxAnalyzer::statement const& stat, stats)
+    {
+        entry &e = retval->m_entries[n++];
+        static_cast<toSyntaxAnalyzer::statement&>(e) = stat;
+        int from = lineStart.value(stat.lineFrom, text.length());
+        int to = lineStart.value(stat.lineTo + 1, text.length() + 1) - 1; // without the new line
+        e.sql = text.mid(from, to - from);
+        if (e.sql.endsWith('\r'))
+            e.sql.chop(1);
+    }
+
+    // Make sure the factory singleton exists before threads start using it
+    if (details & Objects)
+        StatementFactTwoParmSing::Instance();
+
+    int threads = qMax(1, QThread::idealThreadCount());
+    int chunk = qMax(CHUNK_MIN, retval->m_entries.size() / (threads * 4) + 1);
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+    entry *begin = retval->m_entries.data();
+    entry *end = begin + retval->m_entries.size();
+    for (entry *i = begin; i < end; i += chunk)
+        pool.start(new toScriptAnalysisTask(i, qMin(i + chunk, end), details));
+    pool.waitForDone();
+
+    retval->m_elapsed = timer.elapsed();
+    return toScriptAnalysisPtr(retval);
+}
+
+static inline bool isWordChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_' || c == '$' || c == '#';
+}
+
+// Skip white space and comments, returns position of the next token
+static int skipSpaces(QString const& sql, int pos)
+{
+    while (pos < sql.length())
+    {
+        if (sql.at(pos).isSpace())
+            pos++;
+        else if (sql.midRef(pos, 2) == "--")
+        {
+            pos = sql.indexOf('\n', pos);
+            if (pos < 0)
+                return sql.length();
+        }
+        else if (sql.midRef(pos, 2) == "/*")
+        {
+            pos = sql.indexOf("*/", pos + 2);
+            if (pos < 0)
+                return sql.length();
+            pos += 2;
+        }
+        else
+            break;
+    }
+    return pos;
+}
+
+// Position just after the last character which is neither white space nor part of a comment, -1 if there is none.
+// joined is set when the character before it is not separated by white space or comment.
+static int lastCodeEnd(QString const& sql, int pos, bool &joined)
+{
+    int end = -1;
+    joined = false;
+    while (pos < sql.length())
+    {
+        int next = skipSpaces(sql, pos);
+        if (next != pos)
+        {
+            pos = next;
+            continue;
+        }
+        QChar c = sql.at(pos);
+        if (c == '\'' || c == '"')
+        {
+            int close = sql.indexOf(c, pos + 1);
+            next = close < 0 ? sql.length() : close + 1;
+        }
+        else
+            next = pos + 1;
+        joined = end == pos;
+        end = next;
+        pos = next;
+    }
+    return end;
+}
+
+void toScriptAnalysis::analyzeEntry(entry &e, int details)
+{
+    QString const& sql = e.sql;
+    int start = skipSpaces(sql, 0);
+    int pos = start;
+    while (pos < sql.length() && isWordChar(sql.at(pos)))
+        pos++;
+    if (pos == start && start < sql.length())
+        pos++; // "(select ...)"
+    e.firstWord = sql.mid(start, pos - start);
+
+    QString first = e.firstWord.toUpper();
+    if (toSyntaxAnalyzerNL::SELECT_INTRODUCERS.contains(first))
+        e.statementType = toSyntaxAnalyzer::SELECT;
+    else if (toSyntaxAnalyzerNL::DML_INTRODUCERS.contains(first))
+        e.statementType = toSyntaxAnalyzer::DML;
+    else if (toSyntaxAnalyzerNL::DDL_INTRODUCERS.contains(first))
+        e.statementType = toSyntaxAnalyzer::DDL;
+    else if (toSyntaxAnalyzerNL::PLSQL_INTRODUCERS.contains(first))
+        e.statementType = toSyntaxAnalyzer::PLSQL;
+    else if (toSyntaxAnalyzerNL::SQLPLUS_INTRODUCERS.contains(first))
+        e.statementType = toSyntaxAnalyzer::SQLPLUS;
+
+    // omit the trailing terminator, the same way toSyntaxAnalyzerNL::sanitizeStatement does:
+    // look at the last word skipping comments and white space, ";" ends it unless in PL/SQL,
+    // "/" only when it is a word on it's own (not preceded by other punctuation like in ")/")
+    bool joined;
+    int last = lastCodeEnd(sql, start, joined);
+    if (last > 0)
+    {
+        QChar c = sql.at(last - 1);
+        if (c == ';' && e.statementType != toSyntaxAnalyzer::PLSQL)
+            e.sql.truncate(last - 1);
+        else if (c == '/' && !(joined && !isWordChar(sql.at(last - 2))))
+            e.sql.truncate(last - 1);
+    }
+    int nl = e.sql.lastIndexOf('\n');
+    e.indexTo = e.sql.length() - nl - 1;
+
+    if ((details & Binds) && e.statementType != toSyntaxAnalyzer::DDL && e.statementType != toSyntaxAnalyzer::SQLPLUS)
+    {
+        for (int i = start; i < sql.length(); )
+        {
+            QChar c = sql.at(i);
+            if (c == '\'' || c == '"')
+            {
+                int close = sql.indexOf(c, i + 1);
+                i = close < 0 ? sql.length() : close + 1;
+            }
+            else if (c == '-' || c == '/')
+            {
+                int next = skipSpaces(sql, i);
+                i = next == i ? i + 1 : next;
+            }
+            else if (c == ':' && i + 1 < sql.length() && isWordChar(sql.at(i + 1)) && (i == 0 || (!isWordChar(sql.at(i - 1)) && sql.at(i - 1) != ':')))
+            {
+                int j = i + 1;
+                while (j < sql.length() && isWordChar(sql.at(j)))
+                    j++;
+                QString name = sql.mid(i, j - i);
+                if (!e.binds.contains(name, Qt::CaseInsensitive) && !name.at(1).isDigit())
+                    e.binds << name;
+                i = j;
+            }
+            else
+                i++;
+        }
+    }
+
+    if ((details & Objects) && (e.statementType == toSyntaxAnalyzer::SELECT || e.statementType == toSyntaxAnalyzer::DML))
+    {
+        try
+        {
+            std::unique_ptr <SQLParser::Statement> stat = StatementFactTwoParmSing::Instance().create("OracleDML", e.sql, "");
+            foreach(SQLParser::Token const* t, stat->tableTokens())
+            {
+                QString name = t->toStringRecursive(false).trimmed();
+                if (!name.isEmpty() && !e.objects.contains(name, Qt::CaseInsensitive))
+                    e.objects << name;
+            }
+        }
+        catch (...)
+        {
+            // unparsable statement, objects stay empty
+        }
+    }
+}
@@ -0,0 +1,101 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tosyntaxanalyzer.h"
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+#include <QtCore/QSharedPointer>
+
+/** Immutable analysis of a whole script.
+ *
+ * The text is split into statements once (by toSyntaxAnalyzer::getStatements), then every statement is
+ * classified and scanned for bind variables and referenced objects. The per-statement work runs on
+ * a pool of worker threads, so it does not touch the editor - entries carry their own copy of the SQL.
+ */
+class toScriptAnalysis
+{
+    public:
+        enum Detail
+        {
+            Classify = 0x1, // statementType, firstWord and sql without the trailing terminator
+            Binds    = 0x2, // bind variable names (:name)
+            Objects  = 0x4, // tables referenced by SELECT/DML statements (uses OracleDML parser)
+            All      = Classify | Binds | Objects
+        };
+
+        class entry : public toSyntaxAnalyzer::statement
+        {
+            public:
+                entry() : indexTo(0) {};
+
+                // Character index on line lineTo where the statement (without terminator) ends
+                int indexTo;
+                QStringList binds;
+                QStringList objects;
+        };
+
+        typedef QVector<entry> entryList;
+
+        /** Split and analyze the text.
+         *  @param splitter analyzer used only for splitting (its getStatements is stateless)
+         *  @param details combination of Detail flags
+         */
+        static QSharedPointer<const toScriptAnalysis> analyze(toSyntaxAnalyzer &splitter, QString const& text, int details = Classify | Binds);
+
+        inline entryList const& entries() const
+        {
+            return m_entries;
+        }
+
+        // Time spent in analysis [ms]
+        inline int elapsed() const
+        {
+            return m_elapsed;
+        }
+
+        // Analyze one statement (runs in a worker thread)
+        static void analyzeEntry(entry &e, int details);
+
+    private:
+        toScriptAnalysis() : m_elapsed(0) {};
+
+        entryList m_entries;
+        int m_elapsed;
+};
+
+typedef QSharedPointer<const toScriptAnalysis> toScriptAnalysisPtr;
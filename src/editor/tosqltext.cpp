@@ -383,7 +383,7 @@ void toSqlText::indentPriv(SQLParser::Token const* root, QList<SQLParser::Token
         }
     }
 
-    foreach(QPointer<Token> child, root->getChildren())
+    foreach(Token const* child, root->getChildren())
     {
         Position child_position = child->getValidPosition();
 
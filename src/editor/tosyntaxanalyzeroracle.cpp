@@ -43,13 +43,21 @@
 #include <Qsci/qscilexersql.h>
 
 #include <iostream>
+#include <algorithm>
 
 #include "core/toeditorconfiguration.h"
 #include "core/tostyle.h"
 
+// Number of lines lexed at once when extending statement index, doubled until the statement is found
+static const int INDEX_WINDOW_LINES = 64;
+
 toSyntaxAnalyzerOracle::toSyntaxAnalyzerOracle(toSqlText* parent)
     : toSyntaxAnalyzer(parent)
+    , m_indexedPos(0)
+    , m_indexedAll(false)
 {
+    connect(parent, SIGNAL(SCN_MODIFIED(int, int, const char *, int, int, int, int, int, int, int)),
+            this, SLOT(textModified(int, int)));
 }
 
 toSyntaxAnalyzerOracle::~toSyntaxAnalyzerOracle()
@@ -92,82 +100,146 @@ toSyntaxAnalyzer::statementList toSyntaxAnalyzerOracle::getStatements(const QStr
     return retval;
 }
 
+static toSyntaxAnalyzer::statementClassEnum statementType(SQLLexer::Token::TokenType type)
+{
+    switch (type)
+    {
+        case SQLLexer::Token::L_LPAREN:
+        case SQLLexer::Token::L_DML_INTRODUCER:		// INSERT/UPDATE/DELETE/MERGE
+            return toSyntaxAnalyzer::DML;
+        case SQLLexer::Token::L_SELECT_INTRODUCER:
+            return toSyntaxAnalyzer::SELECT;
+        case SQLLexer::Token::L_PL_INTRODUCER:
+            return toSyntaxAnalyzer::PLSQL;
+        case SQLLexer::Token::L_OTHER_INTRODUCER:
+            return toSyntaxAnalyzer::OTHER;
+        case SQLLexer::Token::X_ONE_LINE:
+            return toSyntaxAnalyzer::SQLPLUS;
+        default:
+            //	        DDL,        // CREATE
+            //	        OTHER,      // ALTER SESSION ..., ANALYZE, SET ROLE, EXPLAIN
+            //	        SQLPLUS		// sqlplus command
+            return toSyntaxAnalyzer::UNKNOWN;
+    }
+}
+
 toSyntaxAnalyzer::statement toSyntaxAnalyzerOracle::getStatementAt(unsigned line, unsigned linePos)
 {
-    toSyntaxAnalyzer::statement retval;
+    indexStatements(line);
+
+    // first statement which ends on the line or below
+    statementList::const_iterator i = std::lower_bound(m_statements.constBegin(), m_statements.constEnd(), line,
+                                      [](statement const& s, unsigned l)
+    {
+        return (unsigned) s.lineTo < l;
+    });
+    if (i == m_statements.constEnd())
+        return toSyntaxAnalyzer::statement();
+    return *i;
+}
+
+void toSyntaxAnalyzerOracle::textModified(int position, int modificationType)
+{
+    if ((modificationType & (QsciScintilla::SC_MOD_INSERTTEXT | QsciScintilla::SC_MOD_DELETETEXT)) == 0)
+        return;
 
     toScintilla *editor = qobject_cast<toScintilla *>(parent());
-    std::string str(editor->text().toStdString());
-    try
+    int line = editor->SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, position);
+
+    // The end of a statement may be decided by text following it (a "/" on the next line, an empty line),
+    // so also drop the statement ending on the last non-empty line above the modification
+    while (line > 0 &&
+            editor->SendScintilla(QsciScintilla::SCI_GETLINEENDPOSITION, line - 1) ==
+            editor->SendScintilla(QsciScintilla::SCI_GETLINEINDENTPOSITION, line - 1))
+        line--;
+    line = qMax(0, line - 1);
+
+    while (!m_statements.isEmpty() && (m_statements.last().lineTo >= line || m_statements.last().posTo > position))
+        m_statements.removeLast();
+    m_indexedPos = m_statements.isEmpty() ? 0 : m_statements.last().posTo;
+    m_indexedAll = false;
+}
+
+void toSyntaxAnalyzerOracle::indexStatements(unsigned line)
+{
+    toScintilla *editor = qobject_cast<toScintilla *>(parent());
+    int window = INDEX_WINDOW_LINES;
+
+    while (!m_indexedAll && (m_statements.isEmpty() || (unsigned) m_statements.last().lineTo < line))
     {
-        std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create("OracleGuiLexer", "", "toCustomLexer");
-        lexer->setStatement(str.c_str(), (int)str.length());
+        int baseLine, baseIndex;
+        editor->lineIndexFromPosition(m_indexedPos, &baseLine, &baseIndex);
 
-        SQLLexer::Lexer::token_const_iterator start = lexer->begin();
-        start = lexer->findStartToken(start);
-        while (start->getTokenType() != SQLLexer::Token::X_EOF)
+        // Lex the text from the end of the last known statement up to the window end.
+        // The last statement found in the window is not final unless the window reaches the end of the text,
+        // as the text below may still be part of it.
+        int endLine = qMax((int) line, baseLine) + window;
+        int length = editor->SendScintilla(QsciScintilla::SCI_GETLENGTH);
+        int endPos = endLine < editor->lines() ? editor->SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, endLine) : length;
+        bool atEnd = endPos >= length;
+
+        QByteArray text(endPos - m_indexedPos + 1, '\0');
+        editor->SendScintilla(QsciScintilla::SCI_GETTEXTRANGE, m_indexedPos, endPos, text.data());
+        text.resize(endPos - m_indexedPos);
+
+        statementList found;
+        try
         {
-            SQLLexer::Lexer::token_const_iterator end = lexer->findEndToken(start);
-            SQLLexer::Lexer::token_const_iterator nextStart = lexer->findStartToken(end);
-            if (end->getPosition().getLine() < line)
+            std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create("OracleGuiLexer", "", "toCustomLexer");
+            lexer->setStatement(text.constData(), text.size());
+
+            // token positions are relative to m_indexedPos
+            auto absLine = [&](SQLLexer::Token const& t)
             {
-                start = nextStart;
-                continue;
-            }
+                return baseLine + (int) t.getPosition().getLine();
+            };
+            auto absIndex = [&](SQLLexer::Token const& t)
+            {
+                return (t.getPosition().getLine() == 0 ? baseIndex : 0) + (int) t.getPosition().getLinePos();
+            };
 
-            // The statement was found - setup retval
-            toScintilla *editor = qobject_cast<toScintilla *>(parent());
-            retval = statement(
-                         start->getPosition().getLine(),
-                         end->getPosition().getLine());
-
-            retval.firstWord = start->getText();
-            retval.posFrom = editor->positionFromLineIndex(start->getPosition().getLine()
-                             , start->getPosition().getLinePos());
-            retval.posTo   = editor->positionFromLineIndex(end->getPosition().getLine()
-                             , end->getPosition().getLinePos() + ( end->getTokenType() == SQLLexer::Token::X_EOL ? 0 : end->getLength()));
-            switch (start->getTokenType())
+            SQLLexer::Lexer::token_const_iterator start = lexer->begin();
+            start = lexer->findStartToken(start);
+            while (start->getTokenType() != SQLLexer::Token::X_EOF)
             {
-                case SQLLexer::Token::L_LPAREN:
-                case SQLLexer::Token::L_DML_INTRODUCER:		// INSERT/UPDATE/DELETE/MERGE
-                    retval.statementType = DML;
-                    break;
-                case SQLLexer::Token::L_SELECT_INTRODUCER:
-                    retval.statementType = SELECT;
-                    break;
-                case SQLLexer::Token::L_PL_INTRODUCER:
-                    retval.statementType = PLSQL;
-                    break;
-                case SQLLexer::Token::L_OTHER_INTRODUCER:
-                    retval.statementType = OTHER;
-                    break;
-                case SQLLexer::Token::X_ONE_LINE:
-                    retval.statementType = SQLPLUS;
-                    break;
-                default:
-                    //	        DDL,        // CREATE
-                    //	        OTHER,      // ALTER SESSION ..., ANALYZE, SET ROLE, EXPLAIN
-                    //	        SQLPLUS		// sqlplus command
-                    retval.statementType = UNKNOWN;
-                    break;
+                SQLLexer::Lexer::token_const_iterator end = lexer->findEndToken(start);
+                statement stat(absLine(*start), absLine(*end));
+                stat.firstWord = start->getText();
+                stat.posFrom = editor->positionFromLineIndex(absLine(*start), absIndex(*start));
+                stat.posTo   = editor->positionFromLineIndex(absLine(*end)
+                               , absIndex(*end) + ( end->getTokenType() == SQLLexer::Token::X_EOL ? 0 : end->getLength()));
+                stat.statementType = statementType(start->getTokenType());
+                found << stat;
+                start = lexer->findStartToken(end);
             }
-            return retval;
         }
+        catch (std::exception const &e)
+        {
+            std::string s(e.what());
+            std::cout << s << std::endl;
+            return;
+        }
+        catch (QString const& e)
+        {
+            qDebug() << e;
+            return;
+        }
+        catch (...)
+        {
+            qDebug() << __FUNCTION__ ;
+            return;
+        }
+
+        if (atEnd)
+            m_indexedAll = true;
+        else if (!found.isEmpty())
+            found.removeLast();
+
+        m_statements << found;
+        if (!found.isEmpty())
+            m_indexedPos = found.last().posTo;
+        window *= 2;
     }
-    catch (std::exception const &e)
-    {
-        std::string s(e.what());
-        std::cout << s << std::endl;
-    }
-    catch (QString const& e)
-    {
-        qDebug() << e;
-    }
-    catch (...)
-    {
-        qDebug() << __FUNCTION__ ;
-    }
-    return retval;
 }
 
 QsciLexer* toSyntaxAnalyzerOracle::createLexer(QObject* parent)
@@ -48,4 +48,22 @@ class toSyntaxAnalyzerOracle : public toSyntaxAnalyzer
         statement getStatementAt(unsigned line, unsigned linePos) override;
         QsciLexer* createLexer(QObject *parent) override;
         void sanitizeStatement(statement&) override;
+
+    private slots:
+        // Invalidates statement index from the modified line on
+        void textModified(int position, int modificationType);
+
+    private:
+        // Lexes the text following the last indexed statement until the statement at the line is known
+        void indexStatements(unsigned line);
+
+        /* Statement boundaries found so far, ordered by position.
+         * The index covers only the beginning of the text, it is extended on demand by getStatementAt
+         * and truncated by each modification of the text.
+         */
+        statementList m_statements;
+        // Position where indexing continues (end of the last statement in m_statements)
+        int m_indexedPos;
+        // The whole text was indexed
+        bool m_indexedAll;
 };
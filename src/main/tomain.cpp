@@ -924,18 +924,27 @@ void toMain::reportFocus()
 void toMain::checkCaching(void)
 {
     int num = 0;
+    QStringList progress;
     foreach(toConnection * conn, Connections.connections())
     {
         if (conn->getCache().cacheRefreshRunning())
+        {
             num++;
+            QString p = conn->getCache().cacheProgress();
+            if (!p.isEmpty())
+                progress << tr("Caching objects of %1: %2").arg(conn->description(false)).arg(p);
+        }
     }
     if (num == 0)
     {
         Poll.stop();
+        // Drop the caching progress, whether Poll was running or not
+        BackgroundLabel->setToolTip(toBackground::runningTip());
     }
     else
     {
         Poll.start(100);
+        BackgroundLabel->setToolTip(progress.isEmpty() ? toBackground::runningTip() : progress.join("\n"));
     }
 }
 
@@ -8,6 +8,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 
 #include "TokenAttr.hpp"
+#include "toparsearena.h"
 
 using namespace SQLLexer;
 
@@ -32,6 +33,9 @@ namespace Antlr3BackendImpl {
 		{
 			antlr3::CustomTraitsBase<ImplTraits>::displayRecognitionError(str);
 		}
+
+		// tokens, streams and trees are pooled in toParseArena, see OracleDMLStatement::parse
+		typedef ArenaAllocPolicy AllocPolicyType;
 	
 		template<class StreamType>
 		class RecognizerType : public antlr3::BaseRecognizer<ImplTraits, StreamType>
@@ -41,6 +41,7 @@
 #include "core/tosyntaxanalyzer.h"
 
 #include <QtCore/QDebug>
+#include <QtCore/QHash>
 #include <QtGui/QColor>
 #include <QtGui/QFont>
 #include <Qsci/qsciscintilla.h>
@@ -152,75 +153,227 @@ QString toLexerOracle::description(int style) const
     }
 }
 
-void toLexerOracle::styleText(int start, int end)
+void toLexerOracle::setEditor(QsciScintilla *newEditor)
+{
+    if (editor())
+        disconnect(editor(), SIGNAL(SCN_MODIFIED(int, int, const char *, int, int, int, int, int, int, int)),
+                   this, SLOT(handleModified(int, int, const char *, int, int, int, int, int, int, int)));
+
+    QsciLexerCustom::setEditor(newEditor);
+
+    if (editor())
+        connect(editor(), SIGNAL(SCN_MODIFIED(int, int, const char *, int, int, int, int, int, int, int)),
+                this, SLOT(handleModified(int, int, const char *, int, int, int, int, int, int, int)));
+}
+
+// Clear the states of edited lines, new lines included (Scintilla gives them a copy of the next line's state).
+// Only lines whose text did not change since they were styled keep StateStyled (see styleText).
+void toLexerOracle::handleModified(int position, int type, const char *, int, int linesAdded, int, int, int, int, int)
 {
-    QString source;
-    int len = end - start;
+    if (!(type & (QsciScintillaBase::SC_MOD_INSERTTEXT | QsciScintillaBase::SC_MOD_DELETETEXT)))
+        return;
+    int line = editor()->SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, position);
+    for (int i = line; i <= line + qMax(linesAdded, 0); i++)
+        editor()->SendScintilla(QsciScintilla::SCI_SETLINESTATE, i, 0L);
+}
 
+// Line states are kept in Scintilla, lines not edited since they were styled from the same state are not lexed again
+void toLexerOracle::styleText(int start, int end)
+{
     if (!editor())
         return;
 
-    if ( lineLength < (end - start + 1)) // +1 for 0x00
+    int line = editor()->SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, start);
+    int lastLine = editor()->SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, end > start ? end - 1 : end);
+    int state = line > 0 ? editor()->SendScintilla(QsciScintilla::SCI_GETLINESTATE, line - 1) & StateMask : StateNormal;
+
+    for (; line <= lastLine; line++)
     {
-        lineLength = Utils::toNextPowerOfTwo(end - start + 1);
-        lineText = (char*) realloc(lineText, lineLength);
+        int lineStart = editor()->SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, line);
+        int lineEnd = editor()->SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, line + 1); // includes EOL
+        if (lineEnd < lineStart)
+            lineEnd = editor()->SendScintilla(QsciScintilla::SCI_GETLENGTH);
+        int cached = editor()->SendScintilla(QsciScintilla::SCI_GETLINESTATE, line);
+        int startState = StateStyled | (state << StateStartShift);
+
+        // Not edited since it was styled from the same state, edited lines are reset by handleModified
+        if ((cached & ~StateMask) == startState)
+        {
+            state = cached & StateMask;
+            continue;
+        }
+
+        unsigned len = lineEnd - lineStart;
+        if ( lineLength < len + 1) // +1 for 0x00
+        {
+            lineLength = Utils::toNextPowerOfTwo(len + 1);
+            lineText = (char*) realloc(lineText, lineLength);
+        }
+        editor()->SendScintilla(QsciScintilla::SCI_GETTEXTRANGE, lineStart, lineEnd, lineText);
+
+        startStyling(lineStart, 0x1f);
+        state = styleLine(lineText, len, state);
+        editor()->SendScintilla(QsciScintilla::SCI_SETLINESTATE, line, state | startState);
     }
-    editor()->SendScintilla(QsciScintilla::SCI_GETTEXTRANGE, start, end, lineText);
-    source = QString::fromUtf8(lineText, len);
-    lexer->setStatement(lineText, len);
+    // mark the whole requested range as styled, even if the last lines were skipped
+    startStyling(end, 0x1f);
+}
 
-    int line = editor()->SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, start);
-    int state = -1;
-    if ( line > 0)
+// Find the end of multi-line construct, return position after it or -1
+static int findClosing(const char *text, int len, int pos, int kind, char close)
+{
+    for (int i = pos; i < len; i++)
     {
-        // the previous state may be needed for multi-line styling
-        int pos = editor()->SendScintilla(QsciScintilla::SCI_GETLINEENDPOSITION, line -1);
-        state = editor()->SendScintilla(QsciScintilla::SCI_GETSTYLEAT, pos);
+        switch (kind)
+        {
+            case toLexerOracle::StateComment:
+                if (text[i] == '*' && i + 1 < len && text[i + 1] == '/')
+                    return i + 2;
+                break;
+            case toLexerOracle::StateString:
+                if (text[i] == '\'')
+                {
+                    if (i + 1 < len && text[i + 1] == '\'') // escaped quote
+                        i++;
+                    else
+                        return i + 1;
+                }
+                break;
+            case toLexerOracle::StateQuotedIdentifier:
+                if (text[i] == '"')
+                    return i + 1;
+                break;
+            case toLexerOracle::StateQQuote:
+                if (text[i] == close && i + 1 < len && text[i + 1] == '\'')
+                    return i + 2;
+                break;
+        }
     }
+    return -1;
+}
 
-    //qDebug() << '[' << line << ',' << start << "," << end << ' ' << lexer->firstWord() << "] " << "source =" << source << '"';
-
-    startStyling(start, 0x1f);
+static inline bool isIdentifierChar(char c)
+{
+    return isalnum((unsigned char) c) || c == '_' || c == '$' || c == '#';
+}
 
-    SQLLexer::Lexer::token_const_iterator i = lexer->begin();
-    unsigned offset = 0;
-    if ( state == CommentMultiline)
+// Find multi-line construct which is not closed on this line, returns it's start or len
+static int findUnclosed(const char *text, int len, int pos, int &kind, char &close)
+{
+    kind = toLexerOracle::StateNormal;
+    close = 0;
+    for (int i = pos; i < len;)
     {
-        for (; i != lexer->end(); ++i)
+        char c = text[i];
+        int next = -1;
+        if (c == '-' && i + 1 < len && text[i + 1] == '-')
+            return len; // rest of line is a comment
+        else if (c == '/' && i + 1 < len && text[i + 1] == '*')
+        {
+            kind = toLexerOracle::StateComment;
+            next = findClosing(text, len, i + 2, kind, close);
+        }
+        else if (c == '\'')
+        {
+            kind = toLexerOracle::StateString;
+            next = findClosing(text, len, i + 1, kind, close);
+        }
+        else if (c == '"')
+        {
+            kind = toLexerOracle::StateQuotedIdentifier;
+            next = findClosing(text, len, i + 1, kind, close);
+        }
+        else if (isIdentifierChar(c))
         {
-            //Q_ASSERT_X( , qPrintable(__QHERE__), "Pos1");
-            SQLLexer::Token const &node = *i;
-            unsigned len2 = node.getLength();
-            setStyling(len2, CommentMultiline);
-            offset += len2;
-            if ( node.getTokenType() == SQLLexer::Token::X_COMMENT_ML_END)
+            // q'[...]' and nq'[...]' literals
+            int q = (c == 'n' || c == 'N') && i + 1 < len ? i + 1 : i;
+            if ((text[q] == 'q' || text[q] == 'Q') && q + 2 < len && text[q + 1] == '\'')
             {
-                ++i;
-                break;
+                switch (text[q + 2])
+                {
+                    case '[': close = ']'; break;
+                    case '(': close = ')'; break;
+                    case '{': close = '}'; break;
+                    case '<': close = '>'; break;
+                    default:  close = text[q + 2];
+                }
+                kind = toLexerOracle::StateQQuote;
+                next = findClosing(text, len, q + 3, kind, close);
+            }
+            else
+            {
+                while (i < len && isIdentifierChar(text[i]))
+                    i++;
+                continue;
             }
         }
+        else
+        {
+            i++;
+            continue;
+        }
+
+        if (next < 0)
+            return i;
+        kind = toLexerOracle::StateNormal;
+        close = 0;
+        i = next;
+    }
+    return len;
+}
+
+int toLexerOracle::styleLine(const char *text, int len, int state)
+{
+    static const int styles[] = { Default, CommentMultiline, Identifier, Identifier, Identifier };
+
+    int kind = state & StateKindMask;
+    char close = (char) ((state & StateMask) >> 3);
+    int pos = 0;
+
+    // continuation of a construct from the previous line
+    if (kind != StateNormal)
+    {
+        pos = findClosing(text, len, 0, kind, close);
+        if (pos < 0)
+        {
+            setStyling(len, styles[kind]);
+            return state & StateMask;
+        }
+        setStyling(pos, styles[kind]);
     }
-    else if ( (*i).getTokenType() == SQLLexer::Token::X_ONE_LINE)
+
+    if (pos == 0)
     {
-        for (; i != lexer->end(); ++i)
+        // SQL*Plus commands (PROMPT it's ...) are styled as a whole line
+        lexer->setStatement(text, len);
+        SQLLexer::Lexer::token_const_iterator i = lexer->begin();
+        while (i != lexer->end() && (*i).getTokenType() == SQLLexer::Token::X_WHITE)
+            ++i;
+        if (i != lexer->end() && (*i).getTokenType() == SQLLexer::Token::X_ONE_LINE)
         {
-            SQLLexer::Token const &node = *i;
-            if ( node.getTokenType() == SQLLexer::Token::X_EOL || node.getTokenType() == SQLLexer::Token::X_EOF)
-            {
-                ++i;
-                break;
-            }
-            unsigned len2 = node.getLength();
-            setStyling(len2, OneLine);
-            offset += len2;
+            setStyling(len, OneLine);
+            return StateNormal;
         }
     }
 
+    int open = findUnclosed(text, len, pos, kind, close);
+    if (open > pos)
+        styleTokens(text + pos, open - pos);
+    if (open < len)
+        setStyling(len - open, styles[kind]);
+    return kind | (((unsigned char) close) << 3);
+}
+
+void toLexerOracle::styleTokens(const char *text, int len)
+{
+    lexer->setStatement(text, len);
+
+    SQLLexer::Lexer::token_const_iterator i = lexer->begin();
+    int styled = 0;
     for (; i != lexer->end(); )
     {
         SQLLexer::Token const &node = *i;
         unsigned len2 = node.getLength();
-        //qDebug() << '\t' << len2 << ' ' << node.getTokenType() << ' ' << state;
 
         switch ( node.getTokenType())
         {
@@ -258,11 +411,12 @@ void toLexerOracle::styleText(int start, int end)
                 setStyling(len2, Failure);
                 break;
             case SQLLexer::Token::X_EOF:
+                len2 = 0;
                 break;
             default:
                 setStyling(len2, Default);
         }
-        offset += len2;
+        styled += len2;
         SQLLexer::Token pnode(*i);
         i++;
         SQLLexer::Token const &nnode = *i;
@@ -271,6 +425,7 @@ void toLexerOracle::styleText(int start, int end)
         Q_ASSERT_X( nnode.getPosition() > pnode.getPosition(), qPrintable(__QHERE__), "Token position");
     }
 
-//	startStyling(start, 0x1f);
-//	setStyling(len, getStyle());
+    // keep Scintilla's styling position in sync with the text
+    if (styled < len)
+        setStyling(len - styled, Default);
 }
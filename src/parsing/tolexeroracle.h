@@ -68,6 +68,7 @@ class toLexerOracle : public QsciLexerCustom
         const char *language() const override;
         QString description(int) const override;
         void styleText(int start, int end) override;
+        void setEditor(QsciScintilla *editor) override;
 
         bool caseSensitive() const override
         {
@@ -84,7 +85,36 @@ class toLexerOracle : public QsciLexerCustom
             return "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ$_#0123456789:.";
         }
 
+        /** Lexer state at the end of a line, kept by Scintilla's SCI_SETLINESTATE.
+         *  Bits 0-2 hold the kind of construct left open, bits 3-10 the closing character of q'[ ]' literal,
+         *  bits 11-21 the state the line was styled from and bit 22 (StateStyled) is set until the line is edited.
+         */
+        enum LineState
+        {
+            StateNormal = 0
+            , StateComment          // /* ... */
+            , StateString           // '...'
+            , StateQuotedIdentifier // "..."
+            , StateQQuote           // q'[ ... ]'
+            , StateKindMask = 0x7
+            , StateMask = 0x7ff     // kind + closing character
+            , StateStartShift = 11
+            , StateStyled = 1 << 22
+        };
+
+        /** Style one line of text, continuing from lexer state of the previous line
+         *  @return lexer state at the end of the line (LineState without the start state)
+         */
+        int styleLine(const char *text, int len, int state);
+
+    private slots:
+        void handleModified(int position, int type, const char *text, int length, int linesAdded,
+                            int line, int foldNow, int foldPrev, int token, int annotationLinesAdded);
+
     protected:
+        /** Style text of a line not starting inside of a multi-line construct */
+        void styleTokens(const char *text, int len);
+
         char *lineText, *bufferText;
         unsigned lineLength, bufferLength;
 
@@ -0,0 +1,124 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "parsing/toparsearena.h"
+
+static bool ArenaEnabled = true;
+
+toParseArena::toParseArena()
+    : m_top(NULL)
+    , m_left(0)
+    , m_reserved(0)
+{
+    memset(m_free, 0, sizeof(m_free));
+}
+
+toParseArena::~toParseArena()
+{
+    for (std::vector<char*>::iterator i = m_chunks.begin(); i != m_chunks.end(); ++i)
+        ::free(*i);
+}
+
+void* toParseArena::alloc(size_t bytes)
+{
+    size_t cls = (bytes + GRANULARITY - 1) / GRANULARITY;
+    if (cls < sizeof(m_free) / sizeof(m_free[0]) && m_free[cls])
+    {
+        FreeBlock *b = m_free[cls];
+        m_free[cls] = b->next;
+        return b;
+    }
+
+    bytes = cls * GRANULARITY;
+    if (bytes > m_left)
+    {
+        size_t size = bytes > CHUNK_SIZE ? bytes : CHUNK_SIZE;
+        char *chunk = static_cast<char*>(::malloc(size));
+        if (chunk == NULL)
+            throw std::bad_alloc();
+        m_chunks.push_back(chunk);
+        m_reserved += size;
+        m_top = chunk;
+        m_left = size;
+    }
+    void *retval = m_top;
+    m_top += bytes;
+    m_left -= bytes;
+    return retval;
+}
+
+void toParseArena::release(void *p, size_t bytes)
+{
+    size_t cls = (bytes + GRANULARITY - 1) / GRANULARITY;
+    if (cls >= sizeof(m_free) / sizeof(m_free[0]))
+        return; // stays in the chunk until the arena is destroyed
+    FreeBlock *b = static_cast<FreeBlock*>(p);
+    b->next = m_free[cls];
+    m_free[cls] = b;
+}
+
+toParseArena*& toParseArena::currentRef()
+{
+    static thread_local toParseArena *arena = NULL;
+    return arena;
+}
+
+toParseArena* toParseArena::current()
+{
+    return currentRef();
+}
+
+void toParseArena::setEnabled(bool enabled)
+{
+    ArenaEnabled = enabled;
+}
+
+bool toParseArena::enabled()
+{
+    return ArenaEnabled;
+}
+
+toParseArenaScope::toParseArenaScope()
+    : m_arena(ArenaEnabled ? new toParseArena() : NULL)
+    , m_previous(toParseArena::currentRef())
+{
+    if (m_arena)
+        toParseArena::currentRef() = m_arena;
+}
+
+toParseArenaScope::~toParseArenaScope()
+{
+    toParseArena::currentRef() = m_previous;
+    delete m_arena;
+}
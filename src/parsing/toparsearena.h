@@ -0,0 +1,337 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/tora_export.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+#include <deque>
+#include <set>
+#include <map>
+
+/*
+ * Pooled memory for one parser run.
+ *
+ * While a toParseArenaScope is alive, ANTLR objects (tokens, token streams, trees, rewrite streams, ...)
+ * of parsers using ArenaAllocPolicy are allocated from the current thread's arena. Small blocks are taken
+ * from large chunks and freed blocks are kept in per size free lists for reuse. The whole arena is released
+ * at once when the scope ends. Without a scope (or when disabled) the policy falls back onto malloc/free.
+ */
+class TORA_EXPORT toParseArena
+{
+    public:
+        // Blocks larger than this are always allocated by malloc
+        static const size_t MAX_POOLED = 512;
+        static const size_t GRANULARITY = 16;
+        static const size_t CHUNK_SIZE = 64 * 1024;
+
+        toParseArena();
+        ~toParseArena();
+
+        void* alloc(size_t bytes);
+        void release(void *p, size_t bytes);
+
+        // Memory taken from the system
+        size_t reserved() const
+        {
+            return m_reserved;
+        }
+
+        // Arena of the current thread, NULL when no scope is active
+        static toParseArena* current();
+
+        // Enable/disable arenas globally (benchmarks only), enabled by default
+        static void setEnabled(bool enabled);
+        static bool enabled();
+
+    private:
+        friend class toParseArenaScope;
+
+        toParseArena(toParseArena const&);
+        toParseArena& operator=(toParseArena const&);
+
+        struct FreeBlock
+        {
+            FreeBlock *next;
+        };
+
+        std::vector<char*> m_chunks;
+        FreeBlock *m_free[MAX_POOLED / GRANULARITY + 1];
+        char *m_top;
+        size_t m_left, m_reserved;
+
+        static toParseArena*& currentRef();
+};
+
+/* Activates a new arena for the current thread, restores previous one in destructor.
+ * Declare it before any ANTLR object, so all of them are destroyed before the arena.
+ */
+class TORA_EXPORT toParseArenaScope
+{
+    public:
+        toParseArenaScope();
+        ~toParseArenaScope();
+    private:
+        toParseArenaScope(toParseArenaScope const&);
+        toParseArenaScope& operator=(toParseArenaScope const&);
+
+        toParseArena *m_arena, *m_previous;
+};
+
+namespace Antlr3BackendImpl
+{
+    /* ANTLR3 C++ allocation policy (see antlr3::DefaultAllocPolicy) backed by toParseArena.
+     * Each block is prefixed by a header holding its size and owning arena, so blocks allocated
+     * outside of an arena scope can still be passed to free() and realloc().
+     */
+    class ArenaAllocPolicy
+    {
+        public:
+            struct Header
+            {
+                size_t size;
+                toParseArena *arena;
+            };
+
+            template <class TYPE>
+            class AllocatorType
+            {
+                public:
+                    typedef TYPE value_type;
+                    typedef value_type* pointer;
+                    typedef const value_type* const_pointer;
+                    typedef value_type& reference;
+                    typedef const value_type& const_reference;
+                    typedef size_t size_type;
+                    typedef ptrdiff_t difference_type;
+                    template<class U> struct rebind
+                    {
+                        typedef AllocatorType<U> other;
+                    };
+
+                    AllocatorType() throw() {}
+                    AllocatorType( const AllocatorType& ) throw() {}
+                    template<typename U> AllocatorType(const AllocatorType<U>& ) throw() {}
+
+                    pointer allocate(size_type n, const void* = 0)
+                    {
+                        return static_cast<pointer>(ArenaAllocPolicy::alloc(n * sizeof(TYPE)));
+                    }
+                    void deallocate(pointer p, size_type)
+                    {
+                        ArenaAllocPolicy::free(p);
+                    }
+                    size_type max_size() const throw()
+                    {
+                        return size_t(-1) / sizeof(TYPE);
+                    }
+                    template<class U, class... Args> void construct(U *p, Args&&... args)
+                    {
+                        ::new((void*)p) U(std::forward<Args>(args)...);
+                    }
+                    template<class U> void destroy(U *p)
+                    {
+                        p->~U();
+                    }
+                    template<class U> bool operator==(AllocatorType<U> const&) const
+                    {
+                        return true;
+                    }
+                    template<class U> bool operator!=(AllocatorType<U> const&) const
+                    {
+                        return false;
+                    }
+            };
+
+            template<class TYPE>
+            class VectorType : public std::vector< TYPE, AllocatorType<TYPE> >
+            {
+            };
+
+            template<class TYPE>
+            class ListType : public std::deque< TYPE, AllocatorType<TYPE> >
+            {
+            };
+
+            template<class TYPE>
+            class StackType : public std::deque< TYPE, AllocatorType<TYPE> >
+            {
+                public:
+                    void push( const TYPE& elem )
+                    {
+                        this->push_back(elem);
+                    }
+                    void pop()
+                    {
+                        this->pop_back();
+                    }
+                    TYPE& peek()
+                    {
+                        return this->back();
+                    }
+                    TYPE& top()
+                    {
+                        return this->back();
+                    }
+                    const TYPE& peek() const
+                    {
+                        return this->back();
+                    }
+                    const TYPE& top() const
+                    {
+                        return this->back();
+                    }
+            };
+
+            template<class TYPE>
+            class OrderedSetType : public std::set< TYPE, std::less<TYPE>, AllocatorType<TYPE> >
+            {
+            };
+
+            template<class TYPE>
+            class UnOrderedSetType : public std::set< TYPE, std::less<TYPE>, AllocatorType<TYPE> >
+            {
+            };
+
+            template<class KeyType, class ValueType>
+            class UnOrderedMapType : public std::map< KeyType, ValueType, std::less<KeyType>,
+                AllocatorType<std::pair<const KeyType, ValueType> > >
+            {
+            };
+
+            template<class KeyType, class ValueType>
+            class OrderedMapType : public std::map< KeyType, ValueType, std::less<KeyType>,
+                AllocatorType<std::pair<const KeyType, ValueType> > >
+            {
+            };
+
+            template<class TYPE>
+            class SmartPtrType : public std::unique_ptr<TYPE, std::default_delete<TYPE> >
+            {
+                    typedef typename std::unique_ptr<TYPE, std::default_delete<TYPE> > BaseType;
+                public:
+                    SmartPtrType() {};
+                    SmartPtrType( SmartPtrType&& other )
+                        : BaseType()
+                    {};
+                    SmartPtrType & operator=(SmartPtrType&& other)
+                    {
+                        BaseType::swap(other);
+                        return *this;
+                    }
+                private:
+                    SmartPtrType & operator=(const SmartPtrType&);
+                    SmartPtrType(const SmartPtrType&);
+            };
+
+            static void* operator new (std::size_t bytes)
+            {
+                return alloc(bytes);
+            }
+            static void* operator new (std::size_t, void* p)
+            {
+                return p;
+            }
+            static void* operator new[]( std::size_t bytes)
+            {
+                return alloc(bytes);
+            }
+            static void operator delete(void* p)
+            {
+                ArenaAllocPolicy::free(p);
+            }
+            static void operator delete(void*, void* ) {} //placement delete
+            static void operator delete[](void* p)
+            {
+                ArenaAllocPolicy::free(p);
+            }
+
+            static void* alloc( std::size_t bytes )
+            {
+                toParseArena *arena = toParseArena::current();
+                Header *h;
+                if (arena && bytes + sizeof(Header) <= toParseArena::MAX_POOLED)
+                {
+                    h = static_cast<Header*>(arena->alloc(bytes + sizeof(Header)));
+                }
+                else
+                {
+                    arena = NULL;
+                    h = static_cast<Header*>(::malloc(bytes + sizeof(Header)));
+                    if (h == NULL)
+                        throw std::bad_alloc();
+                }
+                h->size = bytes;
+                h->arena = arena;
+                return h + 1;
+            }
+
+            static void* alloc0( std::size_t bytes )
+            {
+                void* p = alloc(bytes);
+                memset(p, 0, bytes);
+                return p;
+            }
+
+            static void free( void* p )
+            {
+                if (p == NULL)
+                    return;
+                Header *h = static_cast<Header*>(p) - 1;
+                if (h->arena)
+                    h->arena->release(h, h->size + sizeof(Header));
+                else
+                    ::free(h);
+            }
+
+            static void* realloc(void *ptr, size_t size)
+            {
+                if (ptr == NULL)
+                    return alloc(size);
+                Header *h = static_cast<Header*>(ptr) - 1;
+                if (size <= h->size)
+                    return ptr;
+                void *retval = alloc(size);
+                memcpy(retval, ptr, h->size);
+                free(ptr);
+                return retval;
+            }
+    };
+};
@@ -179,6 +179,10 @@ namespace SQLLexer
             inline token_const_iterator begin() const;
             inline token_const_iterator end() const;
 
+            /** True if the first token (blanks and comments skipped) is SELECT.
+             *  WITH is not, it may contain data-modifying statements */
+            inline bool isPlainSelect() const;
+
         protected:
             /** To be overridden by subclasses */
             virtual int size() const = 0;
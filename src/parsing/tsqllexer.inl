@@ -174,6 +174,24 @@ namespace SQLLexer
 		return token_const_iterator(*this, size());
 	}
 
+	inline bool Lexer::isPlainSelect() const
+	{
+		for (token_const_iterator i = begin(); i->getTokenType() != Token::X_EOF; i++)
+		{
+			switch (i->getTokenType())
+			{
+			case Token::X_WHITE:
+			case Token::X_EOL:
+			case Token::X_COMMENT:
+			case Token::X_COMMENT_ML:
+				continue;
+			default:
+				return i->getText().compare(QString::fromLatin1("SELECT"), Qt::CaseInsensitive) == 0;
+			}
+		}
+		return false;
+	}
+
 	const char* Lexer::Exception::what() const throw()
 	{
 		return "";
@@ -3,6 +3,8 @@
 //// #include "tsqlparser_export.h"
 #include "parsing/tsqlparse.h"
 
+#include <cstdlib>
+
 namespace SQLParser
 {
     const char* SQLParser::Token::TokenType2Text[] =
@@ -144,6 +146,41 @@ namespace SQLParser
         return _mTableMap.end();
     };
 
+    TokenArena::TokenArena()
+        : _mFree(NULL)
+        , _mLeft(0)
+    {
+    }
+
+    TokenArena::~TokenArena()
+    {
+        // tokens own QStrings and QLists, so destructors are still called, but no memory is freed per token
+        for (std::vector<Token*>::reverse_iterator i = _mTokens.rbegin(); i != _mTokens.rend(); ++i)
+            (*i)->~Token();
+        for (std::vector<char*>::iterator i = _mBlocks.begin(); i != _mBlocks.end(); ++i)
+            ::free(*i);
+    }
+
+    void* TokenArena::allocate(size_t size)
+    {
+        static const size_t ALIGN = sizeof(void*) * 2;
+        size = (size + ALIGN - 1) & ~(ALIGN - 1);
+        if (size > _mLeft)
+        {
+            size_t blockSize = size > BLOCK_SIZE ? size : BLOCK_SIZE;
+            char *block = (char*) ::malloc(blockSize);
+            if (block == NULL)
+                throw std::bad_alloc();
+            _mBlocks.push_back(block);
+            _mFree = block;
+            _mLeft = blockSize;
+        }
+        void *retval = _mFree;
+        _mFree += size;
+        _mLeft -= size;
+        return retval;
+    }
+
     Token const* Statement::translateAlias(QString const& alias, Token const *context)
     {
         for ( SQLParser::Statement::token_const_iterator_to_root k(context); k->parent(); ++k)
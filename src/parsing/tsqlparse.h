@@ -16,7 +16,7 @@
 #include <QtCore/QList>
 #include <QtCore/QMap>
 #include <QtCore/QSet>
-#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QVariant>
 #include <QtCore/QVector>
 
@@ -24,12 +24,16 @@
 
 #include <iostream>
 #include <ostream>
+#include <vector>
+#include <utility>
+#include <new>
 
 namespace SQLParser
 {
     class Token;
     class Statement;
     class ParseException;
+    class TokenArena;
 
     /* each instance of T_SELECT can holds transtation map TABLE_ALIAS -> TABLE_REF */
     class TORA_EXPORT Translation : public QMap<QString, Token*>
@@ -164,7 +168,7 @@ namespace SQLParser
     /*
      * Token - an element in AST tree hierarchy
      */
-    class TORA_EXPORT Token : public QObject // inherit from QObject for QPointer
+    class TORA_EXPORT Token
     {
         public:
             // TreeModel methods
@@ -256,6 +260,7 @@ namespace SQLParser
                 , _mTokenType(tokentype) // will be overwritten by descendant
                 , _mUsageType(Unknown)
                 , _mDepth(parent ? parent->_mDepth + 1 : 0)
+                , _mIndex(0)
             {};
 
             Token(const Token& other)
@@ -270,6 +275,7 @@ namespace SQLParser
                 , _mSpacesPost(other._mSpacesPost)
                 , _mMetadata(other._mMetadata)
                 , _mDepth(other._mDepth)
+                , _mIndex(0)
             {
                 //size_t me = this->size();
                 //size_t oth = other.size();
@@ -324,12 +330,12 @@ namespace SQLParser
             QString toStringFull() const
             {
                 QString retval;
-                foreach(QPointer<Token> space, _mSpacesPrev)
+                foreach(Token const* space, _mSpacesPrev)
                 {
                     retval += space->toString();
                 }
                 retval += this->toString();
-                foreach(QPointer<Token> space, _mSpacesPost)
+                foreach(Token const* space, _mSpacesPost)
                 {
                     retval += space->toString();
                 }
@@ -342,7 +348,7 @@ namespace SQLParser
                 QString retval_pre, retval_post;
                 //retval_pre += '[';
                 //retval += getPosition().toString();
-                foreach(QPointer<Token> child, _mChildren)
+                foreach(Token const* child, _mChildren)
                 {
                     Position child_position = child->getValidPosition();
 
@@ -360,7 +366,7 @@ namespace SQLParser
                 QString retval;
                 retval += "(";
                 retval += _mStr + "/" + getTokenATypeName() + "[" + getTokenTypeString() + "]";
-                foreach(QPointer<Token> child, _mChildren)
+                foreach(Token const* child, _mChildren)
                 {
                     retval += "(";
                     retval += child->toLispStringRecursive();
@@ -403,11 +409,17 @@ namespace SQLParser
                 return _mDepth;
             }
 
-            inline void appendChild(QPointer<Token> child)
+            // Stable index of the token within its Statement, see Statement::token()
+            inline unsigned index() const
+            {
+                return _mIndex;
+            }
+
+            inline void appendChild(Token *child)
             {
                 _mChildren.append(child);
             };
-            inline void addSpacer(QPointer<Token> space)
+            inline void addSpacer(Token *space)
             {
                 if (space->getPosition() < getPosition())
                     _mSpacesPrev.append(space);
@@ -418,23 +430,23 @@ namespace SQLParser
             inline void replaceChild(int index, Token* newOne)
             {
                 _mChildren.replace(index, newOne);
-                foreach(QPointer<Token> child, newOne->_mChildren)
+                foreach(Token *child, newOne->_mChildren)
                 {
                     child->_mParent = newOne;
                 }
             };
 
-            inline QList<QPointer<Token> > const& getChildren() const
+            inline QList<Token*> const& getChildren() const
             {
                 return _mChildren;
             };
 
-            inline QList<QPointer<Token> > const& prevTokens() const
+            inline QList<Token*> const& prevTokens() const
             {
                 return _mSpacesPrev;
             }
 
-            inline QList<QPointer<Token> > const& postTokens() const
+            inline QList<Token*> const& postTokens() const
             {
                 return _mSpacesPost;
             }
@@ -451,6 +463,7 @@ namespace SQLParser
             //inline const QSet<Token*>& nodeTables() const { return _mTables; };
         protected:
             friend class Statement;
+            friend class TokenArena;
 
             const static char* TokenType2Text[];
             Token* _mParent;
@@ -460,10 +473,11 @@ namespace SQLParser
             const UsageType _mUsageType;
             QString _mTokenATypeName; //ANTLR token type - for debugging purposes only
             // TODO use only one of them
-            QList<QPointer<Token> > _mChildren;
-            QList<QPointer<Token> > _mSpacesPrev, _mSpacesPost;
+            QList<Token*> _mChildren;
+            QList<Token*> _mSpacesPrev, _mSpacesPost;
             mutable QMap<QString, QVariant> _mMetadata;
             unsigned _mDepth;
+            unsigned _mIndex;
     };
 
     class TORA_EXPORT TokenIdentifier: public Token
@@ -626,6 +640,48 @@ namespace SQLParser
             mutable QString _mNodeID;
     };
 
+    /*
+     * Bump allocator holding all tokens of a Statement.
+     * Tokens are never freed one by one, they are destroyed all at once together with the arena.
+     */
+    class TORA_EXPORT TokenArena
+    {
+        public:
+            TokenArena();
+            ~TokenArena();
+
+            template<typename T, typename... Args> T* create(Args&&... args)
+            {
+                T *t = new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+                t->_mIndex = (unsigned) _mTokens.size();
+                _mTokens.push_back(t);
+                return t;
+            };
+
+            inline Token* at(unsigned index) const
+            {
+                return index < _mTokens.size() ? _mTokens[index] : NULL;
+            };
+
+            inline unsigned size() const
+            {
+                return (unsigned) _mTokens.size();
+            };
+
+        private:
+            TokenArena(TokenArena const&);
+            TokenArena& operator=(TokenArena const&);
+
+            void* allocate(size_t size);
+
+            static const size_t BLOCK_SIZE = 256 * 1024;
+
+            std::vector<char*> _mBlocks;
+            char *_mFree;
+            size_t _mLeft;
+            std::vector<Token*> _mTokens;
+    };
+
     class TORA_EXPORT ParseException: public ::std::exception
     {
         public:
@@ -689,6 +745,12 @@ namespace SQLParser
                 return _mAST;
             };
 
+            // Token by its stable index (see Token::index()), NULL if out of range
+            inline Token* token(unsigned index) const
+            {
+                return _mArena.at(index);
+            };
+
             //inline const QSet<QString>& tables() const
             //{
             //  return _mTablesSet;
@@ -855,12 +917,14 @@ namespace SQLParser
 
             QString dot;
         protected:
+            // Owns all tokens of the statement, keep it the first member so it's destroyed last
+            TokenArena _mArena;
             QString _mStatement, _mname;
             QMap<Position, Position*> _mPosition2pToken;
             StatementType _mStatementType;
             ParserState _mState;
             virtual void parse() = 0;
-            QPointer<Token> _mAST;
+            Token *_mAST;
             mutable Token *_mEnd;
             //QSet<QString> _mTablesSet, _mAliasesSet;
             QVector<Token const*> _mTablesList;
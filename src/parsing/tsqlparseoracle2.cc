@@ -296,8 +296,8 @@ public:
 private:
     void parse();
     /* Recursive walk through ANTLR3_BASE_TREE and create AST tree*/
-    void treeWalkAST(unique_ptr<Antlr3BackendImpl::OracleDML> &psr, QPointer<Token> root, Traits::TreeTypePtr& tree);
-    QList<Token*> treeWalkToken(QPointer<Token> root);
+    void treeWalkAST(unique_ptr<Antlr3BackendImpl::OracleDML> &psr, Token *root, Traits::TreeTypePtr& tree);
+    QList<Token*> treeWalkToken(Token *root);
 
     /* Walk through Token tree and look for table names, table aliases, ... and try to resolve them
        Note: this function also replaces some instances of Token* with Token's subclass instances
@@ -338,6 +338,9 @@ void OracleDMLStatement::parse()
 	//using Tokens = Antlr3BackendImpl::OracleDMLTokens;
 	using namespace std;
 
+	// must outlive all ANTLR objects below
+	toParseArenaScope arena;
+
 	_mState = P_ERROR;
 	QByteArray QBAinput(_mStatement.toUtf8());
 	QByteArray QBAname(_mname.toUtf8());
@@ -377,7 +380,7 @@ void OracleDMLStatement::parse()
 
 	_mState = P_PARSER;
 	
-	_mAST = new TokenSubquery( NULL
+	_mAST = _mArena.create<TokenSubquery>( (Token*)NULL
 				   , Position(0, 0)
 				   , ""
 				   , Token::X_ROOT
@@ -447,9 +450,9 @@ CHECK:
 			    goto CHECK;
 		}
 
-		Token *spacerTokenNew = new Token(t3
+		Token *spacerTokenNew = _mArena.create<Token>(t3
 			, spacerPosition
-			, spacerToken.getText().c_str()
+			, QString(spacerToken.getText().c_str())
 			, Token::X_COMMENT
 		);
 		const_cast<Traits::CommonTokenType&>(spacerToken).setConsumed();
@@ -463,7 +466,7 @@ CHECK:
 };
 
 /* recursively copy an AST tree into */
-void OracleDMLStatement::treeWalkAST(unique_ptr<Antlr3BackendImpl::OracleDML> &psr, QPointer<Token> root, Traits::TreeTypePtr &tree)
+void OracleDMLStatement::treeWalkAST(unique_ptr<Antlr3BackendImpl::OracleDML> &psr, Token *root, Traits::TreeTypePtr &tree)
 {
 	using LexerTokens = Antlr3BackendImpl::OracleDMLLexerTokens;
 	auto &children = tree->get_children();
@@ -513,7 +516,7 @@ void OracleDMLStatement::treeWalkAST(unique_ptr<Antlr3BackendImpl::OracleDML> &p
 			    continue;
 			}
 
-			Token *childTokenNew = new OracleDMLToken(root, *childNode);
+			Token *childTokenNew = _mArena.create<OracleDMLToken>(root, *childNode);
 			root->appendChild(childTokenNew);
 			// This token "select", "from", "where", "=" is already consumed. Do not prepend it to other tokens
 			if (childToken->isRealToken())
@@ -528,16 +531,16 @@ void OracleDMLStatement::treeWalkAST(unique_ptr<Antlr3BackendImpl::OracleDML> &p
 		else     // if child is a leaf node
 		{
 			/* this is a leaf node */
-			Token *childTokenNew = new OracleDMLToken(root, *childNode);
+			Token *childTokenNew = _mArena.create<OracleDMLToken>(root, *childNode);
 			root->appendChild(childTokenNew);
 		} // else for child is a leaf node
 	} // for each child
 };
 
-QList<Token*> OracleDMLStatement::treeWalkToken(QPointer<Token> root)
+QList<Token*> OracleDMLStatement::treeWalkToken(Token *root)
 {
     QList<Token*> tokens;
-    foreach(QPointer<Token> child, root->getChildren())
+    foreach(Token *child, root->getChildren())
     {
         tokens.append(treeWalkToken(child));
     }
@@ -560,7 +563,7 @@ void OracleDMLStatement::disambiguate()
             i--; // At this moment iterator's stack points onto node beeing replaced.
             Token *parent = node.parent();
             Token *me = const_cast<Token*>(&node);
-            TokenTable *newToken = new TokenTable(node);
+            TokenTable *newToken = _mArena.create<TokenTable>(node);
             parent->replaceChild(me->row(), newToken);
             i++;
             break;
@@ -575,7 +578,7 @@ void OracleDMLStatement::disambiguate()
             i--; // At this moment iterator's stack points onto node beeing replaced.
             Token *parent = node.parent();
             Token *me = const_cast<Token*>(&node);
-            TokenSubquery *newToken = new TokenSubquery(node);
+            TokenSubquery *newToken = _mArena.create<TokenSubquery>(node);
             parent->replaceChild(me->row(), newToken);
             i++;
             break;
@@ -585,7 +588,7 @@ void OracleDMLStatement::disambiguate()
             i--; // At this moment iterator's stack points onto node being replaced.
             Token *parent = node.parent();
             Token *me = const_cast<Token*>(&node);
-            TokenIdentifier *newToken = new TokenIdentifier(node);
+            TokenIdentifier *newToken = _mArena.create<TokenIdentifier>(node);
             parent->replaceChild(me->row(), newToken);
             i++;
             break;
@@ -612,7 +615,7 @@ void OracleDMLStatement::disambiguate()
             //    break;
 
             //loop over left brothers until you find either a reserved word or a table name
-            QList<QPointer<Token> > const& brothers = node.parent()->getChildren();
+            QList<Token*> const& brothers = node.parent()->getChildren();
             std::cout << "Alias found:" << node.toString().toLatin1().constData() << std::endl;
             for( int j = node.row() - 1 ; j >= 0; --j)
             {
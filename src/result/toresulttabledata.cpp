@@ -46,6 +46,7 @@
 #include <QVBoxLayout>
 #include <QMessageBox>
 #include <QtGui/QCloseEvent>
+#include <QtCore/QSet>
 
 #include "result/toresultdatasingle.h"
 #include "tools/toresulttableviewedit.h"
@@ -63,6 +64,9 @@
 #include "icons/single.xpm"
 #include "icons/trash.xpm"
 
+// Maximum number of consecutive changes of the same kind saved by one statement
+static const int BATCH_ROWS = 200;
+
 toResultTableData::toResultTableData(QWidget *parent, const char *name, toWFlags f)
     : QWidget(parent, f)
     , Model(NULL)
@@ -412,28 +416,50 @@ bool toResultTableData::commitChanges()
 
 
     toConnectionSubLoan conn(connection());
-    // No primary keys
-    for (int changeIndex = 0; changeIndex < Changes.size(); changeIndex++)
+    toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
+
+    // Batches need savepoints and savepoints need a transaction, autocommit sessions get an explicit one
+    bool batches = connTraits.hasSavepoints();
+    QString begin = connTraits.beginTransactionSQL();
+    if (batches && !begin.isEmpty())
+    {
+        try
+        {
+            Logging->appendPlainText(begin + ";");
+            toQuery(conn, begin, toQueryParams()).eof();
+        }
+        catch (const QString &str)
+        {
+            Logging->appendPlainText(str);
+            batches = false;
+        }
+    }
+
+    for (int changeIndex = 0; changeIndex < Changes.size();)
     {
         ProgressBar->setValue(changeIndex);
 
+        int count = batches ? batchSize(connTraits, Changes, changeIndex) : 1;
         try
         {
-            struct toResultModelEdit::ChangeSet &change = Changes[changeIndex];
+            unsigned processed;
+            if (count > 1)
+                processed = commitBatch(conn, Changes, changeIndex, count);
+            else
+                processed = commitSingle(conn, Changes[changeIndex]);
 
-            switch (change.kind)
+            switch (Changes[changeIndex].kind)
             {
                 case toResultModelEdit::Delete:
-                    deleted += commitDelete(conn, change);
+                    deleted += processed;
                     break;
                 case toResultModelEdit::Add:
-                    added += commitAdd(conn, change);
+                    added += processed;
                     break;
                 case toResultModelEdit::Update:
-                    updated += commitUpdate(conn, change);
+                    updated += processed;
                     break;
                 default:
-                    Utils::toStatusMessage(tr("Internal error."));
                     break;
             }
         }
@@ -444,6 +470,7 @@ bool toResultTableData::commitChanges()
             error = true;
             break;
         }
+        changeIndex += count;
     }
 
     if (!error)
@@ -537,7 +564,6 @@ void toResultTableData::refreshWarn()
 unsigned toResultTableData::commitUpdate(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
 {
     static const QString UPDATE = QString("UPDATE %1.%2 SET %3 WHERE 1=1 %4");
-    static const QString CONJUNCTION = QString(" AND %1 = %2");
     static const QString ASSIGNMENT = QString("%1 = %2");
 
     if (Model->getPriKeys().empty())
@@ -550,20 +576,8 @@ unsigned toResultTableData::commitUpdate(toConnectionSubLoan &conn, toResultMode
     QString sqlValuePlaceHolders, sqlCondPlaceHolders;
 
     // set new value in update statement
-    if (change.newValue.isNull())
-        sqlValuePlaceHolders = ASSIGNMENT.arg(change.columnName).arg("NULL");
-    else
-        sqlValuePlaceHolders = ASSIGNMENT.arg(change.columnName).arg((QString)change.newValue);
-
-    for (int i = 1; i < Model->getPriKeys().size() + 1; i++)
-    {
-        sqlCondPlaceHolders += CONJUNCTION
-                               .arg(connTraits.quote(Model->headerData(
-                                           i,
-                                           Qt::Horizontal,
-                                           Qt::DisplayRole).toString()))
-                               .arg(connTraits.quoteVarchar(change.row[i].editData()));
-    }
+    sqlValuePlaceHolders = ASSIGNMENT.arg(change.columnName).arg(updateValue(change));
+    sqlCondPlaceHolders = priKeyCondition(connTraits, change);
 
     QString sql = UPDATE.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders).arg(sqlCondPlaceHolders);
     Logging->appendPlainText(sql);
@@ -585,10 +599,227 @@ unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEd
     static const QString INSERT = QString("INSERT INTO %1.%2 ( %3 ) VALUES( %4 ) ");
 
     toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
-    const toResultModel::HeaderList & Headers = Model->headers();
 
     QString sqlColumns, sqlValuePlaceHolders;
+    if (!insertValues(connTraits, change, sqlColumns, sqlValuePlaceHolders))
+        return 0;
+
+    QString sql = INSERT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlColumns).arg(sqlValuePlaceHolders);
+    Logging->appendPlainText(sql);
+
+    {
+        // TODO use event query
+        toQuery q(conn, sql, toQueryParams());
+        q.eof();
+        return q.rowsProcessed();
+    }
+}
+
+unsigned toResultTableData::commitDelete(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
+{
+    static const QString DELETESTAT = QString::fromLatin1("DELETE FROM %1.%2 WHERE 1=1 %3");
+    if (Model->getPriKeys().empty())
+    {
+        Utils::toStatusMessage(tr("This table has no known primary keys"));
+        return 0;
+    }
+
+    toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
+    QString sqlValuePlaceHolders = priKeyCondition(connTraits, change);
+
+    QString sql = DELETESTAT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders);
+    Logging->appendPlainText(sql);
+
+    {
+        toQuery q(conn, sql, toQueryParams());
+        q.eof();
+        if (q.rowsProcessed() > 1)
+        {
+            Logging->appendPlainText("Rollback;");
+            conn->rollback();
+            return 0;
+        }
+        return q.rowsProcessed();
+    }
+}
+
+unsigned toResultTableData::commitSingle(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
+{
+    switch (change.kind)
+    {
+        case toResultModelEdit::Delete:
+            return commitDelete(conn, change);
+        case toResultModelEdit::Add:
+            return commitAdd(conn, change);
+        case toResultModelEdit::Update:
+            return commitUpdate(conn, change);
+        default:
+            Utils::toStatusMessage(tr("Internal error."));
+            return 0;
+    }
+}
+
+int toResultTableData::batchSize(toConnectionTraits const &connTraits, QList<toResultModelEdit::ChangeSet> const &changes, int index)
+{
+    // A failed batch is undone and re-executed row by row to report the row which failed
+    if (!connTraits.hasSavepoints())
+        return 1;
+
+    toResultModelEdit::ChangeSet const &first = changes.at(index);
+    if (first.kind != toResultModelEdit::Add && Model->getPriKeys().empty())
+        return 1;
+
+    // keys of rows in the batch, the same row can not be changed twice by one statement
+    QSet<QString> keys;
+    int count = 0;
+    for (int i = index; i < changes.size() && count < BATCH_ROWS; i++, count++)
+    {
+        toResultModelEdit::ChangeSet const &change = changes.at(i);
+        if (change.kind != first.kind)
+            break;
+        if (change.kind == toResultModelEdit::Update && change.columnName != first.columnName)
+            break;
+        if (change.kind != toResultModelEdit::Add)
+        {
+            QString key = priKeyCondition(connTraits, change);
+            if (keys.contains(key))
+                break;
+            keys.insert(key);
+        }
+    }
+    return count;
+}
+
+unsigned toResultTableData::commitBatch(toConnectionSubLoan &conn, QList<toResultModelEdit::ChangeSet> &changes, int index, int count)
+{
+    static const QString DELETESTAT = QString::fromLatin1("DELETE FROM %1 WHERE %2");
+    static const QString UPDATE = QString::fromLatin1("UPDATE %1 SET %2 = CASE %3 END WHERE %4");
+    static const QString WHEN = QString::fromLatin1(" WHEN 1=1 %1 THEN %2");
+    static const QString SAVEPOINT = QString::fromLatin1("SAVEPOINT TORA_BATCH");
+    static const QString ROLLBACK_SAVEPOINT = QString::fromLatin1("ROLLBACK TO SAVEPOINT TORA_BATCH");
+
+    toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
+    QString table = connTraits.quote(Owner) + "." + connTraits.quote(Table);
+    toResultModelEdit::ChangeSet const &first = changes.at(index);
+
+    QString sql;
+    toQueryParams params;
+    switch (first.kind)
+    {
+        case toResultModelEdit::Add:
+            {
+                QString sqlColumns;
+                QStringList rows;
+                for (int i = index; i < index + count; i++)
+                {
+                    QString values;
+                    if (!insertValues(connTraits, changes.at(i), sqlColumns, values, &params))
+                        break;
+                    rows << values;
+                }
+                if (rows.size() == count)
+                    sql = connTraits.insertRows(table, sqlColumns, rows);
+            }
+            break;
+        case toResultModelEdit::Delete:
+        case toResultModelEdit::Update:
+            {
+                QStringList conditions;
+                QString cases;
+                QString datatype = first.kind == toResultModelEdit::Update ? Model->headers().at(first.column).datatype : QString();
+                for (int i = index; i < index + count; i++)
+                {
+                    QString condition = priKeyCondition(connTraits, changes.at(i));
+                    conditions << QString::fromLatin1("(1=1 %1)").arg(condition);
+                    if (first.kind == toResultModelEdit::Update)
+                        cases += WHEN.arg(condition, connTraits.castValue(updateValue(changes.at(i)), datatype));
+                }
+                if (first.kind == toResultModelEdit::Delete)
+                    sql = DELETESTAT.arg(table, conditions.join(" OR "));
+                else
+                    sql = UPDATE.arg(table, first.columnName, cases, conditions.join(" OR "));
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (!sql.isEmpty())
+    {
+        bool savepoint = false;
+        try
+        {
+            toQuery(conn, SAVEPOINT, toQueryParams()).eof();
+            savepoint = true;
+            Logging->appendPlainText(sql);
+            toQuery q(conn, sql, params);
+            q.eof();
+            if (first.kind == toResultModelEdit::Add || q.rowsProcessed() <= (unsigned long) count)
+                return q.rowsProcessed();
+            // Some key matched more rows than expected, the row by row save below reports it
+            Logging->appendPlainText(tr("%1 rows processed, expected %2").arg(q.rowsProcessed()).arg(count));
+        }
+        catch (const QString &str)
+        {
+            Logging->appendPlainText(str);
+        }
 
+        if (savepoint)
+        {
+            // Undo only this batch, the earlier batches of this save are kept
+            Logging->appendPlainText(ROLLBACK_SAVEPOINT + ";");
+            try
+            {
+                toQuery(conn, ROLLBACK_SAVEPOINT, toQueryParams()).eof();
+            }
+            catch (const QString &str)
+            {
+                // The batch can not be undone, re-executing it row by row could apply it twice
+                Logging->appendPlainText(str);
+                throw;
+            }
+        }
+    }
+
+    // Batch not possible or failed, save row by row so the failing row gets reported
+    unsigned processed = 0;
+    for (int i = index; i < index + count; i++)
+        processed += commitSingle(conn, changes[i]);
+    return processed;
+}
+
+QString toResultTableData::priKeyCondition(toConnectionTraits const &connTraits, toResultModelEdit::ChangeSet const &change)
+{
+    static const QString CONJUNCTION = QString::fromLatin1(" AND %1 = %2");
+
+    QString retval;
+    for (int i = 1; i < Model->getPriKeys().size() + 1; i++)
+    {
+        retval += CONJUNCTION
+                  .arg(connTraits.quote(Model->headerData(
+                                            i,
+                                            Qt::Horizontal,
+                                            Qt::DisplayRole).toString()))
+                  .arg(connTraits.quoteVarchar(change.row[i].editData()));
+    }
+    return retval;
+}
+
+QString toResultTableData::updateValue(toResultModelEdit::ChangeSet const &change)
+{
+    if (change.newValue.isNull())
+        return QString::fromLatin1("NULL");
+    return (QString)change.newValue;
+}
+
+bool toResultTableData::insertValues(toConnectionTraits const &connTraits, toResultModelEdit::ChangeSet const &change, QString &sqlColumns, QString &sqlValuePlaceHolders, toQueryParams *params)
+{
+    static const QString BIND = QString::fromLatin1(":f%1<char[%2]>");
+
+    const toResultModel::HeaderList & Headers = Model->headers();
+
+    sqlColumns.clear();
+    sqlValuePlaceHolders.clear();
     for (int i = 1 + Model->PriKeys.size(), col = 0; i < change.row.size(); i++, col++)
     {
         if (col > 0)
@@ -603,7 +834,7 @@ unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEd
         {
             Utils::toStatusMessage(tr("This table contains complex/user defined columns "
                                       "and can not be edited"));
-            return 0;
+            return false;
         }
 
         if (col > 0)
@@ -618,7 +849,7 @@ unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEd
             }
 
             Utils::toStatusMessage(QString("Unsupported datatype(%1)").arg(Headers[i].datatype));
-            return 0;
+            return false;
         }
 
         // Everything else --> varchar
@@ -628,56 +859,16 @@ unsigned toResultTableData::commitAdd(toConnectionSubLoan &conn, toResultModelEd
                 sqlValuePlaceHolders += ("empty_clob()");
                 continue;
             }
+            if (params)
+            {
+                QString value = val.editData();
+                *params << toQValue(value);
+                sqlValuePlaceHolders += BIND.arg(params->size()).arg(value.toUtf8().size() + 1);
+                continue;
+            }
             sqlValuePlaceHolders += connTraits.quoteVarchar(val.editData());
             continue;
         }
     }
-
-    QString sql = INSERT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlColumns).arg(sqlValuePlaceHolders);
-    Logging->appendPlainText(sql);
-
-    {
-        // TODO use event query
-        toQuery q(conn, sql, toQueryParams());
-        q.eof();
-        return q.rowsProcessed();
-    }
-}
-
-unsigned toResultTableData::commitDelete(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change)
-{
-    static const QString DELETESTAT = QString::fromLatin1("DELETE FROM %1.%2 WHERE 1=1 %3");
-    static const QString CONJUNCTION = QString::fromLatin1(" AND %1 = %2");
-    if (Model->getPriKeys().empty())
-    {
-        Utils::toStatusMessage(tr("This table has no known primary keys"));
-        return 0;
-    }
-
-    toConnectionTraits const& connTraits = conn.ParentConnection.getTraits();
-    QString sqlValuePlaceHolders;
-    for (int i = 1; i < Model->getPriKeys().size() + 1; i++)
-    {
-        sqlValuePlaceHolders += CONJUNCTION
-                                .arg(connTraits.quote(Model->headerData(
-                                            i,
-                                            Qt::Horizontal,
-                                            Qt::DisplayRole).toString()))
-                                .arg(connTraits.quoteVarchar(change.row[i].editData()));
-    }
-
-    QString sql = DELETESTAT.arg(connTraits.quote(Owner)).arg(connTraits.quote(Table)).arg(sqlValuePlaceHolders);
-    Logging->appendPlainText(sql);
-
-    {
-        toQuery q(conn, sql, toQueryParams());
-        q.eof();
-        if (q.rowsProcessed() > 1)
-        {
-            Logging->appendPlainText("Rollback;");
-            conn->rollback();
-            return 0;
-        }
-        return q.rowsProcessed();
-    }
+    return true;
 }
@@ -46,6 +46,7 @@ class QAction;
 class QCloseEvent;
 class toResultDataSingle;
 class toResultTableViewEdit;
+class toConnectionTraits;
 //class toResultModel;
 //class toResultModelEdit;
 
@@ -112,6 +113,18 @@ class toResultTableData
         unsigned commitUpdate(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
         unsigned commitAdd(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
         unsigned commitDelete(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
+        unsigned commitSingle(toConnectionSubLoan &conn, toResultModelEdit::ChangeSet &change);
+
+        // Save count consecutive changes of the same kind by one statement
+        unsigned commitBatch(toConnectionSubLoan &conn, QList<toResultModelEdit::ChangeSet> &changes, int index, int count);
+        // Number of changes starting at index which can be saved by one statement
+        int batchSize(toConnectionTraits const &connTraits, QList<toResultModelEdit::ChangeSet> const &changes, int index);
+
+        // Parts of DML statements shared by single row and batch saves
+        QString priKeyCondition(toConnectionTraits const &connTraits, toResultModelEdit::ChangeSet const &change);
+        QString updateValue(toResultModelEdit::ChangeSet const &change);
+        // Values are bound into params if given, quoted literals otherwise
+        bool insertValues(toConnectionTraits const &connTraits, toResultModelEdit::ChangeSet const &change, QString &sqlColumns, QString &sqlValuePlaceHolders, toQueryParams *params = NULL);
 
         toResultModelEdit* Model;
 
@@ -0,0 +1,189 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Micro benchmark for toOracleNumber, compares the plain C++ decoder with
+ * OCINumberIsInt/OCINumberToInt/OCINumberToReal. Needs OCI client libraries
+ * only, no database connection is made.
+ */
+#include "connection/tooraclenumber.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QByteArray>
+
+#include <oci.h>
+
+#include <vector>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+static const unsigned ROWS = 1000000;
+
+static OCIEnv *env;
+static OCIError *errh;
+
+static void check(sword res, const char *what)
+{
+    if (res == OCI_SUCCESS || res == OCI_SUCCESS_WITH_INFO)
+        return;
+    text msg[512];
+    sb4 code = 0;
+    msg[0] = '\0';
+    OCIErrorGet(errh, 1, NULL, &code, msg, sizeof(msg), OCI_HTYPE_ERROR);
+    std::cerr << what << " failed: " << (const char*)msg << std::endl;
+    exit(2);
+}
+
+// OCINumberIsInt + OCINumberToInt/OCINumberToReal, the way tooraclequery.cpp used to do it
+static void ociDecode(OCINumber *vnu, toOracleNumber::Value &out)
+{
+    boolean isint;
+    check(OCINumberIsInt(errh, vnu, &isint), "OCINumberIsInt");
+    if (isint)
+    {
+        long long i;
+        if (OCINumberToInt(errh, vnu, sizeof(long long), OCI_NUMBER_SIGNED, &i) != OCI_SUCCESS)
+        {
+            out.kind = toOracleNumber::Oci;
+            return;
+        }
+        out.kind = toOracleNumber::Int;
+        out.i = i;
+    }
+    else
+    {
+        double d;
+        check(OCINumberToReal(errh, vnu, sizeof(double), &d), "OCINumberToReal");
+        out.kind = toOracleNumber::Real;
+        out.d = d;
+    }
+}
+
+static void fromText(const QByteArray &str, OCINumber *out)
+{
+    const char fmt[] = "TM9";
+    check(OCINumberFromText(errh, (const oratext*)str.constData(), str.size(),
+                            (const oratext*)fmt, sizeof(fmt) - 1,
+                            NULL, 0, out), "OCINumberFromText");
+}
+
+int main(int, char **)
+{
+    check(OCIEnvCreate(&env, OCI_DEFAULT, NULL, NULL, NULL, NULL, 0, NULL), "OCIEnvCreate");
+    check(OCIHandleAlloc(env, (void**)&errh, OCI_HTYPE_ERROR, 0, NULL), "OCIHandleAlloc");
+
+    // Mix of ids, amounts, measurements, huge integers and NULLs
+    std::vector<OCINumber> column(ROWS);
+    std::vector<short> indicators(ROWS, 0);
+    srand(42);
+    for (unsigned row = 0; row < ROWS; row++)
+    {
+        OCINumber *num = &column[row];
+        switch (row % 8)
+        {
+            case 0:
+            case 1:
+                {
+                    long long i = row;
+                    check(OCINumberFromInt(errh, &i, sizeof(i), OCI_NUMBER_SIGNED, num), "OCINumberFromInt");
+                }
+                break;
+            case 2:
+                {
+                    long long i = ((long long)rand() << 31 | rand()) * (rand() % 2 ? 1 : -1);
+                    check(OCINumberFromInt(errh, &i, sizeof(i), OCI_NUMBER_SIGNED, num), "OCINumberFromInt");
+                }
+                break;
+            case 3:
+                fromText(QByteArray::number(rand() % 1000000) + "." + QByteArray::number(rand() % 100), num);
+                break;
+            case 4:
+                {
+                    double d = (double)rand() / RAND_MAX * (rand() % 2 ? 1e6 : -1e-6);
+                    check(OCINumberFromReal(errh, &d, sizeof(d), num), "OCINumberFromReal");
+                }
+                break;
+            case 5:
+                fromText("0." + QByteArray::number(rand()) + QByteArray::number(rand()) + QByteArray::number(rand()), num);
+                break;
+            case 6:
+                fromText(QByteArray::number(rand() % 2 ? 1 : -1) + QByteArray::number(rand()) + QByteArray::number(rand()) + "00000000000", num);
+                break;
+            case 7:
+                indicators[row] = -1;
+                break;
+        }
+    }
+
+    std::vector<toOracleNumber::Value> expected(ROWS), decoded(ROWS);
+    QElapsedTimer timer;
+
+    timer.start();
+    for (unsigned row = 0; row < ROWS; row++)
+    {
+        if (indicators[row] == -1)
+            expected[row].kind = toOracleNumber::Null;
+        else
+            ociDecode(&column[row], expected[row]);
+    }
+    qint64 ociTime = timer.nsecsElapsed();
+
+    timer.restart();
+    toOracleNumber::decodeColumn((const unsigned char*)column.data(), sizeof(OCINumber), indicators.data(), ROWS, decoded.data());
+    qint64 toraTime = timer.nsecsElapsed();
+
+    unsigned mismatches = 0;
+    for (unsigned row = 0; row < ROWS; row++)
+    {
+        toOracleNumber::Value const &e = expected[row], &d = decoded[row];
+        bool same = e.kind == d.kind
+                    && (e.kind != toOracleNumber::Int || e.i == d.i)
+                    && (e.kind != toOracleNumber::Real || memcmp(&e.d, &d.d, sizeof(double)) == 0);
+        if (!same && mismatches++ < 10)
+        {
+            std::cerr << "Mismatch in row " << row << ": OCI " << e.kind << '/' << (e.kind == toOracleNumber::Int ? e.i : 0) << '/' << e.d
+                      << " toOracleNumber " << d.kind << '/' << (d.kind == toOracleNumber::Int ? d.i : 0) << '/' << d.d << std::endl;
+        }
+    }
+
+    std::cout << "rows:           " << ROWS << std::endl;
+    std::cout << "OCI:            " << ociTime / 1000000.0 << " ms" << std::endl;
+    std::cout << "toOracleNumber: " << toraTime / 1000000.0 << " ms" << std::endl;
+    std::cout << "speedup:        " << (double)ociTime / (toraTime ? toraTime : 1) << 'x' << std::endl;
+    std::cout << "mismatches:     " << mismatches << std::endl;
+
+    OCIHandleFree(errh, OCI_HTYPE_ERROR);
+    OCIHandleFree(env, OCI_HTYPE_ENV);
+    return mismatches ? 1 : 0;
+}
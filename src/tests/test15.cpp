@@ -0,0 +1,165 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Benchmark for incremental styling of toLexerOracle. Styles a long script
+ * and then types into it close to the top, the way an editor does.
+ * At the end styles of the edited document are compared with a full restyle
+ * of the same text by a new lexer, returns 1 when they differ.
+ * Usage: test15 [script.sql]
+ */
+#include "parsing/tolexeroracle.h"
+#include "core/utils.h"
+#include "core/toconfiguration.h"
+
+#include <QApplication>
+#include <QtCore/QLibrary>
+#include <QtCore/QElapsedTimer>
+#include <Qsci/qsciscintilla.h>
+
+#include <iostream>
+
+static const int SCRIPT_LINES = 40000;
+static const int KEYSTROKES = 200;
+
+static QString generateScript()
+{
+    QString sql;
+    for (int i = 0; sql.count('\n') < SCRIPT_LINES; i++)
+    {
+        sql += QString::fromLatin1(
+                   "/* block %1\n"
+                   "   spanning lines */\n"
+                   "SELECT t.id, 'text %1' AS txt, q'[it's %1]' qq, \"Mixed Case\"\n"
+                   "  FROM tab%1 t -- comment\n"
+                   " WHERE t.x = %1 AND t.y IN (1, 2.5, 3e2);\n"
+                   "BEGIN\n"
+                   "  UPDATE tab%1 SET val = 'multi\n"
+                   "line' WHERE id = %1;\n"
+                   "END;\n"
+                   "/\n"
+                   "PROMPT done %1\n").arg(i);
+    }
+    return sql;
+}
+
+static QByteArray styles(QsciScintilla &editor)
+{
+    int len = editor.SendScintilla(QsciScintilla::SCI_GETLENGTH);
+    QByteArray retval(len, 0);
+    for (int i = 0; i < len; i++)
+        retval[i] = (char) editor.SendScintilla(QsciScintilla::SCI_GETSTYLEAT, i);
+    return retval;
+}
+
+int main(int argc, char **argv)
+{
+    toConfiguration::setQSettingsEnv();
+
+    QApplication app(argc, argv);
+    QStringList args = app.arguments();
+
+    QLibrary parsing("parsing");
+    parsing.load();
+
+    QString sql;
+    if (args.count() >= 2 && QFile::exists(args[1]))
+        sql = Utils::toReadFile(args[1]);
+    else
+        sql = generateScript();
+
+    QsciScintilla editor;
+    toLexerOracle *lexer = new toLexerOracle(&editor);
+    editor.setLexer(lexer);
+    editor.setText(sql);
+
+    QElapsedTimer timer;
+    timer.start();
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+    std::cout << "Lines:          " << editor.lines() << std::endl;
+    std::cout << "Full styling:   " << timer.elapsed() << " ms" << std::endl;
+
+    // Type into a line close to the top, everything below is re-styled by Scintilla
+    long pos = editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, 5);
+    qint64 total = 0, max = 0;
+    for (int i = 0; i < KEYSTROKES; i++)
+    {
+        editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, pos + i, "x");
+        timer.restart();
+        editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+        qint64 e = timer.elapsed();
+        total += e;
+        max = qMax(max, e);
+    }
+    std::cout << "Keystroke avg:  " << (double) total / KEYSTROKES << " ms" << std::endl;
+    std::cout << "Keystroke max:  " << max << " ms" << std::endl;
+
+    // Open a comment which changes styling of the rest of the document and close it again
+    timer.restart();
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, pos, "/*");
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+    editor.SendScintilla(QsciScintilla::SCI_DELETERANGE, pos, 2);
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+    std::cout << "Comment toggle: " << timer.elapsed() << " ms" << std::endl;
+
+    // Edits creating lines with the same text as an already styled line: duplicate a line,
+    // split a line and join it back, paste a block which closes a comment
+    long line3 = editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, 3);
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, line3, editor.text(3).toLatin1().constData());
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, pos + 3, "\n");
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+    editor.SendScintilla(QsciScintilla::SCI_DELETERANGE, pos + 3, 1);
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, pos, "x */ y\n'z\n");
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+
+    QsciScintilla fresh;
+    fresh.setLexer(new toLexerOracle(&fresh));
+    fresh.setText(editor.text());
+    fresh.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+
+    QByteArray incremental = styles(editor), full = styles(fresh);
+    if (incremental != full)
+    {
+        int i = 0;
+        while (i < incremental.size() && i < full.size() && incremental.at(i) == full.at(i))
+            i++;
+        std::cout << "Incremental styling differs from full restyle at line "
+                  << editor.SendScintilla(QsciScintilla::SCI_LINEFROMPOSITION, i) + 1 << std::endl;
+        return 1;
+    }
+    std::cout << "Incremental styling matches full restyle" << std::endl;
+
+    return 0;
+}
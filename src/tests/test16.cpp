@@ -0,0 +1,143 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Parser throughput and memory benchmark for the ANTLR3 allocation policy (toParseArena).
+ * Parses the given SQL files (or the src/tests *.sql corpus) and a large generated query
+ * repeatedly and prints parse time and peak RSS.
+ * Usage: test16 [--malloc] [file.sql ...]
+ *   --malloc  disables the parse arena; run the benchmark twice to compare peak RSS
+ */
+#include "parsing/tsqlparse.h"
+#include "parsing/toparsearena.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QStringList>
+
+#if defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+#include <iostream>
+#include <memory>
+
+static const int ROUNDS = 20;
+
+static long peakRSS()
+{
+#if defined(Q_OS_UNIX)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kB on Linux
+#else
+    return -1;
+#endif
+}
+
+// One big query: many factored subqueries, joins, nested conditions
+static QString generateSql(int blocks)
+{
+    QString sql("WITH ");
+    for (int i = 0; i < blocks; i++)
+    {
+        if (i)
+            sql += ",\n";
+        sql += QString("s%1 AS (SELECT a.id, a.name, b.val%1, (SELECT MAX(c.x) FROM tab_c c WHERE c.id = a.id) mx\n"
+                       "  FROM tab_a a JOIN tab_b b ON a.id = b.id\n"
+                       " WHERE a.x IN (1, 2, 3) AND (b.y = 'text %1' OR b.z BETWEEN %1 AND %1 + 10))").arg(i);
+    }
+    sql += "\nSELECT * FROM s0";
+    for (int i = 1; i < blocks; i++)
+        sql += QString(" JOIN s%1 ON s%1.id = s0.id").arg(i);
+    return sql;
+}
+
+static void bench(QString const& name, QString const& sql)
+{
+    QElapsedTimer timer;
+    int ok = 0;
+    timer.start();
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        try
+        {
+            std::unique_ptr<SQLParser::Statement> stat = StatementFactTwoParmSing::Instance().create("OracleDML", sql, "");
+            ok++;
+        }
+        catch (...)
+        {
+        }
+    }
+    qint64 ms = timer.elapsed();
+    std::cout << qPrintable(name.leftJustified(32))
+              << " " << sql.size() / 1024 << " kB"
+              << " parsed " << ok << "/" << ROUNDS
+              << " " << (double) ms / ROUNDS << " ms/parse"
+              << " " << (ms ? (double) sql.size() * ROUNDS / 1024 / ms * 1000 : 0) << " kB/s"
+              << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    args.removeFirst();
+
+    if (args.removeAll("--malloc"))
+        toParseArena::setEnabled(false);
+    std::cout << "Parse arena: " << (toParseArena::enabled() ? "enabled" : "disabled") << std::endl;
+
+    if (args.isEmpty())
+    {
+        QDir dir(QFile::exists("tests") ? "tests" : ".");
+        foreach(QString const& f, dir.entryList(QStringList() << "*.sql", QDir::Files))
+            args << dir.filePath(f);
+    }
+
+    foreach(QString const& fileName, args)
+    {
+        QFile f(fileName);
+        if (!f.open(QIODevice::ReadOnly))
+            continue;
+        bench(fileName, QString::fromUtf8(f.readAll()));
+    }
+
+    bench("generated 100 blocks", generateSql(100));
+    bench("generated 1000 blocks", generateSql(1000));
+
+    std::cout << "Peak RSS: " << peakRSS() << " kB" << std::endl;
+    return 0;
+}
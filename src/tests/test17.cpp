@@ -0,0 +1,124 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Object cache disk image benchmark (toCacheImage).
+ * Writes an image of a generated dictionary (default 400000 objects in 200 schemas),
+ * maps it again and measures lookups in place.
+ * Usage: test17 [objects]
+ */
+#include "core/tocache.h"
+#include "core/tocacheimage.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+
+#include <iostream>
+#include <algorithm>
+
+static const int SCHEMAS = 200;
+static const int LOOKUPS = 100000;
+
+static bool lessThan(toCache::CacheEntry const* e1, toCache::CacheEntry const* e2)
+{
+    return e1->name < e2->name;
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int objects = args.size() > 1 ? args.at(1).toInt() : 400000;
+    QString fileName = QDir::temp().filePath("test17.bin");
+
+    QList<toCache::CacheEntry const*> entries;
+    static const toCache::CacheEntryType types[] = { toCache::TABLE, toCache::VIEW, toCache::INDEX, toCache::SYNONYM, toCache::PACKAGE };
+    for (int i = 0; i < objects; i++)
+    {
+        QString owner = QString("SCHEMA_%1").arg(i % SCHEMAS);
+        QString name = QString("OBJECT_%1_%2").arg(i / SCHEMAS).arg(i % 7);
+        entries.append(toCache::createCacheEntry(owner, name, types[i % 5], i % 3 ? QString() : QString("comment %1").arg(i)));
+    }
+    std::sort(entries.begin(), entries.end(), lessThan);
+
+    QStringList users;
+    for (int i = 0; i < SCHEMAS; i++)
+        users << QString("SCHEMA_%1").arg(i);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!toCacheImage::write(fileName, "test17", QString(), true, true, entries, users, users))
+    {
+        std::cout << "Could not write " << qPrintable(fileName) << std::endl;
+        return 1;
+    }
+    std::cout << "write:  " << timer.elapsed() << " ms, " << QFileInfo(fileName).size() / 1024 << " kB" << std::endl;
+
+    timer.restart();
+    QSharedPointer<toCacheImage> image = toCacheImage::open(fileName);
+    if (!image || image->size() != objects)
+    {
+        std::cout << "Could not open " << qPrintable(fileName) << std::endl;
+        return 1;
+    }
+    std::cout << "open:   " << timer.elapsed() << " ms" << std::endl;
+
+    timer.restart();
+    int found = 0;
+    for (int i = 0; i < LOOKUPS; i++)
+    {
+        toCache::CacheEntry const* e = entries.at((i * 7919) % objects);
+        int idx = image->find(e->name.first, e->name.second);
+        if (idx >= 0 && image->name(idx) == e->name.second)
+            found++;
+    }
+    std::cout << "find:   " << timer.elapsed() << " ms for " << LOOKUPS << " lookups, found " << found << std::endl;
+
+    timer.restart();
+    int materialized = 0;
+    QPair<int, int> range = image->schemaRange("SCHEMA_42");
+    for (int i = range.first; i < range.second; i++)
+    {
+        delete image->entry(i);
+        materialized++;
+    }
+    std::cout << "schema: " << timer.elapsed() << " ms for " << materialized << " entries" << std::endl;
+
+    qDeleteAll(entries);
+    image.clear();
+    QFile::remove(fileName);
+    return found == LOOKUPS ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Completion index benchmark (toCompletionIndex).
+ * Builds an index of generated object names (default 100000) and measures
+ * prefix, segment and fuzzy lookups.
+ * Usage: test18 [names]
+ */
+#include "core/tocompletionindex.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QStringList>
+
+#include <iostream>
+
+static const int LOOKUPS = 1000;
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int count = args.size() > 1 ? args.at(1).toInt() : 100000;
+
+    static const char* words[] = { "EMP", "DEPT", "ADDRESS", "ORDER", "LINE", "ITEM", "HIST", "TMP", "CUSTOMER", "INVOICE" };
+    QStringList names;
+    for (int i = 0; i < count; i++)
+    {
+        names << QString("%1_%2_%3%4")
+              .arg(words[i % 10])
+              .arg(words[(i / 10) % 10])
+              .arg(words[(i / 100) % 10])
+              .arg(i / 1000);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    toCompletionIndex index;
+    index.build(names);
+    std::cout << "build:   " << timer.elapsed() << " ms, " << index.size() << " names" << std::endl;
+
+    static const char* queries[][2] =
+    {
+        { "EMP_DEPT_ORDER1", "prefix: " },
+        { "EDA", "segment:" },
+        { "custinv", "fuzzy:  " },
+    };
+    int failed = 0;
+    for (unsigned q = 0; q < sizeof(queries) / sizeof(queries[0]); q++)
+    {
+        QStringList result;
+        timer.restart();
+        for (int i = 0; i < LOOKUPS; i++)
+            result = index.complete(queries[q][0], "SCHEMA.");
+        std::cout << queries[q][1] << " " << timer.nsecsElapsed() / 1000 / LOOKUPS << " us per lookup, "
+                  << result.size() << " names, first " << qPrintable(result.value(0)) << std::endl;
+        if (result.isEmpty())
+            failed++;
+    }
+    return failed;
+}
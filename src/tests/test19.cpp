@@ -0,0 +1,131 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Ring buffer log benchmark (toRingLog).
+ * Measures the cost of TLOGF with the log disabled and enabled from several threads
+ * and checks that every record is either delivered to the sink or counted as dropped.
+ * Then checks that a QString argument (copied as UTF-16) is formatted and truncated correctly.
+ * Usage: test19 [records per thread]
+ */
+#include "core/toringlog.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+
+#include <iostream>
+
+static const int THREADS = 4;
+static const int LOG = 3;
+static QAtomicInt received;
+static QMutex lastLock;
+static QString last;
+
+static void countingSink(int, QString const&)
+{
+    received.fetchAndAddRelaxed(1);
+}
+
+static void lastLineSink(int, QString const& line)
+{
+    QMutexLocker lock(&lastLock);
+    last = line;
+}
+
+class writer : public QThread
+{
+    public:
+        writer(int count) : Count(count) {}
+
+        void run() override
+        {
+            QString text("SELECT * FROM DUAL");
+            for (int i = 0; i < Count; i++)
+                TLOGF(LOG, "row %1 of %2: %3", i, Count, text);
+        }
+
+        int Count;
+};
+
+static qint64 runWriters(int count)
+{
+    QList<writer*> writers;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < THREADS; i++)
+    {
+        writers << new writer(count);
+        writers.last()->start();
+    }
+    Q_FOREACH(writer *w, writers)
+    {
+        w->wait();
+        delete w;
+    }
+    return timer.nsecsElapsed() / ((qint64) count * THREADS);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int count = args.size() > 1 ? args.at(1).toInt() : 1000000;
+
+    toRingLog::setSink(&countingSink);
+
+    toRingLog::setEnabled(LOG, false);
+    std::cout << "disabled: " << runWriters(count) << " ns per record" << std::endl;
+
+    toRingLog::setEnabled(LOG, true);
+    std::cout << "enabled:  " << runWriters(count) << " ns per record" << std::endl;
+    toRingLog::flush();
+
+    int total = count * THREADS;
+    std::cout << "received: " << received.load() << ", dropped: " << toRingLog::dropped() << std::endl;
+    if (received.load() + toRingLog::dropped() != total)
+        return 1;
+
+    // "abc" takes 3 bytes, the QString starts at offset 4 and gets the remaining (96 - 4) / 2 characters
+    toRingLog::setSink(&lastLineSink);
+    QString text(60, QChar(0x17e));
+    TLOGF(LOG, "%1|%2", "abc", text);
+    toRingLog::flush();
+    QMutexLocker lock(&lastLock);
+    bool ok = last.endsWith(" abc|" + text.left((toRingLog::TEXT_SIZE - 4) / 2));
+    std::cout << "utf-16 argument: " << (ok ? "ok" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
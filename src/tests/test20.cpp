@@ -0,0 +1,118 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+/* Bench connection provider benchmark.
+ * Fetches a synthetic result set through toQuery, checks that two runs with
+ * the same seed return the same data and that the simulated latency is spent.
+ * Usage: test20 [rows]
+ */
+#include "core/toconnection.h"
+#include "core/toconnectionprovider.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toquery.h"
+#include "core/toqvalue.h"
+#include "connection/tobenchprovider.h"
+
+#include <QApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+
+#include <iostream>
+#include <memory>
+
+static uint fetchAll(toConnection &conn, QString const& sql, quint64 &rows)
+{
+    toConnectionSubLoan loan(conn);
+    toQuery query(loan, sql, toQueryParams());
+    uint checksum = 0;
+    unsigned columns = query.columns();
+    unsigned col = 0;
+    rows = 0;
+    while (!query.eof())
+    {
+        toQValue val = query.readValue();
+        checksum = checksum * 31 + qHash(val.isNull() ? QString("<NULL>") : val.displayData());
+        if (++col == columns)
+        {
+            col = 0;
+            rows++;
+        }
+    }
+    return checksum;
+}
+
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+    QStringList args = app.arguments();
+    int count = args.size() > 1 ? args.at(1).toInt() : 100000;
+
+    try
+    {
+        std::unique_ptr<toConnectionProviderFinder> finder = ConnectionProviderFinderFactory::Instance().create(BENCH_FINDER, 0);
+        Q_FOREACH(toConnectionProviderFinder::ConnectionProvirerParams const& params, finder->find())
+            toConnectionProviderRegistrySing::Instance().load(params);
+
+        QSet<QString> options;
+        options << "TEST";
+        toConnection conn(BENCH_PROVIDER, "bench", "", "localhost", "bench", "", "", options);
+
+        QString sql = QString("select * from t /*bench rows=%1 cols=int,number,varchar(40),char(10),date,clob(2000) nulls=0.1 batch=500 seed=7*/")
+                      .arg(count);
+        quint64 rows1, rows2;
+        QElapsedTimer timer;
+        timer.start();
+        uint sum1 = fetchAll(conn, sql, rows1);
+        qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+        uint sum2 = fetchAll(conn, sql, rows2);
+        std::cout << "fetched:  " << rows1 << " rows in " << elapsed << " ms, "
+                  << rows1 * 1000 / elapsed << " rows/s" << std::endl;
+
+        timer.restart();
+        quint64 rows3;
+        fetchAll(conn, "select 1 from t /*bench rows=1000 cols=int batch=100 latency=10 exec=0*/", rows3);
+        elapsed = timer.elapsed();
+        std::cout << "latency:  " << rows3 << " rows in " << elapsed << " ms (expected >= 100 ms)" << std::endl;
+
+        bool ok = rows1 == (quint64)count && rows2 == rows1 && sum1 == sum2 && rows3 == 1000 && elapsed >= 100;
+        std::cout << (ok ? "OK" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    catch (QString const& str)
+    {
+        std::cerr << "Unhandled exception: " << str.toStdString() << std::endl;
+        return 2;
+    }
+}
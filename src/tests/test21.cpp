@@ -0,0 +1,94 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+/* Object cache incremental refresh test (toCache::staleSchemas).
+ * Checks which schemas the delta refresh re-reads for given cached and current object counts.
+ * Usage: test21
+ */
+#include "core/tocache.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QStringList>
+
+#include <iostream>
+
+static int failures = 0;
+
+static void check(const char *what, QMap<QString, int> const& cached, QMap<QString, int> const& current, QStringList expected)
+{
+    QStringList stale = toCache::staleSchemas(cached, current);
+    stale.sort();
+    expected.sort();
+    if (stale != expected)
+    {
+        std::cout << "FAILED " << what << ": got (" << qPrintable(stale.join(",")) << ") expected ("
+                  << qPrintable(expected.join(",")) << ")" << std::endl;
+        failures++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QMap<QString, int> cached;
+    cached["HR"] = 10;
+    cached["SCOTT"] = 4;
+    cached["EMPTY"] = 0;
+
+    QMap<QString, int> current(cached);
+    check("unchanged", cached, current, QStringList());
+
+    current["SCOTT"] = 3;
+    check("dropped object", cached, current, QStringList() << "SCOTT");
+
+    current = cached;
+    current["APP"] = 7;
+    check("new schema", cached, current, QStringList() << "APP");
+
+    current = cached;
+    current["NOOBJECTS"] = 0;
+    check("new schema without objects", cached, current, QStringList());
+
+    current = cached;
+    current.remove("HR");
+    check("schema no longer visible", cached, current, QStringList() << "HR");
+
+    current.remove("EMPTY");
+    check("empty schema no longer visible", cached, current, QStringList() << "HR");
+
+    check("nothing cached yet", QMap<QString, int>(), cached, QStringList() << "HR" << "SCOTT");
+
+    std::cout << (failures ? "FAILED" : "OK") << std::endl;
+    return failures ? 1 : 0;
+}
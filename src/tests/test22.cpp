@@ -0,0 +1,174 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+
+/* Line state reuse test of toLexerOracle.
+ * A line is not lexed again only if it was not edited since it was styled and it starts
+ * in the same state as then. Lines whose styles are kept are marked with a style no lexer
+ * produces, the test checks which of them survive an edit and that the document is
+ * styled as by a full restyle at the end.
+ * Usage: test22
+ */
+#include "parsing/tolexeroracle.h"
+#include "core/toconfiguration.h"
+
+#include <QApplication>
+#include <QtCore/QLibrary>
+#include <Qsci/qsciscintilla.h>
+
+#include <iostream>
+
+static const int MARK = toLexerOracle::MaxStyle + 1;
+
+static int failures = 0;
+
+static void check(bool condition, const char *what)
+{
+    if (!condition)
+    {
+        std::cout << "FAILED " << what << std::endl;
+        failures++;
+    }
+}
+
+static void colourise(QsciScintilla &editor)
+{
+    editor.SendScintilla(QsciScintilla::SCI_COLOURISE, 0, -1);
+}
+
+// Overwrite styles of a line without touching its text or line state
+static void mark(QsciScintilla &editor, int line)
+{
+    long start = editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, line);
+    long end = editor.SendScintilla(QsciScintilla::SCI_GETLINEENDPOSITION, line);
+    editor.SendScintilla(QsciScintilla::SCI_STARTSTYLING, start, 0x1f);
+    editor.SendScintilla(QsciScintilla::SCI_SETSTYLING, end - start, MARK);
+}
+
+static bool marked(QsciScintilla &editor, int line)
+{
+    long start = editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, line);
+    return editor.SendScintilla(QsciScintilla::SCI_GETSTYLEAT, start) == MARK;
+}
+
+static bool styled(QsciScintilla &editor, int line)
+{
+    return editor.SendScintilla(QsciScintilla::SCI_GETLINESTATE, line) & toLexerOracle::StateStyled;
+}
+
+static void replaceLine(QsciScintilla &editor, int line, const char *text)
+{
+    editor.SendScintilla(QsciScintilla::SCI_SETTARGETSTART, editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, line));
+    editor.SendScintilla(QsciScintilla::SCI_SETTARGETEND, editor.SendScintilla(QsciScintilla::SCI_GETLINEENDPOSITION, line));
+    editor.SendScintilla(QsciScintilla::SCI_REPLACETARGET, -1, text);
+}
+
+static bool sameAsFullRestyle(QsciScintilla &editor)
+{
+    QsciScintilla fresh;
+    fresh.setLexer(new toLexerOracle(&fresh));
+    fresh.setText(editor.text());
+    colourise(fresh);
+
+    int len = editor.SendScintilla(QsciScintilla::SCI_GETLENGTH);
+    for (int i = 0; i < len; i++)
+    {
+        if (editor.SendScintilla(QsciScintilla::SCI_GETSTYLEAT, i) != fresh.SendScintilla(QsciScintilla::SCI_GETSTYLEAT, i))
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    toConfiguration::setQSettingsEnv();
+
+    QApplication app(argc, argv);
+
+    QLibrary parsing("parsing");
+    parsing.load();
+
+    QsciScintilla editor;
+    editor.setLexer(new toLexerOracle(&editor));
+    editor.setText("SELECT 1 FROM dual;\n"
+                   "SELECT 'a' FROM dual;\n"
+                   "SELECT 'a' FROM dual;\n"
+                   "SELECT 2 FROM dual;\n");
+    colourise(editor);
+    for (int line = 0; line < 4; line++)
+        check(styled(editor, line), "all lines styled");
+
+    // An edited line loses its state, the others keep it and are not lexed again
+    for (int line = 0; line < 4; line++)
+        mark(editor, line);
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, 1), "  ");
+    check(!styled(editor, 1), "inserted into line is reset");
+    check(styled(editor, 2) && styled(editor, 3), "lines below an edit keep their state");
+    colourise(editor);
+    check(!marked(editor, 1), "edited line is styled again");
+    check(marked(editor, 2) && marked(editor, 3), "lines starting in the same state are reused");
+
+    // Replacing a line by the text it already has leaves new characters without styles
+    mark(editor, 1);
+    replaceLine(editor, 1, editor.text(1).remove('\n').toLatin1().constData());
+    check(!styled(editor, 1), "replaced line is reset");
+    colourise(editor);
+    check(!marked(editor, 1), "line replaced by the same text is styled again");
+
+    // A deletion resets the line too
+    mark(editor, 2);
+    editor.SendScintilla(QsciScintilla::SCI_DELETERANGE, editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, 2), 1);
+    check(!styled(editor, 2), "line with deleted text is reset");
+    colourise(editor);
+    check(!marked(editor, 2), "line with deleted text is styled again");
+    check(marked(editor, 3), "line below a deletion is reused");
+
+    // Lines starting in another state are lexed again even if they were not edited
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, 0, "/* ");
+    colourise(editor);
+    check(!marked(editor, 3), "line starting inside a comment is styled again");
+    check((editor.SendScintilla(QsciScintilla::SCI_GETLINESTATE, 3) & toLexerOracle::StateKindMask) == toLexerOracle::StateComment,
+          "comment left open till the end");
+    editor.SendScintilla(QsciScintilla::SCI_DELETERANGE, 0, 3);
+    colourise(editor);
+
+    // New lines get a copy of the next line's state from Scintilla, it must not be reused
+    editor.SendScintilla(QsciScintilla::SCI_INSERTTEXT, editor.SendScintilla(QsciScintilla::SCI_POSITIONFROMLINE, 3), "SELECT 2 FROM dual;\n");
+    check(!styled(editor, 3), "inserted line is reset");
+    colourise(editor);
+    check(styled(editor, 3), "inserted line is styled");
+
+    check(sameAsFullRestyle(editor), "incremental styling matches full restyle");
+
+    std::cout << (failures ? "FAILED" : "OK") << std::endl;
+    return failures ? 1 : 0;
+}
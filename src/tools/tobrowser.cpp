@@ -54,6 +54,7 @@
 #include "widgets/toresultschema.h"
 #include "core/toconnectionsub.h"
 #include "core/toconnectiontraits.h"
+#include "core/tocache.h"
 #include "core/toglobalevent.h"
 #include "core/toconfiguration.h"
 #include "toresultview.h"
@@ -1471,6 +1472,8 @@ void toBrowser::refresh(void)
     try
     {
         mainTab_currentChanged(m_mainTab->currentIndex(), NO_USE_CACHE); // just a test do now requery the DB   // true);
+        // The current list was re-read, bring the rest of the object cache up to date too
+        connection().getCache().updateCache();
     }
     TOCATCH
 }
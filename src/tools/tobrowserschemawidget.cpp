@@ -94,10 +94,10 @@ void toBrowserSchemaTableView::updateCache(void)
     QList<toCache::CacheEntry*> rows;
     toCache::CacheEntry *obj;
     // TODO: Check that result model rows are NOT sorted in descending order as that would break updating of cache!!!
-    toQueryAbstr::RowList modelRows = this->Model->getRawData();
-    for (QList<toQueryAbstr::Row>::iterator i = modelRows.begin(); i != modelRows.end(); i++)
+    toResultColumnStore const& modelRows = this->Model->getRawData();
+    for (int i = 0; i < modelRows.rowCount(); i++)
     {
-        obj = toCache::createCacheEntry(Schema, (QString)(*i)[1], ObjectType, "");
+        obj = toCache::createCacheEntry(Schema, (QString)modelRows.value(i, 1), ObjectType, "");
         if (obj != NULL) // Some objects (like DBLINKs are not held in the toCache => obj == NULL
             rows.append(obj);
     }
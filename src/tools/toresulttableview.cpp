@@ -45,15 +45,18 @@
 #include "core/tolistviewformatter.h"
 #include "core/tolistviewformatterfactory.h"
 #include "core/tolistviewformatteridentifier.h"
+#include "core/toexportstream.h"
 #include "widgets/toworkingwidget.h"
 #include "core/toglobalconfiguration.h"
 #include "core/todatabaseconfig.h"
 #include "core/tocontextmenu.h"
+#include "parsing/tsqllexer.h"
 
 #include <QtCore/QSize>
 #include <QtCore/QTimer>
 #include <QtCore/QtDebug>
 #include <QtCore/QMimeData>
+#include <QtCore/QFile>
 #include <QtGui/QClipboard>
 #include <QtGui/QFont>
 #include <QtGui/QFontMetrics>
@@ -63,8 +66,28 @@
 #include <QVBoxLayout>
 #include <QProgressDialog>
 
+#include <climits>
+#include <memory>
+
 QMap<QString, toResultTableView*> toResultTableView::Registry;
 
+// Only a plain SELECT can be executed again by the streamed export (see toResultTableView::editSave)
+static bool isPlainSelect(toConnection &conn, QString const &sql)
+{
+    const char *lexerName;
+    if (conn.providerIs("Oracle"))
+        lexerName = "OracleGuiLexer";
+    else if (conn.providerIs("QMYSQL"))
+        lexerName = "MySQLGuiLexer";
+    else if (conn.providerIs("QPSQL"))
+        lexerName = "PostreSQLGuiLexer";
+    else
+        return false;
+
+    std::unique_ptr <SQLLexer::Lexer> lexer = LexerFactTwoParmSing::Instance().create(lexerName, sql, "toResultTableView::isPlainSelect");
+    return lexer->isPlainSelect();
+}
+
 toResultTableView::toResultTableView(QWidget * parent)
     : QTableView(parent)
     , toResult()
@@ -114,6 +137,8 @@ void toResultTableView::setup(bool readable, bool numberColumn, bool editable)
     ColumnsResized  = false;
     Ready           = false;
     Finished        = false;
+    DedicatedSession = false;
+    ExportProgress  = NULL;
 
     Working = new toWorkingWidget(this);
     connect(Working, SIGNAL(stop()), this, SLOT(slotStop()));
@@ -195,6 +220,8 @@ void toResultTableView::query(const QString &sql, toQueryParams const& param)
                                                , toEventQuery::READ_FIRST
                                                //, Statistics
                                               );
+        DedicatedSession = false;
+        SessionSchema = query->schema();
 
         toResultModel *model = allocModel(query);
         setModel(model);
@@ -260,6 +287,8 @@ void toResultTableView::querySub(QSharedPointer<toConnectionSubLoan> &con, const
                                                , toEventQuery::READ_FIRST
                                                //, Statistics
                                               );
+        DedicatedSession = true;
+        SessionSchema = query->schema();
 
         toResultModel *model = allocModel(query);
         setModel(model);
@@ -730,6 +759,27 @@ bool toResultTableView::editSave(bool askfile)
         if (filename.isEmpty())
             return false;
 
+        // Do not read the rest of a large result into the model, stream it into the file.
+        // The query is executed again for it, so only plain SELECTs and only if the user agrees
+        if (!Finished && !DedicatedSession && !sql().isEmpty() && toExportStream::canStream(settings) && isPlainSelect(connection(), sql()))
+        {
+            switch (TOMessageBox::question(this,
+                                           tr("Export"),
+                                           tr("Not all rows are read yet. Execute the query again on another "
+                                              "session and write its result directly into the file?\n"
+                                              "Rows changed since the query was executed will differ from those displayed.\n"
+                                              "('No' reads the remaining rows into the grid first)"),
+                                           QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel))
+            {
+                case QMessageBox::Yes:
+                    return exportStream(settings, filename);
+                case QMessageBox::No:
+                    break;
+                default:
+                    return false;
+            }
+        }
+
         return Utils::toWriteFile(filename, exportAsText(settings));
     }
     TOCATCH;
@@ -737,6 +787,54 @@ bool toResultTableView::editSave(bool askfile)
     return false;
 }
 
+bool toResultTableView::exportStream(toExportSettings const &settings, QString const &filename)
+{
+    QFile file(Utils::toExpandFile(filename));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        TOMessageBox::warning(this, tr("File error"), tr("Couldn't open %1 for writing").arg(filename));
+        return false;
+    }
+
+    QString schema = SessionSchema.isEmpty() ? connection().defaultSchema() : SessionSchema;
+    toExportStream stream(connection(), schema, sql(), params(), settings, &file);
+
+    QProgressDialog progress(tr("Exporting data..."), tr("Abort"), 0, 0, parentWidget());
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setAutoClose(false);
+    progress.setAutoReset(false);
+    connect(&progress, SIGNAL(canceled()), &stream, SLOT(cancel()));
+    connect(&stream, SIGNAL(progress(int)), this, SLOT(slotExportProgress(int)));
+    connect(&stream, SIGNAL(finished()), &progress, SLOT(accept()));
+
+    // the signals are queued, finished() is delivered by exec() even if the export is done before
+    ExportProgress = &progress;
+    stream.start();
+    progress.exec();
+    ExportProgress = NULL;
+    // canceled, the rest of the current chunk is still being read
+    stream.wait(ULONG_MAX);
+
+    if (!stream.error().isEmpty())
+    {
+        TOMessageBox::warning(this, tr("Export error"), stream.error());
+        return false;
+    }
+    if (stream.wasCanceled())
+    {
+        Utils::toStatusMessage(tr("Export canceled after %1 rows").arg(stream.rows()), false, false);
+        return false;
+    }
+    Utils::toStatusMessage(tr("%1 rows exported").arg(stream.rows()), false, false);
+    return true;
+}
+
+void toResultTableView::slotExportProgress(int rows)
+{
+    if (ExportProgress)
+        ExportProgress->setLabelText(tr("Exporting data... %1 rows").arg(rows));
+}
+
 void toResultTableView::editCopy()
 {
     QClipboard *clip = qApp->clipboard();
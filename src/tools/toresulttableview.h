@@ -59,6 +59,7 @@ class toTableViewIterator;
 class toWorkingWidget;
 class toExportSettings;
 class toSearchReplace;
+class QProgressDialog;
 
 class toResultTableView : public QTableView, public toResult, public toEditWidget
 {
@@ -179,6 +180,13 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
          * Export list as a string.
          */
         QString exportAsText(toExportSettings settings);
+
+        /**
+         * Export all rows of the query into a file without reading them into the model,
+         * the query is executed again in the same schema (see @ref toExportStream).
+         * Used for plain SELECTs only, after the user has confirmed it.
+         */
+        bool exportStream(toExportSettings const &settings, QString const &filename);
         // ----- overrides toEditWidget
         /**
          * Perform a save on this widget.
@@ -293,6 +301,9 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
         // apply column rules, numbercolumn, readable columns
         virtual void slotApplyColumnRules(void);
 
+        // rows written by exportStream
+        void slotExportProgress(int rows);
+
     protected:
         //! \reimp
         void focusInEvent(QFocusEvent *e) override;
@@ -380,6 +391,16 @@ class toResultTableView : public QTableView, public toResult, public toEditWidge
         // helps work around determining when query.eof has been reached.
         bool Finished;
 
+        // set true when the query runs on a session of it's own (see querySub),
+        // its result can not be re-read on another session (see exportStream)
+        bool DedicatedSession;
+
+        // schema of the session the query runs on
+        QString SessionSchema;
+
+        // progress of exportStream, NULL when no export is running
+        QProgressDialog *ExportProgress;
+
         /**
          * context menu items. may be null
          */
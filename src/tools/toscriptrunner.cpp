@@ -0,0 +1,236 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "tools/toscriptrunner.h"
+#include "core/toconnectionsubloan.h"
+#include "core/toquery.h"
+#include "core/tologger.h"
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QTime>
+
+#include <exception>
+
+// Store any exception in the result r, the same set of exceptions as CATCH_ALL in toeventqueryworker.cpp
+#define CATCH_RESULT(r)                             \
+    catch (const QString &exc) {                    \
+        r.status = exc;                             \
+        r.error = true;                             \
+    }                                               \
+    catch (std::exception const &e) {               \
+        r.status = QString(e.what());               \
+        r.error = true;                             \
+    }                                               \
+    catch (...) {                                   \
+        r.status = tr("Unknown exception.");        \
+        r.error = true;                             \
+    }
+
+toScriptRunner::toScriptRunner(toConnection &conn, QString const& schema, toScriptAnalysisPtr script, int from, int to, QObject *parent)
+    : QObject(parent)
+    , m_connection(conn)
+    , m_schema(schema)
+    , m_script(script)
+    , m_from(from)
+    , m_to(qMin(to, script->entries().size()))
+    , m_thread(new toScriptRunnerThread(this))
+    , m_last(-1)
+    , m_notified(false)
+    , m_waiting(false)
+    , m_stop(false)
+{
+    m_thread->setObjectName("ScriptRunnerThread");
+}
+
+toScriptRunner::~toScriptRunner()
+{
+    stop();
+    m_thread->wait();
+    delete m_thread;
+}
+
+void toScriptRunner::start()
+{
+    m_thread->start();
+}
+
+void toScriptRunner::stop()
+{
+    QSharedPointer<toConnectionSubLoan> loan;
+    {
+        QMutexLocker lock(&m_mutex);
+        m_stop = true;
+        m_wake.wakeAll();
+        loan = m_loan;
+    }
+    // cancel may block on the connection, never do it while holding m_mutex
+    if (loan)
+        (*loan)->cancel();
+}
+
+void toScriptRunner::resume(bool stopExecution)
+{
+    QMutexLocker lock(&m_mutex);
+    m_stop = m_stop || stopExecution;
+    m_waiting = false;
+    m_wake.wakeAll();
+}
+
+QList<toScriptRunner::result> toScriptRunner::takeResults()
+{
+    QMutexLocker lock(&m_mutex);
+    QList<result> retval;
+    retval.swap(m_results);
+    m_notified = false;
+    return retval;
+}
+
+bool toScriptRunner::isRunning() const
+{
+    return m_thread->isRunning();
+}
+
+int toScriptRunner::lastExecuted() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_last;
+}
+
+bool toScriptRunner::stopped() const
+{
+    QMutexLocker lock(&m_mutex);
+    return m_stop;
+}
+
+void toScriptRunner::push(result const& r)
+{
+    QMutexLocker lock(&m_mutex);
+    m_results.append(r);
+    m_last = r.index;
+    // Only one notification is pending at a time, the GUI collects all results queued so far
+    if (!m_notified)
+    {
+        m_notified = true;
+        emit progress();
+    }
+}
+
+void toScriptRunner::run()
+{
+    toScriptAnalysis::entryList const& entries = m_script->entries();
+    bool oracle = m_connection.providerIs("Oracle");
+    QTime total;
+    total.start();
+
+    result failure;
+    failure.index = m_from;
+    failure.duration = 0;
+    failure.error = false;
+    try
+    {
+        QSharedPointer<toConnectionSubLoan> loan(new toConnectionSubLoan(m_connection, m_schema));
+        {
+            QMutexLocker lock(&m_mutex);
+            m_loan = loan;
+        }
+
+        for (int i = m_from; i < m_to; i++)
+        {
+            {
+                QMutexLocker lock(&m_mutex);
+                if (m_stop)
+                    break;
+            }
+
+            toScriptAnalysis::entry const& entry = entries.at(i);
+            if (entry.firstWord.trimmed().isEmpty())
+                continue;
+
+            result r;
+            r.index = i;
+            r.error = false;
+            QTime time;
+            time.start();
+
+            if (entry.statementType == toSyntaxAnalyzer::SQLPLUS || (oracle && entry.firstWord.startsWith("EXEC", Qt::CaseInsensitive)))
+            {
+                r.status = tr("Ignoring SQL*Plus command");
+            }
+            else
+            {
+                try
+                {
+                    toQuery query(*loan, entry.sql, toQueryParams());
+                    if (query.rowsProcessed() > 0)
+                        r.status = tr("%1 rows processed").arg((int)query.rowsProcessed());
+                    else
+                        r.status = tr("Query executed");
+                }
+                CATCH_RESULT(r)
+            }
+            r.duration = time.elapsed();
+            push(r);
+
+            if (r.error)
+            {
+                QMutexLocker lock(&m_mutex);
+                if (m_stop)
+                    break;
+                m_waiting = true;
+                emit failed(i, r.status);
+                while (m_waiting && !m_stop)
+                    m_wake.wait(&m_mutex);
+                if (m_stop)
+                    break;
+            }
+        }
+    }
+    // Could not borrow a connection
+    CATCH_RESULT(failure)
+    if (failure.error)
+        push(failure);
+
+    {
+        QMutexLocker lock(&m_mutex);
+        m_loan.clear();
+    }
+    TLOG(0, toDecorator, __HERE__) << "Script executed: " << (m_last - m_from + 1)
+                                   << " statements in " << total.elapsed() << "ms" << std::endl;
+    emit finished();
+}
+
+void toScriptRunnerThread::run()
+{
+    m_runner->run();
+}
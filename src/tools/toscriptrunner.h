@@ -0,0 +1,136 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#pragma once
+
+#include "core/toconnection.h"
+#include "editor/toscriptanalysis.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QThread>
+#include <QtCore/QSharedPointer>
+
+class toConnectionSubLoan;
+class toScriptRunnerThread;
+
+/** Executes statements of an analyzed script on a background connection loan ("Execute All").
+ *
+ * Statements are sent to the database one after another from a worker thread, result sets are never fetched.
+ * Per-statement outcomes are queued and the GUI is notified by @ref progress signal, which is coalesced
+ * so the consumer collects any number of finished statements with @ref takeResults at its own pace.
+ * The worker only waits for the GUI when a statement fails (@ref failed signal, answered by @ref resume).
+ */
+class toScriptRunner : public QObject
+{
+        Q_OBJECT;
+        friend class toScriptRunnerThread;
+    public:
+        struct result
+        {
+            int index;      // index into toScriptAnalysis::entries()
+            QString status; // "N rows processed" or an error message
+            int duration;   // ms
+            bool error;
+        };
+
+        /** Execute entries [from, to) of the script using connection and schema */
+        toScriptRunner(toConnection &conn, QString const& schema, toScriptAnalysisPtr script, int from, int to, QObject *parent = NULL);
+        virtual ~toScriptRunner();
+
+        void start();
+
+        /** Cancel the running statement and skip all remaining ones. Can be called from any thread. */
+        void stop();
+
+        /** Answer to @ref failed signal. Continue with the next statement or stop */
+        void resume(bool stopExecution);
+
+        /** Take outcomes of the statements finished since the last call */
+        QList<result> takeResults();
+
+        bool isRunning() const;
+
+        toScriptAnalysisPtr script() const
+        {
+            return m_script;
+        }
+
+        /** Index of the last statement executed (successfully or not) */
+        int lastExecuted() const;
+
+        /** True when execution was stopped by the user (by @ref stop or answering @ref failed) */
+        bool stopped() const;
+
+    signals:
+        /** New results are available, see @ref takeResults */
+        void progress();
+
+        /** Statement failed, execution is paused until @ref resume is called */
+        void failed(int index, QString const& message);
+
+        void finished();
+
+    private:
+        // Called from the worker thread
+        void run();
+        void push(result const&);
+
+        toConnection &m_connection;
+        QString m_schema;
+        toScriptAnalysisPtr m_script;
+        int m_from, m_to;
+
+        toScriptRunnerThread *m_thread;
+
+        mutable QMutex m_mutex;
+        QWaitCondition m_wake;
+        QList<result> m_results;
+        QSharedPointer<toConnectionSubLoan> m_loan;
+        int m_last;
+        bool m_notified, m_waiting, m_stop;
+};
+
+class toScriptRunnerThread : public QThread
+{
+    public:
+        toScriptRunnerThread(toScriptRunner *runner) : QThread(), m_runner(runner) {};
+    protected:
+        void run() override;
+    private:
+        toScriptRunner *m_runner;
+};
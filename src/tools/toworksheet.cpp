@@ -70,6 +70,8 @@
 #include "parsing/tsqllexer.h"
 #include "core/tosyntaxanalyzer.h"
 #include "editor/tosyntaxanalyzernl.h"
+#include "editor/toscriptanalysis.h"
+#include "tools/toscriptrunner.h"
 #include "editor/tosyntaxanalyzeroracle.h"
 
 #include "editor/tosqltext.h"
@@ -82,7 +84,6 @@
 #include <QtCore/QSettings>
 #include <QtCore/QTextStream>
 #include <QInputDialog>
-#include <QProgressDialog>
 
 #include "icons/clock.xpm"
 #include "icons/recall.xpm"
@@ -618,6 +619,8 @@ toWorksheet::toWorksheet(QWidget *main, toConnection &connection, bool autoLoad)
     , CurrentTab(NULL)
     , ResultModel(NULL)
     , lockConnectionActClicked(false)
+    , ScriptRunner(NULL)
+    , ScriptResultIndex(-1)
 {
     createActions();
     setup(autoLoad);
@@ -1469,49 +1472,113 @@ void toWorksheet::slotToggleStatistic(void)
 
 void toWorksheet::slotExecuteAll()
 {
+    if (ScriptRunner)
+        return;
+
     /* TODO get analyzer from Editor->editor() */
     toSyntaxAnalyzerNL analyzer(Editor);
-    toSyntaxAnalyzer::statementList stats = analyzer.getStatements(Editor->text());
+    toScriptAnalysisPtr script;
+    {
+        Utils::toBusy busy;
+        script = toScriptAnalysis::analyze(analyzer, Editor->text());
+    }
+    TLOG(0, toDecorator, __HERE__) << "Script analyzed: " << script->entries().size()
+                                   << " statements in " << script->elapsed() << "ms" << std::endl;
 
-    int cpos, cline, lastLinePos;
+    int cpos, cline;
     Editor->getCursorPosition(&cline, &cpos);
 
-    QProgressDialog dialog(tr("Executing all statements"),
-                           tr("Cancel"),
-                           0,
-                           Editor->lines(),
-                           this);
-    Q_FOREACH(toSyntaxAnalyzer::statement stat, stats)
-    {
-        dialog.setValue(stat.lineFrom);
-        qApp->processEvents();
-        if (dialog.wasCanceled())
-            break;
+    toScriptAnalysis::entryList const& entries = script->entries();
+    int from = 0, to = entries.size();
+    while (from < to && entries.at(from).lineTo < cline)
+        from++;
+    while (to > from && entries.at(to - 1).firstWord.trimmed().isEmpty())
+        to--;
+    if (from == to)
+        return;
 
-        if ( stat.lineTo < cline)
-            continue;
+    // Result sets are not fetched by the script runner, only the trailing SELECT is displayed
+    ScriptResultIndex = -1;
+    if (entries.at(to - 1).statementType == toSyntaxAnalyzer::SELECT)
+        ScriptResultIndex = --to;
 
-        analyzer.sanitizeStatement(stat);
+    Result->slotStop();
+    RefreshTimer.stop();
+    Editor->setSelection(entries.at(from).lineFrom, 0, entries.at(qMax(from, to - 1)).lineTo, entries.at(qMax(from, to - 1)).indexTo);
 
-        try
-        {
-            query(stat, Direct, DontSelectQueryEnum);
-        }
-        catch ( BatchExecException const& e)
-        {
-            Q_UNUSED(e);
-            break;
-        }
+    ScriptRunner = new toScriptRunner(connection(), schema(), script, from, to, this);
+    connect(ScriptRunner, SIGNAL(progress()), this, SLOT(slotScriptProgress()));
+    connect(ScriptRunner, SIGNAL(failed(int, QString const&)), this, SLOT(slotScriptFailed(int, QString const&)));
+    connect(ScriptRunner, SIGNAL(finished()), this, SLOT(slotScriptFinished()));
+
+    executeAllAct->setDisabled(true);
+    stopAct->setEnabled(true);
+    Started->setToolTip(tr("Duration while script has been running"));
+    Utils::toStatusMessage(tr("Executing all statements"), true, false);
+    Time.start();
+    Poll.start(1000);
+    ScriptRunner->start();
+}
+
+void toWorksheet::slotScriptProgress()
+{
+    if (!ScriptRunner)
+        return;
 
-        if (Current)
-            if (toResultView *last = dynamic_cast<toResultView *>(Current))
-                if (toConfigurationNewSingle::Instance().option(ToConfiguration::Worksheet::ExecLogBool).toBool())
-                    if (last->firstChild())
-                        History[LastID] = last;
-        lastLinePos = stat.lineTo;
+    QList<toScriptRunner::result> results = ScriptRunner->takeResults();
+    toScriptAnalysis::entryList const& entries = ScriptRunner->script()->entries();
+    for (int i = 0; i < results.size(); i++)
+    {
+        toScriptRunner::result const& r = results.at(i);
+        addLog(entries.at(r.index).sql, r.status, duration(r.duration), i == results.size() - 1);
     }
+}
+
+void toWorksheet::slotScriptFailed(int index, QString const& message)
+{
+    if (!ScriptRunner)
+        return;
 
-    Editor->setSelection(cline, 0, lastLinePos+1, 0);
+    slotScriptProgress();
+    toScriptAnalysis::entry const& entry = ScriptRunner->script()->entries().at(index);
+    Editor->setSelection(entry.lineFrom, 0, entry.lineTo, entry.indexTo);
+    bool stop = QMessageBox::question(this, tr("Direct Execute Error"),
+                                      message + "\n\n" + tr("Stop execution ('No' to continue)?"),
+                                      QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes;
+    if (ScriptRunner)
+        ScriptRunner->resume(stop);
+}
+
+void toWorksheet::slotScriptFinished()
+{
+    if (!ScriptRunner)
+        return;
+
+    slotScriptProgress();
+    Poll.stop();
+    stopAct->setDisabled(true);
+    executeAllAct->setEnabled(true);
+    Utils::toStatusMessage(tr("Script executed") + " " + tr("(Duration ") + duration(Time.elapsed()) + ")", false, false);
+
+    toScriptAnalysisPtr script = ScriptRunner->script();
+    bool stopped = ScriptRunner->stopped();
+    int last = ScriptRunner->lastExecuted();
+    ScriptRunner->deleteLater();
+    ScriptRunner = NULL;
+
+    if (!stopped && ScriptResultIndex >= 0)
+    {
+        toScriptAnalysis::entry const& entry = script->entries().at(ScriptResultIndex);
+        toSyntaxAnalyzer::statement stat(entry);
+        stat.posFrom = Editor->positionFromLineIndex(entry.lineFrom, 0);
+        stat.posTo = Editor->positionFromLineIndex(entry.lineTo, entry.indexTo);
+        query(stat, Normal);
+    }
+    else if (last >= 0)
+    {
+        toScriptAnalysis::entry const& entry = script->entries().at(last);
+        Editor->setSelection(entry.lineFrom, 0, entry.lineTo, entry.indexTo);
+    }
 }
 
 void toWorksheet::slotParse()
@@ -2093,6 +2160,8 @@ void toWorksheet::slotStop(void)
 {
     RefreshTimer.stop();
     Result->slotStop();
+    if (ScriptRunner)
+        ScriptRunner->stop();
 }
 
 void toWorksheet::slotChangeConnection(void)
@@ -2204,9 +2273,13 @@ bool toWorksheet::checkUnlockConnection()
 }
 
 void toWorksheet::addLog(const QString &result)
+{
+    addLog(m_lastQuery.sql, result, duration(Time.elapsed()));
+}
+
+void toWorksheet::addLog(const QString &sql, const QString &result, const QString &dur, bool select)
 {
     using namespace ToConfiguration;
-    QString dur = duration(Time.elapsed());
     QString now = QDateTime::currentDateTime().toString(Qt::SystemLocaleDate);
     toResultViewItem *item = NULL;
 
@@ -2223,15 +2296,18 @@ void toWorksheet::addLog(const QString &result)
         item = new toResultViewMLine(Logging, LastLogItem);
 
     LastLogItem = item;
-    item->setText(0, m_lastQuery.sql);
+    item->setText(0, sql);
     item->setText(1, result);
     item->setText(2, now);
     item->setText(3, dur);
     if (toConfigurationNewSingle::Instance().option(ToConfiguration::Worksheet::HistoryErrorBool).toBool())
         item->setText(4, QString::number(LastID));
 
+    if (!select)
+        return;
+
     toResultViewItem *citem= dynamic_cast<toResultViewItem *>(Logging->currentItem());
-    if (!citem || citem->allText(0) != m_lastQuery.sql)
+    if (!citem || citem->allText(0) != sql)
     {
         bool oldState = Logging->blockSignals(true);
         Logging->setSelected(item, true);
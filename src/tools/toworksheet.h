@@ -74,6 +74,7 @@ class toTabWidget;
 class toTreeWidgetItem;
 class toEditableMenu;
 class toRefreshCombo;
+class toScriptRunner;
 
 namespace ToConfiguration
 {
@@ -205,6 +206,10 @@ class toWorksheet : public toToolWidget, public toContextMenuHandler
         void slotUnhideResults(const QString &, const toConnection::exception &, bool);
         void slotUnhideResults(void);
 
+        void slotScriptProgress(void);
+        void slotScriptFailed(int, QString const&);
+        void slotScriptFinished(void);
+
     private:
 
         class BatchExecException : public std::exception
@@ -233,6 +238,7 @@ class toWorksheet : public toToolWidget, public toContextMenuHandler
         void mySQLBeforeCreate(QString &chk);
 
         void addLog(const QString &result);
+        void addLog(const QString &sql, const QString &result, const QString &dur, bool select = true);
 
         void queryStarted(const toSyntaxAnalyzer::statement &stat);
         void lockConnection();
@@ -289,6 +295,11 @@ class toWorksheet : public toToolWidget, public toContextMenuHandler
 
         QSharedPointer<toConnectionSubLoan> LockedConnection;
         bool lockConnectionActClicked;
+
+        // Background "Execute All", NULL when no script is running
+        toScriptRunner *ScriptRunner;
+        // Trailing SELECT of the script, its result is displayed after the script is done
+        int ScriptResultIndex;
 };
 
 
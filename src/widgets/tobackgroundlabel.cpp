@@ -36,6 +36,7 @@
 #include "core/utils.h"
 #include "core/toconnectionregistry.h"
 #include "core/toconnection.h"
+#include "core/toeventquerypool.h"
 
 #include <QtGui/QMovie>
 #include <QtGui/QMouseEvent>
@@ -99,6 +100,8 @@ void toBackgroundLabel::mouseReleaseEvent(QMouseEvent *e)
                     num++;
                 }
             }
+            toEventQueryPool::Metrics m = toEventQueryPoolSingle::Instance().metrics();
+            str += QString("Query threads: %1, busy workers: %2, queued: %3\n").arg(m.threads).arg(m.busy).arg(m.queued);
             Utils::toStatusMessage(str);
             e->accept();
         }
@@ -0,0 +1,592 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#include "widgets/toresultcolumnstore.h"
+
+#include <QtCore/QVariant>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Arena is compacted when at least this many elements and more than half of it are unused
+    const quint64 COMPACT_MIN = 4096;
+
+    inline bool isSigned(quint8 type)
+    {
+        return type == QVariant::Int || type == QVariant::LongLong;
+    }
+
+    inline double asDouble(quint64 bits, quint8 type)
+    {
+        switch (type)
+        {
+            case QVariant::Double:
+                {
+                    double d;
+                    memcpy(&d, &bits, sizeof(d));
+                    return d;
+                }
+            case QVariant::UInt:
+            case QVariant::ULongLong:
+                return (double) bits;
+            default:
+                return (double)(qint64) bits;
+        }
+    }
+
+    // Same ordering as toQValue::operator< uses for two numbers
+    inline bool lessNumber(quint64 l, quint8 lt, quint64 r, quint8 rt)
+    {
+        if (lt == QVariant::Double || rt == QVariant::Double)
+            return asDouble(l, lt) < asDouble(r, rt);
+        if (isSigned(lt) && isSigned(rt))
+            return (qint64) l < (qint64) r;
+        if (isSigned(lt) && (qint64) l < 0)
+            return true;
+        if (isSigned(rt) && (qint64) r < 0)
+            return false;
+        return l < r;
+    }
+}
+
+toResultColumnStore::Column::Column()
+    : kind(toResultColumnStore::Empty)
+    , garbage(0)
+{
+}
+
+toResultColumnStore::toResultColumnStore()
+    : Physical(0)
+{
+}
+
+toResultColumnStore::~toResultColumnStore()
+{
+}
+
+void toResultColumnStore::clear()
+{
+    Columns.clear();
+    Descs.clear();
+    Order.clear();
+    Free.clear();
+    Physical = 0;
+}
+
+void toResultColumnStore::setColumnCount(int cols)
+{
+    int old = columnCount();
+    Columns.resize(cols);
+    for (int c = old; c < cols; c++)
+        Columns[c].nulls.assign((Physical + 31) >> 5, 0xffffffffu);
+}
+
+toResultColumnStore::ColumnKind toResultColumnStore::kindOf(const toQValue &value)
+{
+    switch (value.toQVariant().type())
+    {
+        case QVariant::Int:
+        case QVariant::UInt:
+        case QVariant::LongLong:
+        case QVariant::ULongLong:
+        case QVariant::Double:
+            return Number;
+        case QVariant::String:
+            return String;
+        case QVariant::ByteArray:
+            return Binary;
+        default:
+            return Variant;
+    }
+}
+
+void toResultColumnStore::setNullAt(Column &column, int physical, bool null)
+{
+    if (null)
+        column.nulls[physical >> 5] |= (1u << (physical & 31));
+    else
+        column.nulls[physical >> 5] &= ~(1u << (physical & 31));
+}
+
+int toResultColumnStore::appendPhysical(const toQueryAbstr::Row &row)
+{
+    if (row.size() > columnCount())
+        setColumnCount(row.size());
+
+    toRowDesc desc;
+    if (row.isEmpty())
+    {
+        desc.key = 0;
+        desc.status = EXISTED;
+    }
+    else
+    {
+        desc = row.at(0).getRowDesc();
+    }
+
+    if (!Free.empty())
+    {
+        // Cells of a removed row were released, they are all NULL
+        int physical = Free.back();
+        Free.pop_back();
+        Descs[physical] = desc;
+        for (int c = 1; c < columnCount() && c < row.size(); c++)
+            store(Columns[c], physical, row.at(c));
+        return physical;
+    }
+
+    int physical = Physical++;
+    Descs.push_back(desc);
+
+    for (int c = 1; c < columnCount(); c++)
+    {
+        Column &column = Columns[c];
+        if (column.nulls.size() < (size_t)((Physical + 31) >> 5))
+            column.nulls.push_back(0);
+        setNullAt(column, physical, true);
+        switch (column.kind)
+        {
+            case Empty:
+                break;
+            case Number:
+                column.numbers.push_back(0);
+                column.numberTypes.push_back(QVariant::Invalid);
+                break;
+            case String:
+            case Binary:
+                column.offsets.push_back(0);
+                column.lengths.push_back(0);
+                break;
+            case Variant:
+                column.variants.emplace_back();
+                break;
+        }
+        if (c < row.size())
+            store(column, physical, row.at(c));
+    }
+    return physical;
+}
+
+void toResultColumnStore::appendRow(const toQueryAbstr::Row &row)
+{
+    Order.push_back(appendPhysical(row));
+}
+
+void toResultColumnStore::insertRow(int pos, const toQueryAbstr::Row &row)
+{
+    int physical = appendPhysical(row);
+    pos = qBound(0, pos, rowCount());
+    Order.insert(Order.begin() + pos, physical);
+}
+
+void toResultColumnStore::removeRow(int row)
+{
+    int physical = Order[row];
+    Order.erase(Order.begin() + row);
+    for (int c = 1; c < columnCount(); c++)
+        release(Columns[c], physical);
+    Free.push_back(physical);
+}
+
+void toResultColumnStore::release(Column &column, int physical)
+{
+    if (!nullAt(column, physical))
+    {
+        switch (column.kind)
+        {
+            case String:
+            case Binary:
+                column.garbage += column.lengths[physical];
+                column.lengths[physical] = 0;
+                break;
+            case Variant:
+                column.variants[physical] = toQValue();
+                break;
+            default:
+                break;
+        }
+        setNullAt(column, physical, true);
+    }
+    compact(column);
+}
+
+void toResultColumnStore::compact(Column &column)
+{
+    quint64 size = column.kind == String ? column.chars.size() : column.bytes.size();
+    if (column.garbage < COMPACT_MIN || column.garbage * 2 < size)
+        return;
+
+    // Copy the cells in use in physical order, releases removed rows and replaced values
+    if (column.kind == String)
+    {
+        std::vector<QChar> chars;
+        chars.reserve(size - column.garbage);
+        for (int p = 0; p < Physical; p++)
+        {
+            if (nullAt(column, p) || column.lengths[p] == 0)
+                continue;
+            QChar const *from = &column.chars[column.offsets[p]];
+            column.offsets[p] = chars.size();
+            chars.insert(chars.end(), from, from + column.lengths[p]);
+        }
+        column.chars.swap(chars);
+    }
+    else if (column.kind == Binary)
+    {
+        std::vector<char> bytes;
+        bytes.reserve(size - column.garbage);
+        for (int p = 0; p < Physical; p++)
+        {
+            if (nullAt(column, p) || column.lengths[p] == 0)
+                continue;
+            char const *from = &column.bytes[column.offsets[p]];
+            column.offsets[p] = bytes.size();
+            bytes.insert(bytes.end(), from, from + column.lengths[p]);
+        }
+        column.bytes.swap(bytes);
+    }
+    column.garbage = 0;
+}
+
+void toResultColumnStore::convert(Column &column, ColumnKind kind)
+{
+    if (column.kind == kind)
+        return;
+
+    if (column.kind == Empty)
+    {
+        switch (kind)
+        {
+            case Empty:
+                break;
+            case Number:
+                column.numbers.assign(Physical, 0);
+                column.numberTypes.assign(Physical, QVariant::Invalid);
+                break;
+            case String:
+            case Binary:
+                column.offsets.assign(Physical, 0);
+                column.lengths.assign(Physical, 0);
+                break;
+            case Variant:
+                column.variants.resize(Physical);
+                break;
+        }
+        column.kind = kind;
+        return;
+    }
+
+    // Mixed types in a typed column, fall back to plain values
+    Q_ASSERT(kind == Variant);
+    std::deque<toQValue> variants;
+    for (int p = 0; p < Physical; p++)
+        variants.emplace_back(load(column, p));
+
+    std::vector<quint64>().swap(column.numbers);
+    std::vector<quint8>().swap(column.numberTypes);
+    std::vector<quint64>().swap(column.offsets);
+    std::vector<quint32>().swap(column.lengths);
+    std::vector<QChar>().swap(column.chars);
+    std::vector<char>().swap(column.bytes);
+    column.variants.swap(variants);
+    column.kind = Variant;
+    column.garbage = 0;
+}
+
+void toResultColumnStore::store(Column &column, int physical, const toQValue &value)
+{
+    if (value.isNull())
+    {
+        release(column, physical);
+        return;
+    }
+
+    ColumnKind kind = kindOf(value);
+    if (column.kind == Empty)
+        convert(column, kind);
+    else if (column.kind != kind && column.kind != Variant)
+        convert(column, Variant);
+
+    // Arena space of the value being replaced, reused when the new one fits
+    quint32 old = 0;
+    if (!nullAt(column, physical) && (column.kind == String || column.kind == Binary))
+        old = column.lengths[physical];
+    setNullAt(column, physical, false);
+
+    QVariant const &v = value.toQVariant();
+    switch (column.kind)
+    {
+        case Empty:
+            break;
+        case Number:
+            {
+                quint64 bits = 0;
+                switch (v.type())
+                {
+                    case QVariant::Double:
+                        {
+                            double d = v.toDouble();
+                            memcpy(&bits, &d, sizeof(bits));
+                        }
+                        break;
+                    case QVariant::UInt:
+                    case QVariant::ULongLong:
+                        bits = v.toULongLong();
+                        break;
+                    default:
+                        bits = (quint64) v.toLongLong();
+                        break;
+                }
+                column.numbers[physical] = bits;
+                column.numberTypes[physical] = (quint8) v.type();
+            }
+            break;
+        case String:
+            {
+                QString const s = v.toString();
+                quint32 len = s.size();
+                if (len > old)
+                {
+                    column.offsets[physical] = column.chars.size();
+                    column.chars.insert(column.chars.end(), s.constData(), s.constData() + len);
+                    column.garbage += old;
+                }
+                else
+                {
+                    std::copy(s.constData(), s.constData() + len, column.chars.begin() + column.offsets[physical]);
+                    column.garbage += old - len;
+                }
+                column.lengths[physical] = len;
+                compact(column);
+            }
+            break;
+        case Binary:
+            {
+                QByteArray const a = v.toByteArray();
+                quint32 len = a.size();
+                if (len > old)
+                {
+                    column.offsets[physical] = column.bytes.size();
+                    column.bytes.insert(column.bytes.end(), a.constData(), a.constData() + len);
+                    column.garbage += old;
+                }
+                else
+                {
+                    std::copy(a.constData(), a.constData() + len, column.bytes.begin() + column.offsets[physical]);
+                    column.garbage += old - len;
+                }
+                column.lengths[physical] = len;
+                compact(column);
+            }
+            break;
+        case Variant:
+            // toQValue assignment moves complex types into the store
+            column.variants[physical] = value;
+            break;
+    }
+}
+
+toQValue toResultColumnStore::load(const Column &column, int physical) const
+{
+    if (nullAt(column, physical))
+        return toQValue();
+
+    switch (column.kind)
+    {
+        case Empty:
+            return toQValue();
+        case Number:
+            {
+                quint64 bits = column.numbers[physical];
+                switch (column.numberTypes[physical])
+                {
+                    case QVariant::Double:
+                        return toQValue(asDouble(bits, QVariant::Double));
+                    case QVariant::Int:
+                        return toQValue((int)(qint64) bits);
+                    case QVariant::UInt:
+                        return toQValue((unsigned int) bits);
+                    case QVariant::ULongLong:
+                        return toQValue((qulonglong) bits);
+                    default:
+                        return toQValue((qlonglong) bits);
+                }
+            }
+        case String:
+            {
+                quint32 len = column.lengths[physical];
+                if (len == 0)
+                    return toQValue(QString::fromLatin1(""));
+                return toQValue(QString(&column.chars[column.offsets[physical]], len));
+            }
+        case Binary:
+            {
+                quint32 len = column.lengths[physical];
+                if (len == 0)
+                    return toQValue::createBinary(QByteArray("", 0));
+                return toQValue::createBinary(QByteArray(&column.bytes[column.offsets[physical]], len));
+            }
+        case Variant:
+            {
+                toQValue const &v = column.variants[physical];
+                if (v.isComplexType())
+                    return toQValue(v.editData());
+                return v;
+            }
+    }
+    return toQValue();
+}
+
+bool toResultColumnStore::isNull(int row, int col) const
+{
+    if (col == 0)
+        return false;
+    return nullAt(Columns[col], Order[row]);
+}
+
+bool toResultColumnStore::isComplexType(int row, int col) const
+{
+    const toQValue *v = variantValue(row, col);
+    return v && v->isComplexType();
+}
+
+toQValue toResultColumnStore::value(int row, int col) const
+{
+    if (col == 0)
+        return toQValue(rowDesc(row));
+    return load(Columns[col], Order[row]);
+}
+
+const toQValue* toResultColumnStore::variantValue(int row, int col) const
+{
+    if (col == 0 || Columns[col].kind != Variant)
+        return NULL;
+    return &Columns[col].variants[Order[row]];
+}
+
+void toResultColumnStore::setValue(int row, int col, const toQValue &value)
+{
+    if (col == 0)
+        setRowDesc(row, value.getRowDesc());
+    else
+        store(Columns[col], Order[row], value);
+}
+
+toQueryAbstr::Row toResultColumnStore::row(int row) const
+{
+    toQueryAbstr::Row retval;
+    retval.reserve(columnCount());
+    for (int c = 0; c < columnCount(); c++)
+        retval.append(value(row, c));
+    return retval;
+}
+
+bool toResultColumnStore::lessThan(const Column &column,
+                                   int col,
+                                   int left,
+                                   int right,
+                                   const std::vector<double> &numeric,
+                                   const std::vector<bool> &isNumeric) const
+{
+    if (col == 0)
+        return Descs[left].key < Descs[right].key;
+
+    bool lnull = nullAt(column, left);
+    bool rnull = nullAt(column, right);
+    if (lnull || rnull)
+        return lnull && !rnull;
+
+    switch (column.kind)
+    {
+        case Empty:
+            return false;
+        case Number:
+            return lessNumber(column.numbers[left], column.numberTypes[left],
+                              column.numbers[right], column.numberTypes[right]);
+        case String:
+            {
+                // toQValue::operator< compares numeric strings as numbers
+                if (isNumeric[left] && isNumeric[right])
+                    return numeric[left] < numeric[right];
+                const QChar *l = column.chars.data() + column.offsets[left];
+                const QChar *r = column.chars.data() + column.offsets[right];
+                return std::lexicographical_compare(l, l + column.lengths[left],
+                                                    r, r + column.lengths[right],
+                                                    [](QChar a, QChar b) { return a.unicode() < b.unicode(); });
+            }
+        case Binary:
+            {
+                const unsigned char *l = (const unsigned char *) column.bytes.data() + column.offsets[left];
+                const unsigned char *r = (const unsigned char *) column.bytes.data() + column.offsets[right];
+                return std::lexicographical_compare(l, l + column.lengths[left],
+                                                    r, r + column.lengths[right]);
+            }
+        case Variant:
+            return column.variants[left] < column.variants[right];
+    }
+    return false;
+}
+
+void toResultColumnStore::sort(int col, Qt::SortOrder order)
+{
+    if (col < 0 || col >= columnCount())
+        return;
+
+    Column const &column = Columns[col];
+    std::vector<double> numeric;
+    std::vector<bool> isNumeric;
+    if (col > 0 && column.kind == String)
+    {
+        // parse numbers once instead of on every comparison
+        numeric.resize(Physical);
+        isNumeric.resize(Physical);
+        for (int p = 0; p < Physical; p++)
+        {
+            if (nullAt(column, p) || column.lengths[p] == 0)
+                continue;
+            bool ok;
+            numeric[p] = QString::fromRawData(&column.chars[column.offsets[p]], column.lengths[p]).toDouble(&ok);
+            isNumeric[p] = ok;
+        }
+    }
+
+    std::stable_sort(Order.begin(), Order.end(), [&](int left, int right)
+    {
+        if (order == Qt::AscendingOrder)
+            return lessThan(column, col, left, right, numeric, isNumeric);
+        return lessThan(column, col, right, left, numeric, isNumeric);
+    });
+}
@@ -0,0 +1,199 @@
+
+/* BEGIN_COMMON_COPYRIGHT_HEADER
+ *
+ * TOra - An Oracle Toolkit for DBA's and developers
+ *
+ * Shared/mixed copyright is held throughout files in this product
+ *
+ * Portions Copyright (C) 2000-2001 Underscore AB
+ * Portions Copyright (C) 2003-2005 Quest Software, Inc.
+ * Portions Copyright (C) 2004-2013 Numerous Other Contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation;  only version 2 of
+ * the License is valid for this program.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program as the file COPYING.txt; if not, please see
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.txt.
+ *
+ *      As a special exception, you have permission to link this program
+ *      with the Oracle Client libraries and distribute executables, as long
+ *      as you follow the requirements of the GNU GPL in regard to all of the
+ *      software in the executable aside from Oracle client libraries.
+ *
+ * All trademarks belong to their respective owners.
+ *
+ * END_COMMON_COPYRIGHT_HEADER */
+
+#ifndef TORESULTCOLUMNSTORE_H
+#define TORESULTCOLUMNSTORE_H
+
+#include "core/toqvalue.h"
+#include "core/toquery.h"
+
+#include <QtCore/QtGlobal>
+
+#include <vector>
+#include <deque>
+
+/**
+ * Columnar storage for result sets held by @ref toResultModel.
+ *
+ * Instead of keeping every cell as a QVariant inside a QList of QLists
+ * each column keeps its values in typed vectors: numbers as raw 64bit
+ * payloads, strings and binaries in per-column arenas, NULLs in a bitmap.
+ * Column 0 is special, it holds the @ref toRowDesc of each row.
+ *
+ * A column starts as Empty and gets its kind from the first non-null value
+ * stored in it. A value which does not fit the kind (for example a date or
+ * a LOB locator in a string column) turns the whole column into a Variant
+ * column, which keeps plain toQValue(s) like the old row lists did.
+ *
+ * Rows are addressed logically, the physical position of a row is looked
+ * up in an order vector. So sort(), insertRow() and removeRow() only move
+ * integers and never touch the column data.
+ *
+ * Physical rows freed by removeRow() are reused by the next inserted rows.
+ * Arena space left behind by removed rows and replaced values is reclaimed
+ * by compacting the arena once it is mostly garbage.
+ */
+class toResultColumnStore
+{
+    public:
+        enum ColumnKind
+        {
+            Empty,
+            Number,
+            String,
+            Binary,
+            Variant
+        };
+
+        toResultColumnStore();
+        ~toResultColumnStore();
+
+        /** Drop all the rows and columns, release the arenas.
+         */
+        void clear(void);
+
+        /** Set the number of columns (including the row descriptor column 0).
+         * Existing rows are padded with NULLs.
+         */
+        void setColumnCount(int cols);
+
+        int columnCount(void) const
+        {
+            return (int)Columns.size();
+        }
+
+        int rowCount(void) const
+        {
+            return (int)Order.size();
+        }
+
+        ColumnKind columnKind(int col) const
+        {
+            return Columns[col].kind;
+        }
+
+        /** Append a row at the end. row[0] must hold a toRowDesc.
+         *  Complex values are moved into the store (see toQValue copy semantics).
+         */
+        void appendRow(const toQueryAbstr::Row &row);
+
+        /** Insert a row before logical position pos.
+         */
+        void insertRow(int pos, const toQueryAbstr::Row &row);
+
+        /** Remove row from the logical order. Its physical row is reused
+         *  by the next appended or inserted row.
+         */
+        void removeRow(int row);
+
+        toRowDesc rowDesc(int row) const
+        {
+            return Descs[Order[row]];
+        }
+
+        void setRowDesc(int row, toRowDesc desc)
+        {
+            Descs[Order[row]] = desc;
+        }
+
+        bool isNull(int row, int col) const;
+
+        /** True if the cell holds a toQValue::complexType (LOBs, XML, cursors...)
+         */
+        bool isComplexType(int row, int col) const;
+
+        /** Get a copy of the cell.
+         *  Complex values have a single owner, those are returned as their editData().
+         *  Use variantValue() to access the complex value itself.
+         */
+        toQValue value(int row, int col) const;
+
+        /** Reference to the cell stored in a Variant column, NULL for typed columns.
+         */
+        const toQValue* variantValue(int row, int col) const;
+
+        /** Replace value of a cell.
+         */
+        void setValue(int row, int col, const toQValue &value);
+
+        /** Materialize a whole row, column 0 holds the toRowDesc.
+         */
+        toQueryAbstr::Row row(int row) const;
+
+        /** Sort rows by column. Stable, NULLs are sorted first
+         */
+        void sort(int col, Qt::SortOrder order);
+
+    private:
+        struct Column
+        {
+            Column();
+
+            ColumnKind kind;
+            std::vector<quint32> nulls;         // bitmap, bit set means NULL
+            std::vector<quint64> numbers;       // raw qlonglong/qulonglong/double bits
+            std::vector<quint8> numberTypes;    // QVariant::Type of a number
+            std::vector<quint64> offsets;       // offset into chars/bytes arena
+            std::vector<quint32> lengths;       // length in the arena
+            std::vector<QChar> chars;           // string arena
+            std::vector<char> bytes;            // binary arena
+            std::deque<toQValue> variants;
+            quint64 garbage;                    // unused chars/bytes in the arena
+        };
+
+        static ColumnKind kindOf(const toQValue &value);
+
+        bool nullAt(const Column &column, int physical) const
+        {
+            return (column.nulls[physical >> 5] >> (physical & 31)) & 1;
+        }
+        void setNullAt(Column &column, int physical, bool null);
+
+        int appendPhysical(const toQueryAbstr::Row &row);
+        void store(Column &column, int physical, const toQValue &value);
+        toQValue load(const Column &column, int physical) const;
+        void convert(Column &column, ColumnKind kind);
+        void release(Column &column, int physical);
+        void compact(Column &column);
+
+        bool lessThan(const Column &column, int col, int left, int right, const std::vector<double> &numeric, const std::vector<bool> &isNumeric) const;
+
+        std::vector<Column> Columns;
+        std::vector<toRowDesc> Descs;   // physical row -> row descriptor
+        std::vector<int> Order;         // logical row -> physical row
+        std::vector<int> Free;          // physical rows of removed rows
+        int Physical;                   // number of physical rows
+};
+
+#endif
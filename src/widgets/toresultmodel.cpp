@@ -38,6 +38,7 @@
 #include "core/toconfiguration.h"
 #include "core/toqvalue.h"
 #include "core/toeventquery.h"
+#include "core/toquerytrace.h"
 #include "core/toconnectiontraits.h"
 #include "core/todatabaseconfig.h"
 
@@ -117,6 +118,7 @@ toResultModel::toResultModel(const QString &owner,
     d.datatype = "CHAR";
     Headers.append(d);
     HeadersRead = true;
+    Rows.setColumnCount(Headers.size());
 
     // Fetch list of objects from the cache
     QList<toCache::CacheEntry const*> tmp = toConnection::currentConnection(this).getCache().getEntriesInSchema(owner, type);
@@ -139,7 +141,7 @@ toResultModel::toResultModel(const QString &owner,
         ///    row.append((*ii).toString());
         ///}
         row.append((*i)->name.second);
-        Rows.append(row);
+        Rows.appendRow(row);
         row.clear();
     }
     endInsertRows();
@@ -200,6 +202,7 @@ void toResultModel::slotReadData()
         return;
     }
 
+    toQueryTrace::Scope span(Query->trace(), toQueryTrace::MODEL);
     try
     {
         // must check for errors
@@ -213,7 +216,7 @@ void toResultModel::slotReadData()
         // beginInsertRows(). but to do that, we have to know how many
         // records we're going to add.
         toQueryAbstr::RowList tmp;
-        int     current = Rows.size();
+        int     current = Rows.rowCount();
 
         while (Query->hasMore() &&
                 (MaxRows < 0 || MaxRows > current))
@@ -237,8 +240,9 @@ void toResultModel::slotReadData()
         // if we read some data, then go ahead and insert them now.
         if (tmp.size() > 0)
         {
-            beginInsertRows(QModelIndex(), Rows.size(), current - 1);
-            Rows << tmp;
+            beginInsertRows(QModelIndex(), Rows.rowCount(), current - 1);
+            for (toQueryAbstr::RowList::const_iterator i = tmp.constBegin(); i != tmp.constEnd(); i++)
+                Rows.appendRow(*i);
             endInsertRows();
         }
 
@@ -491,7 +495,7 @@ int toResultModel::rowCount(const QModelIndex &parent) const
     if (parent.isValid())
         return 0;
 
-    return Rows.size();
+    return Rows.rowCount();
 }
 
 
@@ -504,15 +508,18 @@ QVariant toResultModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
-    if (index.row() > Rows.size() - 1 || index.column() > Headers.size() - 1)
+    if (index.row() > Rows.rowCount() - 1 || index.column() > Headers.size() - 1)
         return QVariant();
 
-    toQueryAbstr::Row const& row = Rows.at(index.row());
-    if (index.column() >= row.size())
+    if (index.column() >= Rows.columnCount())
         return QVariant();
-    toQValue const &data = row.at(index.column());
 
-    toRowDesc rowDesc = row[0].getRowDesc();
+    // complex types (LOBs, ...) are owned by the store, use them in place
+    toQValue const *complex = Rows.variantValue(index.row(), index.column());
+    toQValue const cell = complex ? toQValue() : Rows.value(index.row(), index.column());
+    toQValue const &data = complex ? *complex : cell;
+
+    toRowDesc rowDesc = Rows.rowDesc(index.row());
     QFont fontRet;
 
 	try
@@ -624,9 +631,9 @@ QVariant toResultModel::headerData(int section, Qt::Orientation orientation, int
             return section + 1;
         else if (role == Qt::ForegroundRole)
         {
-            if (section < 0 || section > Rows.size())
+            if (section < 0 || section >= Rows.rowCount())
                 return QVariant();
-            toRowDesc rowDesc = Rows[section][0].getRowDesc();
+            toRowDesc rowDesc = Rows.rowDesc(section);
             switch (rowDesc.status)
             {
                 case REMOVED:
@@ -703,6 +710,7 @@ void toResultModel::slotReadHeaders(toEventQuery*)
     }
 
     HeadersRead = true;
+    Rows.setColumnCount(Headers.size());
 }
 
 
@@ -738,7 +746,7 @@ void toResultModel::slotFetchMore(toEventQuery*)
         MaxRows = -1;
         slotReadData();
     }
-    else if (Rows.size() < MaxRows)
+    else if (Rows.rowCount() < MaxRows)
     {
         QModelIndex ind;
         fetchMore(ind);
@@ -761,7 +769,7 @@ void toResultModel::fetchMore(const QModelIndex &parent)
 
     // sometimes the view calls this before the query has even
     // run. don't actually increase max until we've hit it.
-    if (MaxRows < 0 || MaxRows <= Rows.size())
+    if (MaxRows < 0 || MaxRows <= Rows.rowCount())
         MaxRows += MaxRowsToAdd;
 
     slotReadData();
@@ -776,17 +784,15 @@ Qt::ItemFlags toResultModel::flags(const QModelIndex &index) const
     if (index.column() == 0)
         return fl;              // row number column
 
-    if (!index.isValid() || index.row() >= Rows.size())
+    if (!index.isValid() || index.row() >= Rows.rowCount())
     {
         return defaultFlags;
     }
 
-    toQueryAbstr::Row const& row = Rows.at(index.row());
-    if (index.column() >= row.size())
+    if (index.column() >= Rows.columnCount())
         return defaultFlags;
 
-    toQValue const &data = row.at(index.column());
-    if (data.isComplexType())
+    if (Rows.isComplexType(index.row(), index.column()))
     {
         return ( defaultFlags | fl ) & ~Qt::ItemIsEditable;
     }
@@ -794,7 +800,7 @@ Qt::ItemFlags toResultModel::flags(const QModelIndex &index) const
     fl |= defaultFlags;
 
     //Check the status of current record
-    toRowDesc rowDesc = row.at(0).getRowDesc();
+    toRowDesc rowDesc = Rows.rowDesc(index.row());
     if (rowDesc.status == REMOVED)
         fl &= ~Qt::ItemIsEditable;
     return fl;
@@ -817,7 +823,7 @@ void toResultModel::sort(int column, Qt::SortOrder order)
             SortedOrder == order)
         return;
 
-    Rows = mergesort(Rows, column, order);
+    Rows.sort(column, order);
     SortedOnColumn = column;
     SortedOrder = order;
     emit dataChanged(createIndex(0, 0),
@@ -825,52 +831,7 @@ void toResultModel::sort(int column, Qt::SortOrder order)
 }
 
 
-toQueryAbstr::RowList toResultModel::mergesort(toQueryAbstr::RowList &rows,
-        int column,
-        Qt::SortOrder order)
-{
-    if (rows.size() <= 1)
-        return rows;
-
-    toQueryAbstr::RowList left, right;
-
-    int middle = (int) (rows.size() / 2);
-    left = rows.mid(0, middle);
-    right = rows.mid(middle);
-
-    left = mergesort(left, column, order);
-    right = mergesort(right, column, order);
-
-    return merge(left, right, column, order);
-}
-
-
-toQueryAbstr::RowList toResultModel::merge(toQueryAbstr::RowList &left,
-                                      toQueryAbstr::RowList &right,
-                                      int column,
-                                      Qt::SortOrder order)
-{
-    toQueryAbstr::RowList result;
-
-    while (left.size() > 0 && right.size() > 0)
-    {
-        // 0th column contains row description (including row number)
-        toQValue lkey = column == 0 ? left.at(0).at(0).getRowDesc().key : left.at(0).at(column);
-        toQValue rkey = column == 0 ? right.at(0).at(0).getRowDesc().key : right.at(0).at(column);
-        if ((order == Qt::AscendingOrder && lkey <= rkey) || (order == Qt::DescendingOrder && lkey >= rkey))
-            result.append(left.takeAt(0));
-        else
-            result.append(right.takeAt(0));
-    }
-
-    if (left.size() > 0)
-        result << left;
-    if (right.size() > 0)
-        result << right;
-    return result;
-}
-
-toQueryAbstr::RowList& toResultModel::getRawData(void)
+toResultColumnStore const& toResultModel::getRawData(void) const
 {
     return Rows;
 }
@@ -39,6 +39,7 @@
 #include "core/toresult.h"
 #include "core/toconnection.h"
 #include "core/toqvalue.h"
+#include "widgets/toresultcolumnstore.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QAbstractTableModel>
@@ -235,7 +236,7 @@ class toResultModel : public QAbstractTableModel
         /** Get raw data of the data model. This is currently used to
          * prepare and send data to cache.
          */
-        toQueryAbstr::RowList &getRawData(void);
+        toResultColumnStore const& getRawData(void) const;
 
         void setInitialRows(int);
     signals:
@@ -292,13 +293,10 @@ class toResultModel : public QAbstractTableModel
     protected:
         void cleanup(void);
 
-        // helpers for sort implementation
-        toQueryAbstr::RowList mergesort(toQueryAbstr::RowList&, int, Qt::SortOrder);
-        toQueryAbstr::RowList merge(toQueryAbstr::RowList&, toQueryAbstr::RowList&, int, Qt::SortOrder);
-
         toEventQuery *Query;
 
-        toQueryAbstr::RowList Rows;
+        // typed columnar storage of fetched rows, column 0 holds toRowDesc
+        toResultColumnStore Rows;
         HeaderList Headers;
 
         // Following two variables hold information on how was data last sorted by sort() function.
@@ -65,8 +65,8 @@ int toResultModelEdit::addRow(QModelIndex ind, bool duplicate)
         newRowPos = ind.row() + 1; // new row is inserted right after the current one
     else
     {
-        if (!duplicate || Rows.size() > 0)
-            newRowPos = Rows.size() + 1; // new row is appended at the end
+        if (!duplicate || Rows.rowCount() > 0)
+            newRowPos = Rows.rowCount(); // new row is appended at the end
         else
             return -1; // unable to duplicate a record if there are no records
     }
@@ -80,7 +80,7 @@ int toResultModelEdit::addRow(QModelIndex ind, bool duplicate)
     if (duplicate)
     {
         // Create a duplicate of current row
-        row = Rows[ind.row()];
+        row = Rows.row(ind.row());
         // Reset a 0'th column
         row[0] = rowDesc;
     }
@@ -95,7 +95,7 @@ int toResultModelEdit::addRow(QModelIndex ind, bool duplicate)
             row.append(toQValue());
     }
 
-    Rows.insert(newRowPos, row);
+    Rows.insertRow(newRowPos, row);
     endInsertRows();
     recordAdd(row);
     return newRowPos;
@@ -104,11 +104,11 @@ int toResultModelEdit::addRow(QModelIndex ind, bool duplicate)
 
 void toResultModelEdit::deleteRow(QModelIndex index)
 {
-    if (!index.isValid() || index.row() >= Rows.size())
+    if (!index.isValid() || index.row() >= Rows.rowCount())
         return;
 
-    toQueryAbstr::Row deleted = Rows[index.row()];
-    toRowDesc rowDesc = deleted[0].getRowDesc();
+    toQueryAbstr::Row deleted = Rows.row(index.row());
+    toRowDesc rowDesc = Rows.rowDesc(index.row());
 
     if (rowDesc.status == REMOVED)
     {
@@ -119,13 +119,13 @@ void toResultModelEdit::deleteRow(QModelIndex index)
     {
         //Newly added record can be removed regularly
         beginRemoveRows(QModelIndex(), index.row(), index.row());
-        Rows.takeAt(index.row());
+        Rows.removeRow(index.row());
         endRemoveRows();
     }
     else  //Existed and Modified
     {
         rowDesc.status = REMOVED;
-        Rows[index.row()][0] = toQValue(rowDesc);
+        Rows.setRowDesc(index.row(), rowDesc);
     }
     recordDelete(deleted);
 }
@@ -133,22 +133,20 @@ void toResultModelEdit::deleteRow(QModelIndex index)
 void toResultModelEdit::clearStatus()
 {
     // Go through all records and set their status to be existed
-    for (toQueryAbstr::RowList::iterator ite = Rows.begin(); ite != Rows.end(); ite++)
+    for (int i = Rows.rowCount() - 1; i >= 0; i--)
     {
-        toRowDesc rowDesc = ite->at(0).getRowDesc();
+        toRowDesc rowDesc = Rows.rowDesc(i);
         if (rowDesc.status == REMOVED)
         {
-            ite = Rows.erase(ite);
-            if (ite == Rows.end())
-                break;
+            Rows.removeRow(i);
         }
         else if (rowDesc.status != EXISTED)
         {
             rowDesc.status = EXISTED;
-            (*ite)[0] = toQValue(rowDesc);
+            Rows.setRowDesc(i, rowDesc);
         }
     }
-    emit headerDataChanged(Qt::Vertical, 0, Rows.size() - 1);
+    emit headerDataChanged(Qt::Vertical, 0, Rows.rowCount() - 1);
 }
 
 bool toResultModelEdit::changed(void)
@@ -270,29 +268,31 @@ bool toResultModelEdit::setData(const QModelIndex &index,
     if (index.column() == 0)
         return false;           // can't change number column
 
-    if (index.row() >= Rows.size() || index.column() >= Headers.size())
+    if (index.row() >= Rows.rowCount() || index.column() >= Headers.size())
+        return false;
+
+    if (Rows.isComplexType(index.row(), index.column()))
         return false;
 
-    toQueryAbstr::Row &row = Rows[index.row()];
     toQValue newValue = toQValue::fromVariant(_value);
-    toRowDesc rowDesc = Rows.at(index.row())[0].getRowDesc();
-    if (rowDesc.status == EXISTED && !(row[index.column()] == newValue))
+    toRowDesc rowDesc = Rows.rowDesc(index.row());
+    if (rowDesc.status == EXISTED && !(Rows.value(index.row(), index.column()) == newValue))
     {
         // leave row that's added as in status added
         rowDesc.status = MODIFIED;
-        Rows[index.row()][0] = toQValue(rowDesc);
+        Rows.setRowDesc(index.row(), rowDesc);
     }
 
     {
         // If no prikey is used, data is recorded in change list
-        toQueryAbstr::Row oldRow = row;           // keep old version
-        row[index.column()] = newValue;
+        toQueryAbstr::Row oldRow = Rows.row(index.row()); // keep old version
         // for writing to the database
         recordChange(index, newValue, oldRow);
 
-        if (!row[index.column()].updateNewValue(newValue))
+        if (newValue.isComplexType())
             return false;
-        qDebug() << "Value is changed from " << (QString)row[index.column()] << " to " << (QString)newValue << "At " << index;
+        Rows.setValue(index.row(), index.column(), newValue);
+        qDebug() << "Value is changed from " << (QString)oldRow[index.column()] << " to " << (QString)newValue << "At " << index;
     }
 
     // for the view
@@ -309,17 +309,15 @@ Qt::ItemFlags toResultModelEdit::flags(const QModelIndex &index) const
     if (index.column() == 0)
         return fl;              // row number column
 
-    if (!index.isValid() || index.row() >= Rows.size())
+    if (!index.isValid() || index.row() >= Rows.rowCount())
     {
         return Qt::ItemIsDropEnabled | defaultFlags;
     }
 
-    toQueryAbstr::Row const& row = Rows.at(index.row());
-    if (index.column() >= row.size())
+    if (index.column() >= Rows.columnCount())
         return defaultFlags;
 
-    toQValue const &data = row.at(index.column());
-    if (data.isComplexType())
+    if (Rows.isComplexType(index.row(), index.column()))
     {
         return ( defaultFlags | fl ) & ~Qt::ItemIsEditable;
     }
@@ -327,7 +325,7 @@ Qt::ItemFlags toResultModelEdit::flags(const QModelIndex &index) const
     fl |= defaultFlags | Qt::ItemIsEditable | Qt::ItemIsDropEnabled;
 
     //Check the status of current record
-    toRowDesc rowDesc = row.at(0).getRowDesc();
+    toRowDesc rowDesc = Rows.rowDesc(index.row());
     if (rowDesc.status == REMOVED)
         fl &= ~Qt::ItemIsEditable;
     return fl;